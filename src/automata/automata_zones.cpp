@@ -1,12 +1,24 @@
 #include "automata/automata_zones.h"
 #include "automata/automata_zones.hpp"
 
+#include "utilities/hash.h"
+
+#include <mutex>
+
 namespace tacos::zones {
 
 	Zone_slice
 	Zone_DBM::get_zone_slice(std::string clock) const
 	{
-		assert(graph_.has_clock(clock));
+		assert(has_clock(clock));
+
+		return get_zone_slice(get_clock_id(clock));
+	}
+
+	Zone_slice
+	Zone_DBM::get_zone_slice(ClockID clock) const
+	{
+		assert(has_clock(clock));
 
 		if(!is_consistent()) {
 			return Zone_slice{0, 0, true, true, max_constant_};
@@ -14,10 +26,12 @@ namespace tacos::zones {
 
 		Zone_slice ret{0, 0, false, false, max_constant_};
 
-		std::size_t index = graph_.get_index_of_clock(clock);
+		Graph buffer;
+		const Graph &graph = read_graph(buffer);
+		std::size_t index = graph.get_index_of_clock(clock);
 
-		const DBM_Entry &lower_bound = graph_.get_value(0, index);
-		const DBM_Entry &upper_bound = graph_.get_value(index, 0);
+		const DBM_Entry lower_bound = graph.get_value(0, index);
+		const DBM_Entry upper_bound = graph.get_value(index, 0);
 
 		if(lower_bound.value_ < 0) {
 			ret.lower_bound_ = (Endpoint) -lower_bound.value_;
@@ -35,9 +49,10 @@ namespace tacos::zones {
 			ret.lower_isOpen_ = false;
 		}
 
+		//The closure may imply a lower bound beyond the max constant, which is the same as exceeding the max constant
 		if(ret.lower_bound_ > max_constant_) {
 			ret.lower_bound_ = max_constant_;
-			ret.lower_isOpen_ = false;
+			ret.lower_isOpen_ = true;
 		}
 
 		if(upper_bound.infinity_ || ret.upper_bound_ > max_constant_) {
@@ -53,35 +68,195 @@ namespace tacos::zones {
 	void
 	Zone_DBM::delay()
 	{
-		for(std::size_t i = 1; i < graph_.size(); i++) {
-			graph_.get(i, 0).infinity_ = true;
+		//A DBM without upper bounds is already delayed, so a shared matrix isn't copied
+		if(is_consistent() && !is_compressed()) {
+			const Graph &shared = graph();
+			bool bounded = false;
+			for(std::size_t i = 1; i < shared.size() && !bounded; i++) {
+				bounded = shared.get_bound(i, 0) != DBM_BOUND_INFINITY;
+			}
+			if(!bounded) {
+				return;
+			}
+		}
+
+		Graph &graph = mutable_graph();
+
+		for(std::size_t i = 1; i < graph.size(); i++) {
+			graph.get(i, 0) = DBM_BOUND_INFINITY;
 		}
 	}
 
 	void
 	Zone_DBM::reset(std::string clock)
 	{
-		//assert((graph_.get(0,0) == DBM_Entry{0, true}));
+		reset(get_clock_id(clock));
+	}
+
+	void
+	Zone_DBM::reset(ClockID clock)
+	{
+		//assert((graph().get(0,0) == DBM_Entry{0, true}));
 
-		std::size_t index = graph_.get_index_of_clock(clock);
+		Graph &graph = mutable_graph();
+		std::size_t index = graph.get_index_of_clock(clock);
 
-		for(std::size_t i = 0; i < graph_.size(); i++) {
-			graph_.get(index, i) = DBM_Entry{0, true} + graph_.get(0, i);
-			graph_.get(i, index) = graph_.get(i, 0) + DBM_Entry{0, true};
+		//Only the row and column of the clock change, and they are copied from the (already normalized) zero clock,
+		//so neither closure nor normalization is needed
+		for(std::size_t i = 0; i < graph.size(); i++) {
+			graph.get(index, i) = add_bounds(DBM_BOUND_LE_ZERO, graph.get(0, i));
+			graph.get(i, index) = add_bounds(graph.get(i, 0), DBM_BOUND_LE_ZERO);
 		}
+		graph.get(index, index) = DBM_BOUND_LE_ZERO;
+	}
 
-		normalize();
+	void
+	Zone_DBM::free_clock(std::string clock)
+	{
+		free_clock(get_clock_id(clock));
+	}
+
+	void
+	Zone_DBM::free_clock(ClockID clock)
+	{
+		decompress();
+		if(!is_consistent()) {
+			return;
+		}
+
+		std::size_t index = graph().get_index_of_clock(clock);
+
+		//The clock is only bounded by the other clocks' bounds to the zero clock, check this first so a shared matrix
+		//isn't copied
+		auto is_free = [index](const Graph &graph) {
+			for(std::size_t i = 0; i < graph.size(); i++) {
+				if(i == index) {
+					continue;
+				}
+				const DBM_Bound lower = i == 0 ? DBM_BOUND_LE_ZERO : graph.get_bound(i, 0);
+				if(graph.get_bound(index, i) != DBM_BOUND_INFINITY || graph.get_bound(i, index) != lower) {
+					return false;
+				}
+			}
+			return true;
+		};
+		if(is_free(graph())) {
+			return;
+		}
+
+		Graph &graph = mutable_graph();
+		for(std::size_t i = 0; i < graph.size(); i++) {
+			graph.get(index, i) = DBM_BOUND_INFINITY;
+			graph.get(i, index) = graph.get(i, 0);
+		}
+		graph.get(0, index) = DBM_BOUND_LE_ZERO;
+		graph.get(index, index) = DBM_BOUND_LE_ZERO;
 	}
 
 	void
 	Zone_DBM::conjunct(std::string clock, automata::ClockConstraint clock_constraint)
 	{
-		assert(graph_.has_clock(clock));
+		assert(has_clock(clock));
+
+		conjunct(get_clock_id(clock), clock_constraint);
+	}
+
+	void
+	Zone_DBM::conjunct(ClockID clock, automata::ClockConstraint clock_constraint)
+	{
+		decompress();
+		assert(graph().has_clock(clock));
+
+		std::size_t index = graph().get_index_of_clock(clock);
+
+		auto [upper_entry, lower_entry] = get_bounds(clock_constraint);
+
+		const bool was_normalized = normalized_;
+
+		//Apply the algorithm on lower_entry and also upper_entry
+		bool changed = false;
+		if(upper_entry != DBM_BOUND_INFINITY) {
+			changed |= and_func(index, 0, upper_entry);
+		}
+
+		if(lower_entry != DBM_BOUND_INFINITY) {
+			changed |= and_func(0, index, lower_entry);
+		}
+
+		//Nothing changed, so the DBM is still normalized
+		if(changed) {
+			keep_normalized(was_normalized, exceeds_max_constant(upper_entry) || exceeds_max_constant(lower_entry));
+		}
+	}
+
+	void
+	Zone_DBM::conjunct(const std::multimap<std::string, automata::ClockConstraint> &clock_constraints) {
+		if(!is_consistent()) {
+			return;
+		}
+
+		decompress();
+
+		//Constraints that are already implied don't change the DBM, so a shared matrix isn't copied
+		if(std::none_of(clock_constraints.begin(), clock_constraints.end(), [this](const auto &constraint) {
+			   const std::size_t index = get_index_of_clock(constraint.first);
+			   auto [upper_entry, lower_entry] = get_bounds(constraint.second);
+			   return upper_entry < graph().get_bound(index, 0) || lower_entry < graph().get_bound(0, index);
+		   })) {
+			return;
+		}
+
+		//Vertices whose edges were tightened, the zero clock is the other endpoint of every atomic constraint
+		std::vector<std::size_t> tightened{0};
+		bool exceeds_limits = false;
+		const bool was_normalized = normalized_;
+		Graph &graph = mutable_graph();
+
+		for(auto iter1 = clock_constraints.begin(); iter1 != clock_constraints.end(); iter1++) {
+			assert(has_clock(iter1->first));
+
+			std::size_t index = get_index_of_clock(iter1->first);
+			auto [upper_entry, lower_entry] = get_bounds(iter1->second);
+
+			bool changed = graph.tighten(index, 0, upper_entry);
+			changed |= graph.tighten(0, index, lower_entry);
+			exceeds_limits |= exceeds_max_constant(upper_entry) || exceeds_max_constant(lower_entry);
+
+			if(changed && std::find(tightened.begin(), tightened.end(), index) == tightened.end()) {
+				tightened.push_back(index);
+			}
+		}
+
+		//Nothing changed, so the DBM is still canonical and normalized
+		if(tightened.size() == 1) {
+			normalized_ = was_normalized;
+			return;
+		}
+
+		if(graph.close_over(tightened)) {
+			keep_normalized(was_normalized, exceeds_limits);
+		}
+	}
+
+	void
+	Zone_DBM::keep_normalized(bool was_normalized, bool exceeds_limits)
+	{
+		//Max-constant normalization clamps each bound on its own and the result is closed again. If the constraints
+		//aren't clamped, every bound the closure derives from them is also derived from the clamped DBM, so the
+		//normalized DBM stays normalized. LU extrapolation also depends on the lower bounds, so it has to run again.
+		if(was_normalized && !exceeds_limits && clock_bounds_ == nullptr && is_consistent()) {
+			normalized_ = true;
+			return;
+		}
 
-		std::size_t index = graph_.get_index_of_clock(clock);
+		normalize();
+	}
 
-		DBM_Entry lower_entry{true, 0, false};
-		DBM_Entry upper_entry{true, 0, false};
+	std::pair<DBM_Bound, DBM_Bound>
+	Zone_DBM::get_bounds(const automata::ClockConstraint &clock_constraint)
+	{
+		DBM_Bound lower_entry = DBM_BOUND_INFINITY;
+		DBM_Bound upper_entry = DBM_BOUND_INFINITY;
 
 		int constant = (int) std::visit([](const auto &atomic_clock_constraint)
 						-> Time { return atomic_clock_constraint.get_comparand(); },
@@ -94,390 +269,1524 @@ namespace tacos::zones {
 		switch (relation)
 		{
 		case 0: //less
-			upper_entry.infinity_ = false;
-			upper_entry.value_ = constant;
-			upper_entry.non_strict_ = false;
+			upper_entry = make_bound(constant, false);
 			break;
 		case 1: //less_equal
-			upper_entry.infinity_ = false;
-			upper_entry.value_ = constant;
-			upper_entry.non_strict_ = true;
+			upper_entry = make_bound(constant, true);
 			break;
 		case 2: //equal_to
-			upper_entry.infinity_ = false;
-			upper_entry.value_ = constant;
-			upper_entry.non_strict_ = true;
-
-			lower_entry.infinity_ = false;
-			lower_entry.value_ = -constant;
-			lower_entry.non_strict_ = true;
+			upper_entry = make_bound(constant, true);
+			lower_entry = make_bound(-constant, true);
 			break;
 		case 4: //greater_equal
-			lower_entry.infinity_ = false;
-			lower_entry.value_ = -constant;
-			lower_entry.non_strict_ = true;
+			lower_entry = make_bound(-constant, true);
 			break;
 		case 5: //greater
-			lower_entry.infinity_ = false;
-			lower_entry.value_ = -constant;
-			lower_entry.non_strict_ = false;
+			lower_entry = make_bound(-constant, false);
 			break;
 		default: //not_equal or other oopsie (We assume inequality constraints don't exist for zones)
 			assert(false);
 			break;
 		}
 
-		//Apply the algorithm on lower_entry and also upper_entry
-		if(!upper_entry.infinity_) {
-			and_func(index, 0, upper_entry);
+		return {upper_entry, lower_entry};
+	}
+
+	void
+	Zone_DBM::normalize()
+	{
+		//Clamping an unchanged normalized matrix again would only derive the same bounds again
+		if(normalized_) {
+			return;
+		}
+
+		if(clock_bounds_ != nullptr) {
+			extrapolate_lu();
+		} else {
+			const Graph &shared = graph();
+			const DBM_Bound *bounds = shared.data();
+			const bool exceeds_limits = std::any_of(bounds, bounds + shared.size() * shared.size(), [this](DBM_Bound bound) {
+				return exceeds_max_constant(bound);
+			});
+
+			if(exceeds_limits) {
+				const DBM_Bound upper_limit = make_bound((int) max_constant_, true);
+				const DBM_Bound lower_limit = make_bound(-1*((int) max_constant_), false);
+
+				//Clamping bounds breaks the canonical form, which close_over() relies on, so it has to be restored
+				//afterwards. The closure may derive bounds beyond the limits again, e.g. x > K and z - x >= 3 imply
+				//z > K + 3, but clamping those once more would only derive them again.
+				Graph &graph = mutable_graph();
+				get_dbm_kernels().normalize(graph.data(), graph.size() * graph.size(), upper_limit, lower_limit);
+				graph.floyd_warshall();
+			}
+		}
+
+		normalized_ = true;
+	}
+
+	bool
+	Zone_DBM::exceeds_max_constant(DBM_Bound bound) const
+	{
+		return bound != DBM_BOUND_INFINITY
+		       && (bound > make_bound((int) max_constant_, true) || bound < make_bound(-1*((int) max_constant_), false));
+	}
+
+	void
+	Zone_DBM::extrapolate_lu()
+	{
+		if(!is_consistent()) {
+			return;
+		}
+
+		Graph buffer;
+		const Graph &shared = read_graph(buffer);
+		const std::size_t n = shared.size();
+
+		//Packed versions of the bounds, such that for a bound b of a row or column:
+		//b > above_lower[i] iff its constant is larger than L(x_i), b < below_lower[i] iff its constant is smaller than -L(x_i)
+		Inline_Array<DBM_Bound, DBM_INLINE_DIMENSION> above_lower(n, DBM_BOUND_LE_ZERO);
+		Inline_Array<DBM_Bound, DBM_INLINE_DIMENSION> below_lower(n, DBM_BOUND_LT_ZERO);
+		Inline_Array<DBM_Bound, DBM_INLINE_DIMENSION> below_upper(n, DBM_BOUND_LT_ZERO);
+		for(std::size_t i = 1; i < n; i++) {
+			const ClockID clock = shared.get_clock_at(i);
+			const int lower = (int) clock_bounds_->get_lower_bound(clock);
+			const int upper = (int) clock_bounds_->get_upper_bound(clock);
+			above_lower[i] = make_bound(lower, true);
+			below_lower[i] = make_bound(-lower, false);
+			below_upper[i] = make_bound(-upper, false);
+		}
+
+		//The lower bounds of all clocks, before row 0 is changed
+		Inline_Array<DBM_Bound, DBM_INLINE_DIMENSION> lower_bounds(n, DBM_BOUND_INFINITY);
+		std::copy(shared.data(), shared.data() + n, lower_bounds.begin());
+
+		auto extrapolate = [&](std::size_t i, std::size_t j, DBM_Bound bound) -> DBM_Bound {
+			if(i == j || bound == DBM_BOUND_INFINITY) {
+				return bound;
+			}
+
+			if(bound > above_lower[i] || lower_bounds[i] < below_lower[i]) {
+				//x_i - x_j <= c with c > L(x_i), or x_i is already above L(x_i)
+				return DBM_BOUND_INFINITY;
+			}
+			if(lower_bounds[j] < below_upper[j]) {
+				//x_j is already above U(x_j)
+				return (i == 0) ? below_upper[j] : DBM_BOUND_INFINITY;
+			}
+
+			return bound;
+		};
+
+		//Only copy a shared matrix if the extrapolation changes some bound
+		bool changed = false;
+		for(std::size_t i = 0; i < n && !changed; i++) {
+			for(std::size_t j = 0; j < n && !changed; j++) {
+				changed = extrapolate(i, j, shared.get_bound(i, j)) != shared.get_bound(i, j);
+			}
+		}
+		if(!changed) {
+			return;
+		}
+
+		Graph &graph = mutable_graph();
+		for(std::size_t i = 0; i < n; i++) {
+			for(std::size_t j = 0; j < n; j++) {
+				DBM_Bound &bound = graph.get(i, j);
+				bound = extrapolate(i, j, bound);
+			}
+		}
+
+		graph.floyd_warshall();
+	}
+
+	bool
+	Zone_DBM::is_consistent() const
+	{
+		if(is_compressed()) {
+			return reduced().is_consistent();
+		}
+
+		return !graph().has_negative_diagonal();
+	}
+
+	//TODO This doesn't consider that old clocks may have been removed
+	RegionIndex
+	Zone_DBM::get_increment(const Zone_DBM &new_dbm) const
+	{
+		//Find the largest difference in magnitude, unless it is of a clock that has been reset.
+		RegionIndex largest_difference = 0;
+
+		Graph buffer, new_buffer;
+		const Graph &graph     = read_graph(buffer);
+		const Graph &new_graph = new_dbm.read_graph(new_buffer);
+
+		//Index in this DBM for each index of new_dbm, the zero clock is always at 0
+		std::vector<std::optional<std::size_t>> indices(new_graph.size());
+		indices[0] = 0;
+		for(std::size_t new_index = 1; new_index < new_graph.size(); new_index++) {
+			ClockID clock = new_graph.get_clock_at(new_index);
+			//IDs are only comparable within the same registry
+			if(registry_ != new_dbm.registry_) {
+				clock = get_clock_id(new_dbm.registry_->get_name(clock));
+			}
+
+			if(graph.has_clock(clock)) {
+				indices[new_index] = graph.get_index_of_clock(clock);
+			}
+		}
+
+		for(std::size_t new_index = 1; new_index < indices.size(); new_index++) {
+			if(!indices[new_index].has_value()) {
+				continue;
+			}
+			std::size_t index = indices[new_index].value();
+
+			//I am stupid and don't know how to incorporate zero clock into for loop
+			{
+				RegionIndex lower_difference = new_graph.get_value(new_index, 0) - graph.get_value(index, 0);
+				RegionIndex upper_difference = new_graph.get_value(0, new_index) - graph.get_value(0, index);
+				RegionIndex difference = std::max(lower_difference, upper_difference);
+				if(difference > largest_difference) {
+					largest_difference = difference;
+				}
+			}
+
+			for(std::size_t new_other_index = 1; new_other_index < indices.size(); new_other_index++) {
+				if(!indices[new_other_index].has_value()) {
+					continue;
+				}
+
+				std::size_t other_index = indices[new_other_index].value();
+
+				RegionIndex lower_difference = new_graph.get_value(new_index, new_other_index) - graph.get_value(index, other_index);
+				RegionIndex upper_difference = new_graph.get_value(new_other_index, new_index) - graph.get_value(other_index, index);
+				RegionIndex difference = std::max(lower_difference, upper_difference);
+				if(difference > largest_difference) {
+					largest_difference = difference;
+				}
+			}
+		}
+
+		return largest_difference;
+	}
+
+	bool
+	Zone_DBM::and_func(std::size_t x, std::size_t y, DBM_Bound comparison)
+	{
+		if(!is_consistent()) {
+			return false;
+		}
+
+		//Check whether this will make the zone inconsistent, i.e. negative cycle
+		if(add_bounds(graph().get_bound(y, x), comparison) < DBM_BOUND_LE_ZERO) {
+			mutable_graph().mark_inconsistent();
+			return true;
+		}
+
+		//A constraint that is already implied doesn't change the DBM, so a shared matrix isn't copied
+		if(comparison >= graph().get_bound(x, y)) {
+			return false;
+		}
+
+		Graph &graph = mutable_graph();
+		graph.tighten(x, y, comparison);
+		//Make canonical by getting shortest paths, only paths via the new edge can have become shorter
+		graph.close_over({x, y});
+
+		return true;
+	}
+
+	std::size_t
+	Zone_DBM::get_index_of_clock(std::string clock) const
+	{
+		std::optional<ClockID> id = registry_->find_id(clock);
+		assert(id.has_value());
+
+		if(is_compressed()) {
+			const auto &clocks = reduced().get_clocks();
+			auto it = std::find(clocks.begin(), clocks.end(), id.value());
+			assert(it != clocks.end());
+
+			return std::distance(clocks.begin(), it) + 1;
+		}
+
+		return graph().get_index_of_clock(id.value());
+	}
+
+	std::vector<ClockID>
+	Zone_DBM::get_clock_ids(const std::set<std::string> &clocks) const
+	{
+		std::vector<ClockID> ids;
+		ids.reserve(clocks.size());
+
+		for(const auto &clock : clocks) {
+			ids.push_back(get_clock_id(clock));
+		}
+
+		return ids;
+	}
+
+	std::vector<std::string>
+	Zone_DBM::get_clocks() const
+	{
+		std::vector<std::string> ret;
+		for(const auto &clock : get_clock_ids()) {
+			ret.push_back(registry_->get_name(clock));
+		}
+
+		return ret;
+	}
+
+	std::vector<ClockID>
+	Zone_DBM::get_clock_ids() const
+	{
+		if(is_compressed()) {
+			return reduced().get_clocks();
+		}
+
+		return graph().get_clocks();
+	}
+
+	bool
+	Zone_DBM::add_clock(std::string clock_name)
+	{
+		return add_clock(get_clock_id(clock_name));
+	}
+
+	bool
+	Zone_DBM::add_clock(ClockID clock)
+	{
+		return mutable_graph().add_clock(clock);
+	}
+
+	bool
+	Zone_DBM::copy_clock(std::string new_clock_name, std::string clock_to_copy)
+	{
+		return copy_clock(get_clock_id(new_clock_name), get_clock_id(clock_to_copy));
+	}
+
+	bool
+	Zone_DBM::copy_clock(ClockID new_clock, ClockID clock_to_copy)
+	{
+		//If same, then don't need to do anything
+		if(new_clock == clock_to_copy) {
+			return true;
+		}
+
+		Graph &graph = mutable_graph();
+		if(!graph.has_clock(clock_to_copy)) {
+			return false;
+		}
+
+		if(!graph.has_clock(new_clock)) {
+			add_clock(new_clock);
+		}
+
+		//Constrain new_clock - old_clock <= 0 AND old_clock - new_clock <= 0, so the clocks are the same
+		graph.copy_clock(graph.get_index_of_clock(new_clock), graph.get_index_of_clock(clock_to_copy));
+
+		return true;
+	}
+
+	bool
+	Zone_DBM::remove_clock(std::string clock_name)
+	{
+		return remove_clock(get_clock_id(clock_name));
+	}
+
+	bool
+	Zone_DBM::remove_clock(ClockID clock)
+	{
+		return mutable_graph().remove_clock(clock);
+	}
+
+	bool
+	Zone_DBM::has_clock(std::string clock_name) const
+	{
+		std::optional<ClockID> id = registry_->find_id(clock_name);
+
+		return id.has_value() && has_clock(id.value());
+	}
+
+	bool
+	Zone_DBM::has_clock(ClockID clock) const
+	{
+		if(is_compressed()) {
+			const auto &clocks = reduced().get_clocks();
+			return std::find(clocks.begin(), clocks.end(), clock) != clocks.end();
+		}
+
+		return graph().has_clock(clock);
+	}
+
+	bool
+	Zone_DBM::is_included_in(const Zone_DBM &other) const
+	{
+		if(!is_consistent()) {
+			return true;
+		}
+
+		if(!other.is_consistent() || size() != other.size()) {
+			return false;
+		}
+
+		Graph buffer, other_buffer;
+		const Graph &graph       = read_graph(buffer);
+		const Graph &other_graph = other.read_graph(other_buffer);
+
+		const std::size_t n = graph.size();
+
+		if(registry_ == other.registry_ && graph.has_same_clocks(other_graph)) {
+			return get_dbm_kernels().is_less_equal(graph.data(), other_graph.data(), n * n);
+		}
+
+		//Clocks were added in a different order (or with another registry), so match the indices first
+		std::vector<std::size_t> other_index(n, 0);
+		for(std::size_t i = 1; i < n; i++) {
+			ClockID clock = graph.get_clock_at(i);
+			if(registry_ != other.registry_) {
+				std::optional<ClockID> other_clock = other.registry_->find_id(registry_->get_name(clock));
+				if(!other_clock.has_value()) {
+					return false;
+				}
+				clock = other_clock.value();
+			}
+
+			if(!other_graph.has_clock(clock)) {
+				return false;
+			}
+			other_index[i] = other_graph.get_index_of_clock(clock);
+		}
+
+		for(std::size_t i = 0; i < n; i++) {
+			for(std::size_t j = 0; j < n; j++) {
+				if(graph.get_bound(i, j) > other_graph.get_bound(other_index[i], other_index[j])) {
+					return false;
+				}
+			}
+		}
+
+		return true;
+	}
+
+	bool
+	Zone_DBM::is_projection_included_in(const Zone_DBM &other) const
+	{
+		if(!is_consistent()) {
+			return true;
+		}
+
+		if(!other.is_consistent() || size() < other.size()) {
+			return false;
+		}
+
+		Graph buffer, other_buffer;
+		const Graph &graph       = read_graph(buffer);
+		const Graph &other_graph = other.read_graph(other_buffer);
+
+		const std::size_t n = other_graph.size();
+
+		//Index in this graph of each clock of the other graph, kept inline for small zones
+		Inline_Array<std::size_t, DBM_INLINE_DIMENSION> index;
+		index.push_back(0);
+		for(std::size_t i = 1; i < n; i++) {
+			ClockID clock = other_graph.get_clock_at(i);
+			if(registry_ != other.registry_) {
+				std::optional<ClockID> own_clock = registry_->find_id(other.registry_->get_name(clock));
+				if(!own_clock.has_value()) {
+					return false;
+				}
+				clock = own_clock.value();
+			}
+
+			if(!graph.has_clock(clock)) {
+				return false;
+			}
+			index.push_back(graph.get_index_of_clock(clock));
+		}
+
+		for(std::size_t i = 0; i < n; i++) {
+			for(std::size_t j = 0; j < n; j++) {
+				if(graph.get_bound(index[i], index[j]) > other_graph.get_bound(i, j)) {
+					return false;
+				}
+			}
+		}
+
+		return true;
+	}
+
+	std::size_t
+	Zone_DBM::hash() const
+	{
+		if(storage_ == nullptr) {
+			return graph().hash(*registry_);
+		}
+
+		std::size_t hash = storage_->hash.load(std::memory_order_relaxed);
+		if(hash == 0) {
+			//Computing it twice in different threads is harmless, both get the same value
+			hash = std::max<std::size_t>(graph().hash(*registry_), 1);
+			storage_->hash.store(hash, std::memory_order_relaxed);
+		}
+
+		return hash;
+	}
+
+	bool
+	Zone_DBM::has_same_clocks(const Graph &graph, const Zone_DBM &other, const Graph &other_graph) const
+	{
+		if(registry_ == other.registry_) {
+			return graph.has_same_clocks(other_graph);
+		}
+
+		if(graph.size() != other_graph.size()) {
+			return false;
+		}
+
+		for(std::size_t i = 1; i < graph.size(); i++) {
+			if(registry_->get_name(graph.get_clock_at(i)) != other.registry_->get_name(other_graph.get_clock_at(i))) {
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	bool
+	Zone_DBM::has_smaller_clocks(const Graph &graph, const Zone_DBM &other, const Graph &other_graph) const
+	{
+		const std::size_t size = std::min(graph.size(), other_graph.size());
+		for(std::size_t i = 1; i < size; i++) {
+			const ClockID clock       = graph.get_clock_at(i);
+			const ClockID other_clock = other_graph.get_clock_at(i);
+			if(registry_ == other.registry_ && clock == other_clock) {
+				continue;
+			}
+
+			const std::string &name       = registry_->get_name(clock);
+			const std::string &other_name = other.registry_->get_name(other_clock);
+			if(name != other_name) {
+				return name < other_name;
+			}
+		}
+
+		return graph.size() < other_graph.size();
+	}
+
+	Graph &
+	Zone_DBM::mutable_graph()
+	{
+		if(storage_ == nullptr) {
+			storage_ = std::make_shared<Graph_Storage>(Graph{});
+		} else if(is_compressed()) {
+			storage_ = std::make_shared<Graph_Storage>(reduced().get_graph());
+		} else if(!owns_storage()) {
+			storage_ = std::make_shared<Graph_Storage>(static_cast<const Graph_Storage &>(*storage_));
+		}
+
+		storage_->hash.store(0, std::memory_order_relaxed);
+		normalized_ = false;
+
+		return static_cast<Graph_Storage &>(*storage_).graph;
+	}
+
+	bool
+	Zone_DBM::owns_storage() const
+	{
+		if(storage_ == nullptr || storage_->pool_id != 0 || is_compressed() || storage_.use_count() != 1) {
+			return false;
+		}
+
+		//use_count() is a relaxed load, this orders our changes after the reads of former owners in other threads
+		std::atomic_thread_fence(std::memory_order_acquire);
+
+		return true;
+	}
+
+	Reduced_DBM
+	Zone_DBM::get_minimal_constraints() const
+	{
+		if(is_compressed()) {
+			return reduced();
+		}
+
+		return Reduced_DBM{graph()};
+	}
+
+	void
+	Zone_DBM::compress()
+	{
+		if(storage_ == nullptr || is_compressed() || !is_consistent()) {
+			return;
+		}
+
+		storage_ = std::make_shared<Reduced_Storage>(Reduced_DBM{graph()}, hash());
+	}
+
+	void
+	Zone_DBM::decompress()
+	{
+		if(!is_compressed()) {
+			return;
+		}
+
+		const std::size_t hash = storage_->hash.load(std::memory_order_relaxed);
+		storage_ = std::make_shared<Graph_Storage>(reduced().get_graph());
+		storage_->hash.store(hash, std::memory_order_relaxed);
+	}
+
+	Zone_DBM
+	Zone_DBM::get_subset(std::set<std::string> clocks) const
+	{
+		return get_subset_of_ids(get_clock_ids(clocks));
+	}
+
+	Zone_DBM
+	Zone_DBM::get_subset_of_ids(const std::vector<ClockID> &clocks) const
+	{
+		Graph new_graph{clocks};
+
+		Graph buffer;
+		const Graph &graph = read_graph(buffer);
+
+		std::vector<std::size_t> indices;
+		indices.reserve(clocks.size() + 1);
+		indices.push_back(0);
+		for(const auto &clock : clocks) {
+			indices.push_back(graph.get_index_of_clock(clock));
+		}
+
+		//Copy the bounds between all kept clocks, including the zero clock
+		for(std::size_t i = 0; i < indices.size(); i++) {
+			for(std::size_t j = 0; j < indices.size(); j++) {
+				if(i == 0 && j == 0) {
+					continue;
+				}
+
+				new_graph.get(i, j) = graph.get_bound(indices[i], indices[j]);
+			}
+		}
+
+		//A subgraph of a canonical graph is canonical, so only inconsistency needs to be carried over
+		if(!is_consistent()) {
+			new_graph.mark_inconsistent();
+		}
+
+		Zone_DBM new_dbm{new_graph, registry_, clock_bounds_, max_constant_};
+		return new_dbm;
+	}
+
+	DBM_Entry
+	Zone_DBM::at(std::size_t x, std::size_t y) const
+	{
+		Graph buffer;
+		return read_graph(buffer).get_value(x, y);
+	}
+
+	DBM_Entry
+	Zone_DBM::at(std::string clock, std::size_t y) const
+	{
+		return at(get_index_of_clock(clock), y);
+	}
+
+	DBM_Entry
+	Zone_DBM::at(std::size_t x, std::string clock) const
+	{
+		return at(x, get_index_of_clock(clock));
+	}
+
+	DBM_Entry
+	Zone_DBM::at(std::string clock1, std::string clock2) const
+	{
+		return at(get_index_of_clock(clock1), get_index_of_clock(clock2));
+	}
+
+	std::size_t
+	Zone_DBM::size() const
+	{
+		if(is_compressed()) {
+			return reduced().get_clocks().size();
+		}
+
+		return graph().size() - 1;
+	}
+
+	//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	// LOCAL FUNCTIONS FROM HERE ON
+	//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+	namespace {
+
+		/** Relax all edges over vertex k of a matrix whose dimension N is known at compile time, such that both loops
+		 * can be unrolled completely */
+		template <std::size_t N>
+		inline void
+		relax_over_fixed(DBM_Bound *matrix, std::size_t k)
+		{
+			const DBM_Bound *row_k = matrix + k * N;
+
+#pragma GCC unroll 16
+			for(std::size_t i = 0; i < N; i++) {
+				DBM_Bound *row_i = matrix + i * N;
+				const DBM_Bound distance_ik = row_i[k];
+
+				//Nothing can be shortened via an unbounded edge
+				if(distance_ik == DBM_BOUND_INFINITY) {
+					continue;
+				}
+
+#pragma GCC unroll 16
+				for(std::size_t j = 0; j < N; j++) {
+					row_i[j] = std::min(row_i[j], add_bounds(distance_ik, row_k[j]));
+				}
+			}
+		}
+
+		template <std::size_t N>
+		void
+		floyd_warshall_fixed(DBM_Bound *matrix)
+		{
+			for(std::size_t k = 0; k < N; k++) {
+				relax_over_fixed<N>(matrix, k);
+			}
+		}
+
+		using Fixed_Closure = void (*)(DBM_Bound *);
+		using Fixed_Relaxation = void (*)(DBM_Bound *, std::size_t);
+
+		template <std::size_t... N>
+		constexpr std::array<Fixed_Closure, sizeof...(N)>
+		make_fixed_closures(std::index_sequence<N...>)
+		{
+			return {&floyd_warshall_fixed<N>...};
+		}
+
+		template <std::size_t... N>
+		constexpr std::array<Fixed_Relaxation, sizeof...(N)>
+		make_fixed_relaxations(std::index_sequence<N...>)
+		{
+			return {&relax_over_fixed<N>...};
+		}
+
+		//Both are indexed by the dimension of the matrix
+		constexpr auto fixed_closures    = make_fixed_closures(std::make_index_sequence<DBM_INLINE_DIMENSION + 1>{});
+		constexpr auto fixed_relaxations = make_fixed_relaxations(std::make_index_sequence<DBM_INLINE_DIMENSION + 1>{});
+
+	} // namespace
+
+	void 
+	Graph::floyd_warshall()
+	{
+		//Inconsistent DBMs can't become canonical
+		if(get_bound_value(get(0,0)) != 0) {
+			return;
+		}
+
+		//copied from Wikipedia
+
+		std::size_t n = size();
+
+		//Set distance of a node to itself to 0
+		for(std::size_t u = 0; u < n; u++) {
+			get(u, u) = DBM_BOUND_LE_ZERO;
+		}
+
+		//Small matrices are stored inline, so their closure is specialized for their exact dimension
+		if(n <= DBM_INLINE_DIMENSION) {
+			fixed_closures[n](matrix_.data());
+		} else {
+			const DBM_Kernels &kernels = get_dbm_kernels();
+
+			//Find shortest distance between each pair of nodes
+			for(std::size_t k = 0; k < n; k++) {
+				const DBM_Bound *row_k = matrix_.row(k);
+
+				for(std::size_t i = 0; i < n; i++) {
+					DBM_Bound *row_i = matrix_.row(i);
+					const DBM_Bound distance_ik = row_i[k];
+
+					//Nothing can be shortened via an unbounded edge
+					if(distance_ik == DBM_BOUND_INFINITY) {
+						continue;
+					}
+
+					kernels.relax_row(row_i, row_k, distance_ik, n);
+				}
+			}
+		}
+
+		//A negative cycle shows up on the diagonal of each of its vertices
+		if(has_negative_diagonal()) {
+			mark_inconsistent();
+		}
+	}
+
+	std::size_t
+	Graph::hash(const ClockRegistry &registry) const
+	{
+		std::size_t seed = 0;
+		for(const ClockID clock : clock_to_index) {
+			utilities::hash_combine(seed, clock == ZERO_CLOCK_ID ? std::size_t{0} : registry.get_name_hash(clock));
+		}
+		utilities::hash_combine(seed, utilities::hash_range(data(), data() + size() * size()));
+
+		return seed;
+	}
+
+	bool
+	Graph::add_clock(ClockID clock)
+	{
+		//Check whether clock already exists
+		assert(!has_clock(clock));
+
+		std::size_t old_size = size();
+		Matrix new_matrix = Matrix(old_size + 1);
+
+		//Copy the old matrix. New Rows and Columns are already unbounded, so no need to fill those in
+		for(std::size_t i = 0; i < old_size; i++) {
+			for(std::size_t j = 0; j < old_size; j++) {
+				new_matrix(i, j) = get_bound(i, j);
+			}
+		}
+
+		//Update indices
+		clock_to_index.push_back(clock);
+
+		//Update Matrix
+		matrix_ = new_matrix;
+		get(old_size, old_size) = DBM_BOUND_LE_ZERO;
+
+		return true;
+	}
+
+	bool
+	Graph::unbound_clock(ClockID clock)
+	{
+		//Check whether clock exists
+		if(!has_clock(clock)) {
+			return false;
+		}
+
+		std::size_t index = get_index_of_clock(clock);
+
+		for(std::size_t i = 0; i < size(); i++) {
+			matrix_(i, index) = DBM_BOUND_INFINITY;
+			matrix_(index, i) = DBM_BOUND_INFINITY;
+		}
+		matrix_(index, index) = DBM_BOUND_LE_ZERO;
+
+		return true;
+	}
+
+	bool
+	Graph::remove_clock(ClockID clock)
+	{
+		//Check whether clock exists
+		assert(has_clock(clock));
+
+		std::size_t index_to_delete = get_index_of_clock(clock);
+
+		std::size_t old_size = size();
+		Matrix new_matrix = Matrix(old_size - 1);
+
+		//Copy the old matrix up to the deleted clock
+		for(std::size_t i = 0; i < index_to_delete; i++) {
+			//Fill in top left corner
+			for(std::size_t j = 0; j < index_to_delete; j++) {
+				new_matrix(i, j) = matrix_.get(i, j);
+			}
+
+			//Fill in Top right and bottom left corner
+			for(std::size_t j = index_to_delete + 1; j < old_size; j++) {
+				new_matrix(i, j - 1) = matrix_.get(i, j);
+				new_matrix(j - 1, i) = matrix_.get(j, i);
+			}
+		}
+
+		//Fill in bottom right corner
+		for(std::size_t i = index_to_delete + 1; i < old_size; i++) {
+			for(std::size_t j = index_to_delete + 1; j < old_size; j++) {
+				new_matrix(i-1, j-1) = matrix_.get(i,j);
+			}
+		}
+
+		//Update Indices
+		clock_to_index.erase(index_to_delete);
+
+		//Update Matrix
+		matrix_ = new_matrix;
+
+		return true;
+	}
+
+	bool
+	Graph::close_over(const std::vector<std::size_t> &vertices)
+	{
+		//Inconsistent DBMs can't become canonical
+		if(has_negative_diagonal()) {
+			mark_inconsistent();
+			return false;
+		}
+
+		std::size_t n = size();
+		const DBM_Kernels &kernels = get_dbm_kernels();
+		const Fixed_Relaxation relax_over = n <= DBM_INLINE_DIMENSION ? fixed_relaxations[n] : nullptr;
+
+		for(const std::size_t k : vertices) {
+			if(relax_over != nullptr) {
+				relax_over(matrix_.data(), k);
+			} else {
+				const DBM_Bound *row_k = matrix_.row(k);
+
+				for(std::size_t i = 0; i < n; i++) {
+					DBM_Bound *row_i = matrix_.row(i);
+					const DBM_Bound distance_ik = row_i[k];
+
+					if(distance_ik == DBM_BOUND_INFINITY) {
+						continue;
+					}
+
+					kernels.relax_row(row_i, row_k, distance_ik, n);
+				}
+			}
+
+			//A negative cycle through k shows up on its diagonal
+			if(get(k, k) < DBM_BOUND_LE_ZERO) {
+				mark_inconsistent();
+				return false;
+			}
+		}
+
+		//A negative cycle that doesn't pass through any of the vertices shows up on some other diagonal
+		if(has_negative_diagonal()) {
+			mark_inconsistent();
+			return false;
+		}
+
+		return true;
+	}
+
+	void
+	Graph::copy_clock(std::size_t new_index, std::size_t old_index)
+	{
+		assert(new_index != 0);
+
+		for(std::size_t i = 0; i < size(); i++) {
+			get(new_index, i) = get(old_index, i);
+			get(i, new_index) = get(i, old_index);
+		}
+		get(new_index, new_index) = DBM_BOUND_LE_ZERO;
+		get(new_index, old_index) = DBM_BOUND_LE_ZERO;
+		get(old_index, new_index) = DBM_BOUND_LE_ZERO;
+	}
+
+	std::vector<ClockID> Graph::get_clocks() const
+	{
+		return std::vector<ClockID>(std::next(clock_to_index.begin()), clock_to_index.end());
+	}
+
+	Reduced_DBM::Reduced_DBM(const Graph &graph) : clocks_(graph.get_clocks())
+	{
+		assert(graph.size() > 0);
+
+		if(graph.get_bound(0, 0) != DBM_BOUND_LE_ZERO) {
+			consistent_ = false;
+			return;
+		}
+
+		const std::size_t n = graph.size();
+
+		//The representative of a vertex is the smallest vertex of its zero cycle class
+		std::vector<std::size_t> representative(n);
+		//The largest vertex of each class found so far, the class cycle is continued from there
+		std::vector<std::size_t> last_member(n);
+		for(std::size_t i = 0; i < n; i++) {
+			representative[i] = i;
+			last_member[i]    = i;
+
+			//In a canonical graph, zero cycles are transitive, so comparing with the representatives is enough
+			for(std::size_t j = 0; j < i; j++) {
+				if(representative[j] == j && add_bounds(graph.get_bound(i, j), graph.get_bound(j, i)) == DBM_BOUND_LE_ZERO) {
+					representative[i] = j;
+					break;
+				}
+			}
+
+			const std::size_t r = representative[i];
+			if(r != i) {
+				constraints_.push_back({(std::uint32_t) last_member[r], (std::uint32_t) i, graph.get_bound(last_member[r], i)});
+				last_member[r] = i;
+			}
+		}
+
+		//Close the cycle of each class
+		for(std::size_t r = 0; r < n; r++) {
+			if(representative[r] == r && last_member[r] != r) {
+				constraints_.push_back({(std::uint32_t) last_member[r], (std::uint32_t) r, graph.get_bound(last_member[r], r)});
+			}
+		}
+
+		//Between classes, an edge is redundant if the path over a third class is just as tight
+		for(std::size_t i = 0; i < n; i++) {
+			if(representative[i] != i) {
+				continue;
+			}
+
+			for(std::size_t j = 0; j < n; j++) {
+				const DBM_Bound bound = graph.get_bound(i, j);
+				if(i == j || representative[j] != j || bound == DBM_BOUND_INFINITY) {
+					continue;
+				}
+
+				bool redundant = false;
+				for(std::size_t k = 0; k < n && !redundant; k++) {
+					redundant = k != i && k != j && representative[k] == k
+					            && add_bounds(graph.get_bound(i, k), graph.get_bound(k, j)) <= bound;
+				}
+
+				if(!redundant) {
+					constraints_.push_back({(std::uint32_t) i, (std::uint32_t) j, bound});
+				}
+			}
+		}
+	}
+
+	Graph
+	Reduced_DBM::get_graph() const
+	{
+		Graph graph{clocks_};
+
+		if(!consistent_) {
+			graph.mark_inconsistent();
+			return graph;
+		}
+
+		for(const auto &constraint : constraints_) {
+			graph.tighten(constraint.x, constraint.y, constraint.bound);
+		}
+		graph.floyd_warshall();
+
+		return graph;
+	}
+
+	ClockID
+	ClockRegistry::get_id(const std::string &clock_name)
+	{
+		{
+			std::shared_lock lock{mutex_};
+			auto it = ids_.find(clock_name);
+			if(it != ids_.end()) {
+				return it->second;
+			}
+		}
+
+		std::unique_lock lock{mutex_};
+		//Someone else may have registered the clock in the meantime
+		auto [it, inserted] = ids_.insert({clock_name, (ClockID) names_.size()});
+		if(inserted) {
+			names_.push_back(clock_name);
+			name_hashes_.push_back(std::hash<std::string>{}(clock_name));
 		}
 
-		if(!lower_entry.infinity_) {
-			and_func(0, index, lower_entry);
+		return it->second;
+	}
+
+	std::optional<ClockID>
+	ClockRegistry::find_id(const std::string &clock_name) const
+	{
+		std::shared_lock lock{mutex_};
+		auto it = ids_.find(clock_name);
+		if(it == ids_.end()) {
+			return std::nullopt;
 		}
 
+		return it->second;
+	}
+
+	const std::string &
+	ClockRegistry::get_name(ClockID id) const
+	{
+		std::shared_lock lock{mutex_};
+		assert(id < names_.size());
 
-		normalize();
+		return names_[id];
 	}
 
-	void
-	Zone_DBM::conjunct(std::multimap<std::string, automata::ClockConstraint> clock_constraints) {
-		for(auto iter1 = clock_constraints.begin(); iter1 != clock_constraints.end(); iter1++) {
-			conjunct(iter1->first, iter1->second);
-		}
+	std::size_t
+	ClockRegistry::get_name_hash(ClockID id) const
+	{
+		std::shared_lock lock{mutex_};
+		assert(id < name_hashes_.size());
+
+		return name_hashes_[id];
 	}
 
-	void
-	Zone_DBM::normalize()
+	std::size_t
+	ClockRegistry::size() const
 	{
-		for(std::size_t i = 0; i < graph_.size(); i++) {
-			for(std::size_t j = 0; j < graph_.size(); j++) {
-				if(!graph_.get(i, j).infinity_ && DBM_Entry{(int) max_constant_, true} < graph_.get(i, j)) {
-					graph_.get(i, j).infinity_ = true;
-				} else if(!graph_.get(i, j).infinity_ && graph_.get(i, j) < DBM_Entry{-1*((int) max_constant_), false}) {
-					graph_.get(i, j) = DBM_Entry{-1*((int) max_constant_), false};
-				}
-			}
-		}
+		std::shared_lock lock{mutex_};
 
-		//graph_.floyd_warshall();
+		return names_.size();
 	}
 
-	bool
-	Zone_DBM::is_consistent() const
+	std::shared_ptr<ClockRegistry>
+	ClockRegistry::get_default()
 	{
-		return graph_.get_value(0, 0) == DBM_Entry{0, true};
+		static std::shared_ptr<ClockRegistry> default_registry = std::make_shared<ClockRegistry>();
+
+		return default_registry;
 	}
 
-	//TODO This doesn't consider that old clocks may have been removed
-	RegionIndex
-	Zone_DBM::get_increment(Zone_DBM new_dbm) const
+	namespace {
+		std::atomic<std::uint64_t> next_pool_id{1};
+	} // namespace
+
+	DBM_Pool::DBM_Pool() : id_(next_pool_id++)
 	{
-		//Find the largest difference in magnitude, unless it is of a clock that has been reset.
-		RegionIndex largest_difference = 0;
 
-		for(const auto &clock : new_dbm.get_clocks()) {
-			if(!has_clock(clock)) {
-				continue;
-			}
-			std::size_t index = get_index_of_clock(clock);
+	}
 
-			//I am stupid and don't know how to incorporate zero clock into for loop
-			{
-				RegionIndex lower_difference = new_dbm.graph_.get(clock, 0) - graph_.get_value(index, 0);
-				RegionIndex upper_difference = new_dbm.graph_.get(0, clock) - graph_.get_value(0, index);
-				RegionIndex difference = std::max(lower_difference, upper_difference);
-				if(difference > largest_difference) {
-					largest_difference = difference;
-				}
-			}
+	void
+	DBM_Pool::intern(Zone_DBM &dbm)
+	{
+		if(dbm.storage_ == nullptr || dbm.storage_->pool_id == id_) {
+			return;
+		}
 
-			for(const auto &other_clock : new_dbm.get_clocks()) {
-				if(!has_clock(other_clock)) {
-					continue;
+		//Only full matrices are interned
+		dbm.decompress();
+
+		const std::size_t hash = dbm.hash();
+
+		auto find_equal = [&](const std::vector<std::weak_ptr<Zone_DBM::Storage>> &candidates) {
+			for(const auto &candidate : candidates) {
+				std::shared_ptr<Zone_DBM::Storage> storage = candidate.lock();
+				//Graphs only compare equal with the same clocks, equal bounds over different clocks are different DBMs
+				if(storage != nullptr && static_cast<const Zone_DBM::Graph_Storage &>(*storage).graph == dbm.graph()) {
+					return storage;
 				}
+			}
 
-				std::size_t other_index = get_index_of_clock(other_clock);
+			return std::shared_ptr<Zone_DBM::Storage>{};
+		};
 
-				RegionIndex lower_difference = new_dbm.graph_.get(clock, other_clock) - graph_.get_value(index, other_index);
-				RegionIndex upper_difference = new_dbm.graph_.get(other_clock, clock) - graph_.get_value(other_index, index);
-				RegionIndex difference = std::max(lower_difference, upper_difference);
-				if(difference > largest_difference) {
-					largest_difference = difference;
+		{
+			std::shared_lock lock{mutex_};
+			auto it = storages_.find(hash);
+			if(it != storages_.end()) {
+				if(auto storage = find_equal(it->second)) {
+					dbm.storage_ = std::move(storage);
+					return;
 				}
 			}
 		}
 
-		return largest_difference;
-	}
+		std::unique_lock lock{mutex_};
+		auto &candidates = storages_[hash];
 
-	void
-	Zone_DBM::and_func(std::size_t x, std::size_t y, DBM_Entry comparison)
-	{
-		//Check whether this will make the zone inconsistent, i.e. negative cycle
-		if(graph_.get(y, x) + comparison < DBM_Entry{0, false}) {
-			graph_.get(0, 0) = DBM_Entry{-1, false};
+		//Another thread may have added an equal matrix in the meantime
+		if(auto storage = find_equal(candidates)) {
+			dbm.storage_ = std::move(storage);
 			return;
 		}
 
-		if(comparison < graph_.get(x, y)) {
-			graph_.get(x, y) = comparison;
-			
-			//Make canonical by getting shortest paths
-			graph_.floyd_warshall();
+		candidates.erase(std::remove_if(candidates.begin(), candidates.end(), [](const auto &candidate) {
+			return candidate.expired();
+		}), candidates.end());
+
+		//A storage that belongs to another pool is immutable and one that is shared may be read by other threads, so
+		//this pool gets its own copy
+		if(!dbm.owns_storage()) {
+			dbm.storage_ = std::make_shared<Zone_DBM::Graph_Storage>(static_cast<const Zone_DBM::Graph_Storage &>(*dbm.storage_));
 		}
+		dbm.storage_->pool_id = id_;
+		candidates.push_back(dbm.storage_);
 	}
 
-	std::size_t
-	Zone_DBM::get_index_of_clock(std::string clock) const
+	void
+	DBM_Pool::compress(Zone_DBM &dbm)
 	{
-		return graph_.get_index_of_clock(clock);
-	}
+		if(dbm.storage_ == nullptr || (dbm.is_compressed() && dbm.storage_->pool_id == id_) || !dbm.is_consistent()) {
+			return;
+		}
 
-	std::vector<std::string>
-	Zone_DBM::get_clocks() const
-	{
-		return graph_.get_clocks();
-	}
+		//The hash of the full matrix, which compressing keeps
+		const std::size_t hash    = dbm.hash();
+		const Reduced_DBM reduced = dbm.get_minimal_constraints();
 
-	bool
-	Zone_DBM::add_clock(std::string clock_name)
-	{
-		return graph_.add_clock(clock_name);
-	}
+		auto find_equal = [&](const std::vector<std::weak_ptr<Zone_DBM::Storage>> &candidates) {
+			for(const auto &candidate : candidates) {
+				std::shared_ptr<Zone_DBM::Storage> storage = candidate.lock();
+				if(storage == nullptr) {
+					continue;
+				}
+				const Reduced_DBM &other = static_cast<const Zone_DBM::Reduced_Storage &>(*storage).reduced;
+				if(other.get_clocks() == reduced.get_clocks() && other.get_constraints() == reduced.get_constraints()) {
+					return storage;
+				}
+			}
 
-	bool
-	Zone_DBM::copy_clock(std::string new_clock_name, std::string clock_to_copy)
-	{
-		//If same, then don't need to do anything
-		if(new_clock_name == clock_to_copy) {
-			return true;
-		}
+			return std::shared_ptr<Zone_DBM::Storage>{};
+		};
 
-		if(!graph_.has_clock(clock_to_copy)) {
-			return false;
+		{
+			std::shared_lock lock{mutex_};
+			auto it = reduced_storages_.find(hash);
+			if(it != reduced_storages_.end()) {
+				if(auto storage = find_equal(it->second)) {
+					dbm.storage_ = std::move(storage);
+					return;
+				}
+			}
 		}
 
-		if(!graph_.has_clock(new_clock_name)) {
-			add_clock(new_clock_name);
-		} else {
-			graph_.unbound_clock(new_clock_name);
-		}
+		std::unique_lock lock{mutex_};
+		auto &candidates = reduced_storages_[hash];
 
-		//Set the constraint new_clock - old_clock <= 0 AND old_clock - new_clock <= 0. This way the clocks are constrained to be the same
-		graph_.get(new_clock_name, clock_to_copy) = DBM_Entry{0, true};
-		graph_.get(clock_to_copy, new_clock_name) = DBM_Entry{0, true};
+		//Another thread may have added equal minimal constraints in the meantime
+		if(auto storage = find_equal(candidates)) {
+			dbm.storage_ = std::move(storage);
+			return;
+		}
 
-		//Make canonical to fill the entries of the new clock
-		graph_.floyd_warshall();
+		candidates.erase(std::remove_if(candidates.begin(), candidates.end(), [](const auto &candidate) {
+			return candidate.expired();
+		}), candidates.end());
 
-		return true;
+		dbm.storage_ = std::make_shared<Zone_DBM::Reduced_Storage>(reduced, hash);
+		dbm.storage_->pool_id = id_;
+		candidates.push_back(dbm.storage_);
 	}
 
-	bool
-	Zone_DBM::remove_clock(std::string clock_name)
+	std::size_t
+	DBM_Pool::count_in_use(const Storages &storages)
 	{
-		return graph_.remove_clock(clock_name);
+		std::size_t size = 0;
+		for(const auto &[hash, candidates] : storages) {
+			size += std::count_if(candidates.begin(), candidates.end(), [](const auto &candidate) {
+				return !candidate.expired();
+			});
+		}
+
+		return size;
 	}
 
-	bool
-	Zone_DBM::has_clock(std::string clock_name) const
+	std::size_t
+	DBM_Pool::size() const
 	{
-		return graph_.has_clock(clock_name);
+		std::shared_lock lock{mutex_};
+
+		return count_in_use(storages_);
 	}
 
-	Zone_DBM
-	Zone_DBM::get_subset(std::set<std::string> clocks) const
+	std::size_t
+	DBM_Pool::compressed_size() const
 	{
-		Graph new_graph{clocks};
+		std::shared_lock lock{mutex_};
 
-		for(const auto &clock : clocks) {
-			new_graph.get(clock, 0) = at(clock, 0);
-			new_graph.get(0, clock) = at(0, clock);
+		return count_in_use(reduced_storages_);
+	}
 
-			//Get difference constraints too
-			for(const auto &other_clock : clocks) {
-				new_graph.get(clock, other_clock) = at(clock, other_clock);
+	namespace {
+		/** Get the index in graph2 of the clock at each index of graph1 */
+		std::vector<std::size_t>
+		get_index_mapping(const Graph &graph1, const Graph &graph2)
+		{
+			assert(graph1.size() == graph2.size());
+
+			std::vector<std::size_t> mapping(graph1.size(), 0);
+			for(std::size_t i = 1; i < graph1.size(); i++) {
+				assert(graph2.has_clock(graph1.get_clock_at(i)));
+				mapping[i] = graph2.get_index_of_clock(graph1.get_clock_at(i));
 			}
-		}
 
-		new_graph.floyd_warshall();
+			return mapping;
+		}
 
-		Zone_DBM new_dbm{new_graph, max_constant_};
-		return new_dbm;
-	}
+		/** The negation of x - y < b or x - y <= b is y - x >= -b or y - x > -b, respectively */
+		DBM_Bound
+		negate_bound(DBM_Bound bound)
+		{
+			assert(bound != DBM_BOUND_INFINITY);
+			return 1 - bound;
+		}
+	} // namespace
 
-	DBM_Entry
-	Zone_DBM::at(std::size_t x, std::size_t y) const
+	Federation::Federation(const Zone_DBM &zone)
 	{
-		return graph_.get_value(x, y);
+		add(zone);
 	}
 
-	DBM_Entry
-	Zone_DBM::at(std::string clock, std::size_t y) const
+	void
+	Federation::add(const Zone_DBM &zone)
 	{
-		return graph_.get_value(graph_.get_index_of_clock(clock), y);
+		if(zone.is_consistent()) {
+			zones_.push_back(zone);
+		}
 	}
 
-	DBM_Entry
-	Zone_DBM::at(std::size_t x, std::string clock) const
+	Federation
+	Federation::unite(const Federation &other) const
 	{
-		return graph_.get_value(x, graph_.get_index_of_clock(clock));
-	}
+		Federation result = *this;
+		result.zones_.insert(result.zones_.end(), other.zones_.begin(), other.zones_.end());
 
-	DBM_Entry
-	Zone_DBM::at(std::string clock1, std::string clock2) const
-	{
-		return graph_.get_value(graph_.get_index_of_clock(clock1), graph_.get_index_of_clock(clock2));
+		return result;
 	}
 
-	std::size_t
-	Zone_DBM::size() const
+	Federation
+	Federation::intersect(const Federation &other) const
 	{
-		return graph_.size() - 1;
-	}
+		Federation result;
+		for(const auto &zone1 : zones_) {
+			for(const auto &zone2 : other.zones_) {
+				result.add(intersect(zone1, zone2));
+			}
+		}
 
-	//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-	// LOCAL FUNCTIONS FROM HERE ON
-	//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+		return result;
+	}
 
-	void 
-	Graph::floyd_warshall()
+	Federation
+	Federation::subtract(const Federation &other) const
 	{
-		//Inconsistent DBMs can't become canonical
-		if(get(0,0).value_ != 0) {
-			return;
+		Federation result = *this;
+		for(const auto &zone2 : other.zones_) {
+			Federation remainder;
+			for(const auto &zone1 : result.zones_) {
+				for(auto &piece : subtract(zone1, zone2)) {
+					remainder.zones_.push_back(std::move(piece));
+				}
+			}
+			result = std::move(remainder);
 		}
 
-		//copied from Wikipedia
-
-		std::size_t n = size();
+		return result;
+	}
 
-		//Set distance of a node to itself to 0
-		for(std::size_t u = 0; u < n; u++) {
-			get(u, u) = DBM_Entry{0, true};
+	bool
+	Federation::is_included_in(const Federation &other) const
+	{
+		//Most of the time every member is already included in a single member of the other federation
+		if(std::all_of(zones_.begin(), zones_.end(), [&other](const Zone_DBM &zone) {
+			   return std::any_of(other.zones_.begin(), other.zones_.end(), [&zone](const Zone_DBM &other_zone) {
+				   return zone.is_included_in(other_zone);
+			   });
+		   })) {
+			return true;
 		}
 
-		//Find shortest distance between each pair of nodes
-		for(std::size_t k = 0; k < n; k++) {
-			for(std::size_t i = 0; i < n; i++) {
-				for(std::size_t j = 0; j < n; j++) {
-					DBM_Entry new_distance = get(i, k) + get(k, j);
+		return subtract(other).is_empty();
+	}
 
-					if(new_distance < get(i, j)) {
-						get(i, j) = new_distance;
+	void
+	Federation::reduce()
+	{
+		bool changed = true;
+		while(changed) {
+			changed = false;
+
+			//Remove members that are included in another member, of equal members the first one is kept
+			std::vector<Zone_DBM> kept;
+			for(std::size_t i = 0; i < zones_.size(); i++) {
+				bool included = false;
+				for(std::size_t j = 0; j < zones_.size() && !included; j++) {
+					included = i != j && zones_[i].is_included_in(zones_[j])
+					           && (j < i || !zones_[j].is_included_in(zones_[i]));
+				}
+				if(!included) {
+					kept.push_back(zones_[i]);
+				}
+			}
+			zones_ = std::move(kept);
+
+			//Replace two members by their convex hull if it doesn't contain any other valuations
+			for(std::size_t i = 0; i < zones_.size() && !changed; i++) {
+				for(std::size_t j = i + 1; j < zones_.size() && !changed; j++) {
+					Zone_DBM hull = convex_hull(zones_[i], zones_[j]);
+					Federation pair{zones_[i]};
+					pair.add(zones_[j]);
+					if(Federation{hull}.subtract(pair).is_empty()) {
+						zones_[i] = std::move(hull);
+						zones_.erase(zones_.begin() + j);
+						changed = true;
 					}
 				}
 			}
 		}
 	}
 
-	bool
-	Graph::add_clock(std::string clock_name)
+	Zone_DBM
+	Federation::intersect(const Zone_DBM &zone1, const Zone_DBM &zone2)
 	{
-		//Check whether clock already exists
-		assert(!has_clock(clock_name));
-
-		std::size_t old_size = size();
-		Matrix new_matrix = Matrix(old_size + 1);
+		Zone_DBM result = zone1;
+		if(!result.is_consistent()) {
+			return result;
+		}
+		if(!zone2.is_consistent()) {
+			result.mutable_graph().mark_inconsistent();
+			return result;
+		}
 
-		//Copy the old matrix. New Rows and Columns are already unbounded, so no need to fill those in
-		for(std::size_t i = 0; i < old_size; i++) {
-			for(std::size_t j = 0; j < old_size; j++) {
-				new_matrix(i, j) = get_value(i, j);
+		Graph buffer;
+		const Graph &other = zone2.read_graph(buffer);
+		Graph &graph = result.mutable_graph();
+		const std::vector<std::size_t> mapping = get_index_mapping(graph, other);
+
+		//Only paths over endpoints of tightened edges can become shorter
+		std::vector<std::size_t> tightened;
+		for(std::size_t i = 0; i < graph.size(); i++) {
+			for(std::size_t j = 0; j < graph.size(); j++) {
+				if(graph.tighten(i, j, other.get_bound(mapping[i], mapping[j]))) {
+					for(const std::size_t vertex : {i, j}) {
+						if(std::find(tightened.begin(), tightened.end(), vertex) == tightened.end()) {
+							tightened.push_back(vertex);
+						}
+					}
+				}
 			}
 		}
 
-		//Update indices
-		clock_to_index.push_back(clock_name);
-
-		//Update Matrix
-		matrix_ = new_matrix;
-
-		//Get canonical form
-		floyd_warshall();
+		if(!tightened.empty()) {
+			graph.close_over(tightened);
+		}
 
-		return true;
+		return result;
 	}
 
-	bool
-	Graph::unbound_clock(std::string clock_name)
+	std::vector<Zone_DBM>
+	Federation::subtract(const Zone_DBM &zone1, const Zone_DBM &zone2)
 	{
-		//Check whether clock exists
-		if(!has_clock(clock_name)) {
-			return false;
+		if(!zone1.is_consistent()) {
+			return {};
 		}
+		if(!zone2.is_consistent() || !intersect(zone1, zone2).is_consistent()) {
+			return {zone1};
+		}
+
+		Graph buffer;
+		const Graph &other = zone2.read_graph(buffer);
+
+		//Each piece violates one constraint of zone2 and satisfies all constraints before it, so the pieces are disjoint
+		std::vector<Zone_DBM> pieces;
+		Zone_DBM remainder = zone1;
+		remainder.decompress();
+		const std::vector<std::size_t> mapping = get_index_mapping(remainder.graph(), other);
+		for(std::size_t i = 0; i < remainder.graph().size() && remainder.is_consistent(); i++) {
+			for(std::size_t j = 0; j < remainder.graph().size() && remainder.is_consistent(); j++) {
+				const DBM_Bound bound = other.get_bound(mapping[i], mapping[j]);
+				if(i == j || bound == DBM_BOUND_INFINITY || remainder.graph().get_bound(i, j) <= bound) {
+					continue;
+				}
 
-		std::size_t index = get_index_of_clock(clock_name);
+				Zone_DBM piece = remainder;
+				piece.and_func(j, i, negate_bound(bound));
+				if(piece.is_consistent()) {
+					pieces.push_back(std::move(piece));
+				}
 
-		for(std::size_t i = 0; i < size(); i++) {
-			matrix_(i, index) = DBM_Entry{true, 0, false};
-			matrix_(index, i) = DBM_Entry{true, 0, false};
+				remainder.and_func(i, j, bound);
+			}
 		}
 
-		floyd_warshall();
-
-		return true;
+		return pieces;
 	}
 
-	bool
-	Graph::remove_clock(std::string clock_name)
+	Zone_DBM
+	Federation::convex_hull(const Zone_DBM &zone1, const Zone_DBM &zone2)
 	{
-		//Check whether clock exists
-		assert(has_clock(clock_name));
-
-		std::size_t index_to_delete = get_index_of_clock(clock_name);
-
-		std::size_t old_size = size();
-		Matrix new_matrix = Matrix(old_size);
-
-		//Copy the old matrix up to the deleted clock
-		for(std::size_t i = 0; i < index_to_delete; i++) {
-			//Fill in top left corner
-			for(std::size_t j = 0; j < index_to_delete; j++) {
-				new_matrix(i, j) = matrix_.get(i, j);
+		assert(zone1.is_consistent() && zone2.is_consistent());
+
+		Zone_DBM result = zone1;
+		Graph buffer;
+		const Graph &other = zone2.read_graph(buffer);
+		Graph &graph = result.mutable_graph();
+		const std::vector<std::size_t> mapping = get_index_mapping(graph, other);
+
+		//The maximum of two canonical DBMs is canonical
+		for(std::size_t i = 0; i < graph.size(); i++) {
+			for(std::size_t j = 0; j < graph.size(); j++) {
+				graph.get(i, j) = std::max(graph.get(i, j), other.get_bound(mapping[i], mapping[j]));
 			}
+		}
 
-			//Fill in Top right and bottom left corner
-			for(std::size_t j = index_to_delete + 1; j < old_size; j++) {
-				new_matrix(i, j - 1) = matrix_.get(i, j);
-				new_matrix(j - 1, i) = matrix_.get(j, i);
-			}
+		return result;
+	}
+
+	void
+	ClockBounds::add_clock(ClockID clock)
+	{
+		if(clock >= bounds_.size()) {
+			bounds_.resize(clock + 1);
 		}
 
-		//Fill in bottom right corner
-		for(std::size_t i = index_to_delete + 1; i < old_size; i++) {
-			for(std::size_t j = index_to_delete + 1; j < old_size; j++) {
-				new_matrix(i-1, j-1) = matrix_.get(i,j);
-			}
+		if(!bounds_[clock].has_value()) {
+			bounds_[clock] = Bounds{};
 		}
+	}
 
-		//Update Indices (Addition is for having an iterator)
-		clock_to_index.erase(clock_to_index.begin() + index_to_delete);
+	void
+	ClockBounds::add_constraint(ClockID clock, const automata::ClockConstraint &clock_constraint)
+	{
+		add_clock(clock);
+		add_constraint(*bounds_[clock], clock_constraint);
+	}
 
-		//Update Matrix
-		matrix_ = new_matrix;
+	void
+	ClockBounds::add_default_constraint(const automata::ClockConstraint &clock_constraint)
+	{
+		add_constraint(default_bounds_, clock_constraint);
+	}
 
-		//Make canonical
-		floyd_warshall();
+	Endpoint
+	ClockBounds::get_lower_bound(ClockID clock) const
+	{
+		return get_bounds(clock).lower;
+	}
 
-		return true;
+	Endpoint
+	ClockBounds::get_upper_bound(ClockID clock) const
+	{
+		return get_bounds(clock).upper;
 	}
 
-	std::vector<std::string> Graph::get_clocks() const
+	void
+	ClockBounds::add_constraint(Bounds &bounds, const automata::ClockConstraint &clock_constraint)
 	{
-		std::vector<std::string> ret;
-		for(std::size_t i = 1; i < size(); i++) {
-			ret.push_back(clock_to_index[i]);
-		}
+		Endpoint constant = std::visit([](const auto &atomic_clock_constraint)
+						-> Time { return atomic_clock_constraint.get_comparand(); },
+						clock_constraint); //Visit due to ClockConstraint being a variant
 
-		return ret;
+		std::optional<int> relation_opt = automata::get_relation_index(clock_constraint);
+		assert(relation_opt.has_value());
+
+		switch (relation_opt.value())
+		{
+		case 0: //less
+		case 1: //less_equal
+			bounds.upper = std::max(bounds.upper, constant);
+			break;
+		case 4: //greater_equal
+		case 5: //greater
+			bounds.lower = std::max(bounds.lower, constant);
+			break;
+		default: //equal_to, and not_equal which is treated like it for safety
+			bounds.upper = std::max(bounds.upper, constant);
+			bounds.lower = std::max(bounds.lower, constant);
+			break;
+		}
 	}
 
-	bool
-	Graph::has_clock(std::string clock_name) const
+	const ClockBounds::Bounds &
+	ClockBounds::get_bounds(ClockID clock) const
 	{
-		return std::find(clock_to_index.begin(), clock_to_index.end(), clock_name) != clock_to_index.end();
+		if(clock < bounds_.size() && bounds_[clock].has_value()) {
+			return *bounds_[clock];
+		}
+
+		return default_bounds_;
 	}
 
 	RegionIndex
@@ -707,6 +2016,12 @@ namespace tacos::zones {
 	std::ostream &
 	operator<<(std::ostream &os, const tacos::zones::Zone_DBM &dbm)
 	{
+		if(dbm.is_compressed()) {
+			Zone_DBM decompressed = dbm;
+			decompressed.decompress();
+			return os << decompressed;
+		}
+
 		std::vector<std::string> clocks = dbm.get_clocks();
 
 		for (std::size_t i = 0; i < dbm.size() + 1; i++)
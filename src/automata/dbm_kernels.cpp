@@ -0,0 +1,265 @@
+#include "automata/dbm_kernels.h"
+
+#include <cassert>
+#include <initializer_list>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define TACOS_DBM_KERNELS_X86
+#include <immintrin.h>
+#endif
+
+namespace tacos::zones {
+
+	namespace {
+
+		//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+		// SCALAR REFERENCE
+		//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+		//Same as zones::add_bounds, but distance_ik is known to be finite
+		inline DBM_Bound
+		add_finite(DBM_Bound distance_ik, DBM_Bound bound)
+		{
+			if(bound == DBM_BOUND_INFINITY) {
+				return DBM_BOUND_INFINITY;
+			}
+
+			return ((distance_ik & ~1) + (bound & ~1)) | (distance_ik & bound & 1);
+		}
+
+		void
+		relax_row_scalar(DBM_Bound *row_i, const DBM_Bound *row_k, DBM_Bound distance_ik, std::size_t n)
+		{
+			for(std::size_t j = 0; j < n; j++) {
+				DBM_Bound new_distance = add_finite(distance_ik, row_k[j]);
+
+				if(new_distance < row_i[j]) {
+					row_i[j] = new_distance;
+				}
+			}
+		}
+
+		bool
+		is_less_equal_scalar(const DBM_Bound *lhs, const DBM_Bound *rhs, std::size_t n)
+		{
+			for(std::size_t j = 0; j < n; j++) {
+				if(lhs[j] > rhs[j]) {
+					return false;
+				}
+			}
+
+			return true;
+		}
+
+		void
+		normalize_scalar(DBM_Bound *bounds, std::size_t n, DBM_Bound upper_limit, DBM_Bound lower_limit)
+		{
+			for(std::size_t j = 0; j < n; j++) {
+				if(bounds[j] > upper_limit) {
+					bounds[j] = DBM_BOUND_INFINITY;
+				} else if(bounds[j] < lower_limit) {
+					bounds[j] = lower_limit;
+				}
+			}
+		}
+
+#ifdef TACOS_DBM_KERNELS_X86
+		//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+		// SSE2, 4 BOUNDS AT ONCE
+		//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+		//SSE2 has neither a signed 32 bit min/max nor a blend, so both are done with a compare mask
+		__attribute__((target("sse2"))) inline __m128i
+		select_sse2(__m128i mask, __m128i if_set, __m128i if_unset)
+		{
+			return _mm_or_si128(_mm_and_si128(mask, if_set), _mm_andnot_si128(mask, if_unset));
+		}
+
+		__attribute__((target("sse2"))) void
+		relax_row_sse2(DBM_Bound *row_i, const DBM_Bound *row_k, DBM_Bound distance_ik, std::size_t n)
+		{
+			const __m128i infinity   = _mm_set1_epi32(DBM_BOUND_INFINITY);
+			const __m128i value_mask = _mm_set1_epi32(~1);
+			const __m128i ik         = _mm_set1_epi32(distance_ik & ~1);
+			const __m128i ik_strict  = _mm_set1_epi32(distance_ik & 1);
+
+			std::size_t j = 0;
+			for(; j + 4 <= n; j += 4) {
+				__m128i kj = _mm_loadu_si128(reinterpret_cast<const __m128i *>(row_k + j));
+				__m128i ij = _mm_loadu_si128(reinterpret_cast<const __m128i *>(row_i + j));
+
+				__m128i sum = _mm_or_si128(_mm_add_epi32(ik, _mm_and_si128(kj, value_mask)), _mm_and_si128(ik_strict, kj));
+				sum = select_sse2(_mm_cmpeq_epi32(kj, infinity), infinity, sum);
+
+				ij = select_sse2(_mm_cmpgt_epi32(ij, sum), sum, ij);
+				_mm_storeu_si128(reinterpret_cast<__m128i *>(row_i + j), ij);
+			}
+
+			relax_row_scalar(row_i + j, row_k + j, distance_ik, n - j);
+		}
+
+		__attribute__((target("sse2"))) bool
+		is_less_equal_sse2(const DBM_Bound *lhs, const DBM_Bound *rhs, std::size_t n)
+		{
+			std::size_t j = 0;
+			for(; j + 4 <= n; j += 4) {
+				__m128i l = _mm_loadu_si128(reinterpret_cast<const __m128i *>(lhs + j));
+				__m128i r = _mm_loadu_si128(reinterpret_cast<const __m128i *>(rhs + j));
+
+				if(_mm_movemask_epi8(_mm_cmpgt_epi32(l, r)) != 0) {
+					return false;
+				}
+			}
+
+			return is_less_equal_scalar(lhs + j, rhs + j, n - j);
+		}
+
+		__attribute__((target("sse2"))) void
+		normalize_sse2(DBM_Bound *bounds, std::size_t n, DBM_Bound upper_limit, DBM_Bound lower_limit)
+		{
+			const __m128i infinity = _mm_set1_epi32(DBM_BOUND_INFINITY);
+			const __m128i upper    = _mm_set1_epi32(upper_limit);
+			const __m128i lower    = _mm_set1_epi32(lower_limit);
+
+			std::size_t j = 0;
+			for(; j + 4 <= n; j += 4) {
+				__m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(bounds + j));
+
+				b = select_sse2(_mm_cmpgt_epi32(b, upper), infinity, b);
+				b = select_sse2(_mm_cmpgt_epi32(lower, b), lower, b);
+				_mm_storeu_si128(reinterpret_cast<__m128i *>(bounds + j), b);
+			}
+
+			normalize_scalar(bounds + j, n - j, upper_limit, lower_limit);
+		}
+
+		//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+		// AVX2, 8 BOUNDS AT ONCE
+		//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+		__attribute__((target("avx2"))) void
+		relax_row_avx2(DBM_Bound *row_i, const DBM_Bound *row_k, DBM_Bound distance_ik, std::size_t n)
+		{
+			const __m256i infinity   = _mm256_set1_epi32(DBM_BOUND_INFINITY);
+			const __m256i value_mask = _mm256_set1_epi32(~1);
+			const __m256i ik         = _mm256_set1_epi32(distance_ik & ~1);
+			const __m256i ik_strict  = _mm256_set1_epi32(distance_ik & 1);
+
+			std::size_t j = 0;
+			for(; j + 8 <= n; j += 8) {
+				__m256i kj = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(row_k + j));
+				__m256i ij = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(row_i + j));
+
+				__m256i sum = _mm256_or_si256(_mm256_add_epi32(ik, _mm256_and_si256(kj, value_mask)),
+				                              _mm256_and_si256(ik_strict, kj));
+				sum = _mm256_blendv_epi8(sum, infinity, _mm256_cmpeq_epi32(kj, infinity));
+
+				_mm256_storeu_si256(reinterpret_cast<__m256i *>(row_i + j), _mm256_min_epi32(ij, sum));
+			}
+
+			relax_row_scalar(row_i + j, row_k + j, distance_ik, n - j);
+		}
+
+		__attribute__((target("avx2"))) bool
+		is_less_equal_avx2(const DBM_Bound *lhs, const DBM_Bound *rhs, std::size_t n)
+		{
+			std::size_t j = 0;
+			for(; j + 8 <= n; j += 8) {
+				__m256i l = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(lhs + j));
+				__m256i r = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(rhs + j));
+
+				if(!_mm256_testz_si256(_mm256_cmpgt_epi32(l, r), _mm256_cmpgt_epi32(l, r))) {
+					return false;
+				}
+			}
+
+			return is_less_equal_scalar(lhs + j, rhs + j, n - j);
+		}
+
+		__attribute__((target("avx2"))) void
+		normalize_avx2(DBM_Bound *bounds, std::size_t n, DBM_Bound upper_limit, DBM_Bound lower_limit)
+		{
+			const __m256i infinity = _mm256_set1_epi32(DBM_BOUND_INFINITY);
+			const __m256i upper    = _mm256_set1_epi32(upper_limit);
+			const __m256i lower    = _mm256_set1_epi32(lower_limit);
+
+			std::size_t j = 0;
+			for(; j + 8 <= n; j += 8) {
+				__m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(bounds + j));
+
+				b = _mm256_blendv_epi8(b, infinity, _mm256_cmpgt_epi32(b, upper));
+				b = _mm256_max_epi32(b, lower);
+				_mm256_storeu_si256(reinterpret_cast<__m256i *>(bounds + j), b);
+			}
+
+			normalize_scalar(bounds + j, n - j, upper_limit, lower_limit);
+		}
+#endif
+
+		const DBM_Kernels scalar_kernels{relax_row_scalar, is_less_equal_scalar, normalize_scalar};
+#ifdef TACOS_DBM_KERNELS_X86
+		const DBM_Kernels sse2_kernels{relax_row_sse2, is_less_equal_sse2, normalize_sse2};
+		const DBM_Kernels avx2_kernels{relax_row_avx2, is_less_equal_avx2, normalize_avx2};
+#endif
+
+	} // namespace
+
+	bool
+	is_supported(InstructionSet instruction_set)
+	{
+		switch(instruction_set) {
+		case InstructionSet::SCALAR:
+			return true;
+#ifdef TACOS_DBM_KERNELS_X86
+		case InstructionSet::SSE2:
+			return __builtin_cpu_supports("sse2");
+		case InstructionSet::AVX2:
+			return __builtin_cpu_supports("avx2");
+#endif
+		default:
+			return false;
+		}
+	}
+
+	InstructionSet
+	get_best_instruction_set()
+	{
+		static const InstructionSet best = [] {
+			for(InstructionSet instruction_set : {InstructionSet::AVX2, InstructionSet::SSE2}) {
+				if(is_supported(instruction_set)) {
+					return instruction_set;
+				}
+			}
+
+			return InstructionSet::SCALAR;
+		}();
+
+		return best;
+	}
+
+	const DBM_Kernels &
+	get_dbm_kernels(InstructionSet instruction_set)
+	{
+		assert(is_supported(instruction_set));
+
+		switch(instruction_set) {
+#ifdef TACOS_DBM_KERNELS_X86
+		case InstructionSet::SSE2:
+			return sse2_kernels;
+		case InstructionSet::AVX2:
+			return avx2_kernels;
+#endif
+		default:
+			return scalar_kernels;
+		}
+	}
+
+	const DBM_Kernels &
+	get_dbm_kernels()
+	{
+		static const DBM_Kernels &best = get_dbm_kernels(get_best_instruction_set());
+
+		return best;
+	}
+
+} // namespace tacos::zones
@@ -11,12 +11,16 @@
 
 #include "ata_formula.h"
 #include "automata.h"
+#include "utilities/hash.h"
 
 #include <fmt/ostream.h>
 
 #include <experimental/iterator>
+#include <map>
 #include <stdexcept>
 #include <string>
+#include <type_traits>
+#include <unordered_map>
 #include <vector>
 
 /// Alternating timed automata
@@ -153,6 +157,20 @@ public:
 		return formula_->get_clock_constraints();
 	}
 
+	/** Gets the target locations of this transition that keep the clock of the source location */
+	std::set<LocationT>
+	get_unreset_locations() const
+	{
+		return formula_->get_unreset_locations();
+	}
+
+	/** Gets all target locations of this transition */
+	std::set<LocationT>
+	get_target_locations() const
+	{
+		return formula_->get_locations();
+	}
+
 	/** Gets the symbol to take this transition */
 	SymbolT
 	get_symbol() const {
@@ -204,6 +222,16 @@ public:
 	                          std::set<Transition<LocationT, SymbolT>> transitions,
 	                          std::optional<LocationT>                 sink_location = std::nullopt);
 
+	/** The transitions can't be copied, see Transition. */
+	AlternatingTimedAutomaton(const AlternatingTimedAutomaton &) = delete;
+
+	/** Move constructor. The transition index points into the transitions, so it is rebuilt for the moved
+	 * transitions. */
+	AlternatingTimedAutomaton(AlternatingTimedAutomaton &&other);
+
+	AlternatingTimedAutomaton &operator=(const AlternatingTimedAutomaton &) = delete;
+	AlternatingTimedAutomaton &operator=(AlternatingTimedAutomaton &&)      = delete;
+
 	/** Get the initial configuration.
 	 * @return The initial configuration of the automaton.
 	 */
@@ -222,6 +250,15 @@ public:
 		return transitions_;
 	}
 
+	/** Get the transition that is taken when reading a symbol in a location.
+	 * The transitions are indexed on construction, so this does not search all transitions.
+	 * @param source The source location of the transition
+	 * @param symbol The symbol to read
+	 * @return The transition, or nullptr if there is none
+	 */
+	[[nodiscard]] const Transition<LocationT, SymbolT> *
+	get_transition(const LocationT &source, const SymbolT &symbol) const;
+
 	const std::optional<LocationT> &
 	get_sink_location() const
 	{
@@ -306,6 +343,17 @@ public:
 		return ret;
 	}
 
+	/** Get all locations whose clock may be read before it is reset. These are the locations with a transition that
+	 * has a clock constraint or that leads to an active location without resetting the clock. The clock valuations of
+	 * all other locations never matter.
+	 */
+	std::set<LocationT> get_active_locations() const;
+
+	/** Get all locations of the automaton, i.e., the initial location, the sink location, and the sources and targets
+	 * of all transitions.
+	 */
+	std::set<LocationT> get_locations() const;
+
 	/**
 	 * Get a multimap of all clock constraints from a specific configuration
 	 */
@@ -332,11 +380,23 @@ private:
 	std::set<std::set<State<LocationT>>> get_minimal_models(Formula<LocationT> *formula,
 	                                                        ClockValuation      v) const;
 
+	/** Build the transition index from the transitions. */
+	void index_transitions();
+
 	const std::set<SymbolT>                        alphabet_;
 	const LocationT                                initial_location_;
 	const std::set<LocationT>                      final_locations_;
-	const std::set<Transition<LocationT, SymbolT>> transitions_;
-	const std::optional<LocationT>                 sink_location_;
+	/** A hash map if the keys are hashable, otherwise an ordered map */
+	template <typename Key, typename Value>
+	using IndexMap = std::conditional_t<utilities::is_hashable_v<Key>,
+	                                    std::unordered_map<Key, Value>,
+	                                    std::map<Key, Value>>;
+
+	/** Not const, so it can be moved, see the move constructor */
+	std::set<Transition<LocationT, SymbolT>> transitions_;
+	const std::optional<LocationT>           sink_location_;
+	/** The transitions by their source location and symbol, see get_transition(). This points into transitions_. */
+	IndexMap<LocationT, IndexMap<SymbolT, const Transition<LocationT, SymbolT> *>> transition_index_;
 };
 
 } // namespace tacos::automata::ata
@@ -144,6 +144,46 @@ AlternatingTimedAutomaton<LocationT, SymbolT>::AlternatingTimedAutomaton(
 			}
 		}
 	}
+	index_transitions();
+}
+
+template <typename LocationT, typename SymbolT>
+AlternatingTimedAutomaton<LocationT, SymbolT>::AlternatingTimedAutomaton(AlternatingTimedAutomaton &&other)
+: alphabet_(other.alphabet_),
+  initial_location_(other.initial_location_),
+  final_locations_(other.final_locations_),
+  transitions_(std::move(other.transitions_)),
+  sink_location_(other.sink_location_)
+{
+	index_transitions();
+	other.transition_index_.clear();
+}
+
+template <typename LocationT, typename SymbolT>
+void
+AlternatingTimedAutomaton<LocationT, SymbolT>::index_transitions()
+{
+	transition_index_.clear();
+	// If there are several transitions for the same location and symbol, the first one is taken.
+	for (const auto &transition : transitions_) {
+		transition_index_[transition.source_].emplace(transition.symbol_, &transition);
+	}
+}
+
+template <typename LocationT, typename SymbolT>
+const Transition<LocationT, SymbolT> *
+AlternatingTimedAutomaton<LocationT, SymbolT>::get_transition(const LocationT &source,
+                                                              const SymbolT   &symbol) const
+{
+	const auto transitions = transition_index_.find(source);
+	if (transitions == transition_index_.end()) {
+		return nullptr;
+	}
+	const auto transition = transitions->second.find(symbol);
+	if (transition == transitions->second.end()) {
+		return nullptr;
+	}
+	return transition->second;
 }
 
 template <typename LocationT, typename SymbolT>
@@ -179,10 +219,8 @@ AlternatingTimedAutomaton<LocationT, SymbolT>::make_symbol_step_with_constraints
 		models = {{{}}};
 	}
 	for (const auto &state : start_states) {
-		auto t = std::find_if(transitions_.cbegin(), transitions_.cend(), [&](const auto &t) {
-			return t.source_ == state.location && t.symbol_ == symbol;
-		});
-		if (t == transitions_.end()) {
+		const auto *t = get_transition(state.location, symbol);
+		if (t == nullptr) {
 			continue;
 		}
 		const auto new_states = get_minimal_models(t->formula_.get(), state.clock_valuation);
@@ -347,6 +385,55 @@ AlternatingTimedAutomaton<LocationT, SymbolT>::accepts_word(const TimedATAWord<S
 	});
 }
 
+template <typename LocationT, typename SymbolT>
+std::set<LocationT>
+AlternatingTimedAutomaton<LocationT, SymbolT>::get_active_locations() const
+{
+	std::set<LocationT> active;
+	for (const auto &transition : transitions_) {
+		if (!transition.get_clock_constraints().empty()) {
+			active.insert(transition.source_);
+		}
+	}
+
+	// Propagate backwards until the fixed point is reached.
+	bool changed = true;
+	while (changed) {
+		changed = false;
+		for (const auto &transition : transitions_) {
+			if (active.count(transition.source_) > 0) {
+				continue;
+			}
+			const auto targets = transition.get_unreset_locations();
+			if (std::any_of(targets.begin(), targets.end(), [&active](const auto &target) {
+				    return active.count(target) > 0;
+			    })) {
+				active.insert(transition.source_);
+				changed = true;
+			}
+		}
+	}
+
+	return active;
+}
+
+template <typename LocationT, typename SymbolT>
+std::set<LocationT>
+AlternatingTimedAutomaton<LocationT, SymbolT>::get_locations() const
+{
+	std::set<LocationT> locations{initial_location_};
+	if (sink_location_) {
+		locations.insert(*sink_location_);
+	}
+	for (const auto &transition : transitions_) {
+		locations.insert(transition.source_);
+		const auto targets = transition.get_target_locations();
+		locations.insert(targets.begin(), targets.end());
+	}
+
+	return locations;
+}
+
 template <typename LocationT, typename SymbolT>
 std::set<std::set<State<LocationT>>>
 AlternatingTimedAutomaton<LocationT, SymbolT>::get_minimal_models(Formula<LocationT> *formula,
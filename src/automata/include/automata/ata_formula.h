@@ -189,6 +189,14 @@ public:
 
 	virtual std::set<automata::ClockConstraint> get_clock_constraints() const = 0;
 
+	/** Get the locations of this formula whose clocks are not reset, i.e. which continue with the clock of the source
+	 * location of a transition.
+	 */
+	virtual std::set<LocationT> get_unreset_locations() const = 0;
+
+	/** Get all locations of this formula, including those whose clocks are reset. */
+	virtual std::set<LocationT> get_locations() const = 0;
+
 protected:
 	/** A virtual method to print a Formula to an ostream. We cannot just use
 	 * operator<<, as the operator cannot be virtual. The function needs to be
@@ -209,6 +217,8 @@ public:
 	std::set<std::set<State<LocationT>>> get_minimal_models(const ClockValuation &) const override;
 	std::set<std::set<ZoneState<LocationT>>> get_minimal_models(const zones::Zone_slice &) const override;
 	std::set<automata::ClockConstraint> get_clock_constraints() const override;
+	std::set<LocationT> get_unreset_locations() const override;
+	std::set<LocationT> get_locations() const override;
 
 protected:
 	/** Print a TrueFormula to an ostream
@@ -227,6 +237,8 @@ public:
 	std::set<std::set<State<LocationT>>> get_minimal_models(const ClockValuation &) const override;
 	std::set<std::set<ZoneState<LocationT>>> get_minimal_models(const zones::Zone_slice &) const override;
 	std::set<automata::ClockConstraint> get_clock_constraints() const override;
+	std::set<LocationT> get_unreset_locations() const override;
+	std::set<LocationT> get_locations() const override;
 
 protected:
 	/** Print a FalseFormula to an ostream
@@ -253,6 +265,8 @@ public:
 	std::set<std::set<State<LocationT>>> get_minimal_models(const ClockValuation &v) const override;
 	std::set<std::set<ZoneState<LocationT>>> get_minimal_models(const zones::Zone_slice &z) const override;
 	std::set<automata::ClockConstraint> get_clock_constraints() const override;
+	std::set<LocationT> get_unreset_locations() const override;
+	std::set<LocationT> get_locations() const override;
 
 protected:
 	/** Print a LocationFormula to an ostream
@@ -284,6 +298,8 @@ public:
 	std::set<std::set<State<LocationT>>> get_minimal_models(const ClockValuation &v) const override;
 	std::set<std::set<ZoneState<LocationT>>> get_minimal_models(const zones::Zone_slice &z) const override;
 	std::set<automata::ClockConstraint> get_clock_constraints() const override;
+	std::set<LocationT> get_unreset_locations() const override;
+	std::set<LocationT> get_locations() const override;
 
 protected:
 	/** Print a ClockConstraintFormula to an ostream
@@ -320,6 +336,8 @@ public:
 	std::set<std::set<State<LocationT>>> get_minimal_models(const ClockValuation &v) const override;
 	std::set<std::set<ZoneState<LocationT>>> get_minimal_models(const zones::Zone_slice &z) const override;
 	std::set<automata::ClockConstraint> get_clock_constraints() const override;
+	std::set<LocationT> get_unreset_locations() const override;
+	std::set<LocationT> get_locations() const override;
 
 protected:
 	/** Print a ConjunctionFormula to an ostream
@@ -356,6 +374,8 @@ public:
 	std::set<std::set<State<LocationT>>> get_minimal_models(const ClockValuation &v) const override;
 	std::set<std::set<ZoneState<LocationT>>> get_minimal_models(const zones::Zone_slice &z) const override;
 	std::set<automata::ClockConstraint> get_clock_constraints() const override;
+	std::set<LocationT> get_unreset_locations() const override;
+	std::set<LocationT> get_locations() const override;
 
 protected:
 	/** Print a DisjunctionFormula to an ostream
@@ -389,6 +409,8 @@ public:
 	std::set<std::set<State<LocationT>>> get_minimal_models(const ClockValuation &) const override;
 	std::set<std::set<ZoneState<LocationT>>> get_minimal_models(const zones::Zone_slice &z) const override;
 	std::set<automata::ClockConstraint> get_clock_constraints() const override;
+	std::set<LocationT> get_unreset_locations() const override;
+	std::set<LocationT> get_locations() const override;
 
 protected:
 	/** Print a ResetClockFormula to an ostream
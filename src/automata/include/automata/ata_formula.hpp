@@ -86,6 +86,20 @@ TrueFormula<LocationT>::get_clock_constraints() const
 	return {};
 }
 
+template <typename LocationT>
+std::set<LocationT>
+TrueFormula<LocationT>::get_unreset_locations() const
+{
+	return {};
+}
+
+template <typename LocationT>
+std::set<LocationT>
+TrueFormula<LocationT>::get_locations() const
+{
+	return {};
+}
+
 template <typename LocationT>
 bool
 FalseFormula<LocationT>::is_satisfied(const std::set<State<LocationT>> &,
@@ -130,6 +144,20 @@ FalseFormula<LocationT>::get_clock_constraints() const
 	return {};
 }
 
+template <typename LocationT>
+std::set<LocationT>
+FalseFormula<LocationT>::get_unreset_locations() const
+{
+	return {};
+}
+
+template <typename LocationT>
+std::set<LocationT>
+FalseFormula<LocationT>::get_locations() const
+{
+	return {};
+}
+
 template <typename LocationT>
 bool
 LocationFormula<LocationT>::is_satisfied(const std::set<State<LocationT>> &states,
@@ -183,6 +211,20 @@ LocationFormula<LocationT>::get_clock_constraints() const
 	return {};
 }
 
+template <typename LocationT>
+std::set<LocationT>
+LocationFormula<LocationT>::get_unreset_locations() const
+{
+	return {location_};
+}
+
+template <typename LocationT>
+std::set<LocationT>
+LocationFormula<LocationT>::get_locations() const
+{
+	return {location_};
+}
+
 template <typename LocationT>
 bool
 ClockConstraintFormula<LocationT>::is_satisfied(const std::set<State<LocationT>> &,
@@ -235,6 +277,20 @@ ClockConstraintFormula<LocationT>::get_clock_constraints() const
 	return {constraint_};
 }
 
+template <typename LocationT>
+std::set<LocationT>
+ClockConstraintFormula<LocationT>::get_unreset_locations() const
+{
+	return {};
+}
+
+template <typename LocationT>
+std::set<LocationT>
+ClockConstraintFormula<LocationT>::get_locations() const
+{
+	return {};
+}
+
 template <typename LocationT>
 bool
 ConjunctionFormula<LocationT>::is_satisfied(const std::set<State<LocationT>> &states,
@@ -304,6 +360,28 @@ ConjunctionFormula<LocationT>::get_clock_constraints() const
 	return ret;
 }
 
+template <typename LocationT>
+std::set<LocationT>
+ConjunctionFormula<LocationT>::get_unreset_locations() const
+{
+	std::set<LocationT> ret = conjunct1_->get_unreset_locations();
+	std::set<LocationT> s2  = conjunct2_->get_unreset_locations();
+	ret.insert(s2.begin(), s2.end());
+
+	return ret;
+}
+
+template <typename LocationT>
+std::set<LocationT>
+ConjunctionFormula<LocationT>::get_locations() const
+{
+	std::set<LocationT> ret = conjunct1_->get_locations();
+	std::set<LocationT> s2  = conjunct2_->get_locations();
+	ret.insert(s2.begin(), s2.end());
+
+	return ret;
+}
+
 template <typename LocationT>
 bool
 DisjunctionFormula<LocationT>::is_satisfied(const std::set<State<LocationT>> &states,
@@ -415,6 +493,28 @@ DisjunctionFormula<LocationT>::get_clock_constraints() const
 	return ret;
 }
 
+template <typename LocationT>
+std::set<LocationT>
+DisjunctionFormula<LocationT>::get_unreset_locations() const
+{
+	std::set<LocationT> ret = disjunct1_->get_unreset_locations();
+	std::set<LocationT> s2  = disjunct2_->get_unreset_locations();
+	ret.insert(s2.begin(), s2.end());
+
+	return ret;
+}
+
+template <typename LocationT>
+std::set<LocationT>
+DisjunctionFormula<LocationT>::get_locations() const
+{
+	std::set<LocationT> ret = disjunct1_->get_locations();
+	std::set<LocationT> s2  = disjunct2_->get_locations();
+	ret.insert(s2.begin(), s2.end());
+
+	return ret;
+}
+
 template <typename LocationT>
 bool
 ResetClockFormula<LocationT>::is_satisfied(const std::set<State<LocationT>> &states,
@@ -459,6 +559,21 @@ ResetClockFormula<LocationT>::get_clock_constraints() const
 	return sub_formula_->get_clock_constraints();
 }
 
+template <typename LocationT>
+std::set<LocationT>
+ResetClockFormula<LocationT>::get_unreset_locations() const
+{
+	//All locations of the sub-formula start with a reset clock
+	return {};
+}
+
+template <typename LocationT>
+std::set<LocationT>
+ResetClockFormula<LocationT>::get_locations() const
+{
+	return sub_formula_->get_locations();
+}
+
 template <typename LocationT>
 bool
 operator<(const Formula<LocationT> &first, const Formula<LocationT> &second)
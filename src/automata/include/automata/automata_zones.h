@@ -1,20 +1,33 @@
 #ifndef SRC_AUTOMATA_INCLUDE_AUTOMATA_AUTOMATA_ZONES_H
 #define SRC_AUTOMATA_INCLUDE_AUTOMATA_AUTOMATA_ZONES_H
 
+#include "utilities/hash.h"
 #include "utilities/types.h"
 
 #include "automata.h"
+#include "dbm_kernels.h"
 #include "ta.h"
 
 //TODO: I have no idea which of these libraries are needed for formatting
 #include <boost/format.hpp>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <deque>
 #include <functional>
 #include <iostream>
 #include <map>
+#include <memory>
 #include <optional>
 #include <set>
+#include <shared_mutex>
 #include <stdexcept>
 #include <string>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
 #include <utility>
 #include <variant>
 #include <vector>
@@ -272,7 +285,48 @@ namespace tacos::zones {
 		}
 	};
 
-	/** Entry within the Adjacency Matrix, i.e. this is the type for the edge weights */
+	/** Encoding of (0, <), anything smaller than this on the diagonal is a negative cycle */
+	constexpr DBM_Bound DBM_BOUND_LT_ZERO = 0;
+
+	/** Encoding of (0, <=) */
+	constexpr DBM_Bound DBM_BOUND_LE_ZERO = 1;
+
+	/** Packs a finite bound */
+	constexpr DBM_Bound
+	make_bound(int value, bool non_strict)
+	{
+		return value * 2 + (non_strict ? 1 : 0);
+	}
+
+	/** Returns the value of a finite packed bound */
+	constexpr int
+	get_bound_value(DBM_Bound bound)
+	{
+		return (bound - (bound & 1)) / 2;
+	}
+
+	/** Returns true iff the packed bound is non-strict, i.e. <= */
+	constexpr bool
+	is_bound_non_strict(DBM_Bound bound)
+	{
+		return (bound & 1) != 0;
+	}
+
+	/** Adds two packed bounds. Same semantics as DBM_Entry::operator+, infinity absorbs everything */
+	constexpr DBM_Bound
+	add_bounds(DBM_Bound b1, DBM_Bound b2)
+	{
+		if(b1 == DBM_BOUND_INFINITY || b2 == DBM_BOUND_INFINITY) {
+			return DBM_BOUND_INFINITY;
+		}
+
+		return ((b1 & ~1) + (b2 & ~1)) | (b1 & b2 & 1);
+	}
+
+	/** Entry within the Adjacency Matrix, i.e. this is the type for the edge weights.
+	 *
+	 * The matrix itself stores packed DBM_Bounds, this is the unpacked form handed out to users of Zone_DBM.
+	 */
 	struct DBM_Entry
 	{
 		bool infinity_; //Whether this entry is supposed to be infinity. If this is true, the rest is essentially ignored
@@ -291,6 +345,28 @@ namespace tacos::zones {
 			// :)
 		}
 
+		/** Unpacks a DBM_Bound */
+		static DBM_Entry
+		from_bound(DBM_Bound bound)
+		{
+			if(bound == DBM_BOUND_INFINITY) {
+				return DBM_Entry{true, 0, false};
+			}
+
+			return DBM_Entry{get_bound_value(bound), is_bound_non_strict(bound)};
+		}
+
+		/** Packs this entry into a single DBM_Bound */
+		DBM_Bound
+		to_bound() const
+		{
+			if(infinity_) {
+				return DBM_BOUND_INFINITY;
+			}
+
+			return make_bound(value_, non_strict_);
+		}
+
 		/** Adds another Entry to this entry 
 		 * 
 		 * Adding infinity will always result in infinity.
@@ -375,10 +451,275 @@ namespace tacos::zones {
 		}
 	};
 
+	/** Dense integer identifier of a clock, handed out by a ClockRegistry */
+	using ClockID = std::uint32_t;
+
+	/** Reserved ID of the implicit zero clock. It is never handed out by a ClockRegistry */
+	constexpr ClockID ZERO_CLOCK_ID = std::numeric_limits<ClockID>::max();
+
+	/** Interns clock names to dense integer IDs.
+	 * 
+	 * Each name is assigned an ID once, after which DBMs only work with the ID, so clock lookups are integer comparisons
+	 * instead of string comparisons. IDs are never reused and names stay valid for the lifetime of the registry.
+	 * The registry may be shared between threads.
+	 */
+	class ClockRegistry
+	{
+		public:
+		/** Get the ID of this clock, assigning a new one if the clock has not been seen yet */
+		ClockID get_id(const std::string &clock_name);
+
+		/** Get the ID of this clock if it was already registered */
+		std::optional<ClockID> find_id(const std::string &clock_name) const;
+
+		/** Get the name of a registered clock */
+		const std::string &get_name(ClockID id) const;
+
+		/** Get the hash of the name of a registered clock. Unlike the ID, it doesn't depend on the registry or on the order
+		 * in which the clocks were registered.
+		 */
+		std::size_t get_name_hash(ClockID id) const;
+
+		/** Returns the amount of registered clocks */
+		std::size_t size() const;
+
+		/** The registry that is used by DBMs which weren't given one explicitly. */
+		static std::shared_ptr<ClockRegistry> get_default();
+
+		private:
+		mutable std::shared_mutex mutex_;
+		std::map<std::string, ClockID> ids_;
+		//deque, so that references to names stay valid when new clocks are registered
+		std::deque<std::string> names_;
+		//Indexed by ID like names_
+		std::deque<std::size_t> name_hashes_;
+	};
+
+	/** The maximal lower and upper bound constants per clock, used for LU extrapolation.
+	 *
+	 * The lower bound L(x) is the largest constant c in a constraint x > c or x >= c, the upper bound U(x) is the largest
+	 * constant c in a constraint x < c or x <= c. Equalities count for both.
+	 * Clocks without own bounds use the default bounds, e.g. all ATA clocks share the bounds of the ATA constraints.
+	 * Clocks that never occur in a constraint have bounds 0, so only x = 0 and x > 0 are distinguished.
+	 */
+	class ClockBounds
+	{
+		public:
+		/** Make sure this clock has its own bounds, starting at 0 */
+		void add_clock(ClockID clock);
+
+		/** Raise the bounds of this clock so that they cover the constant of the clock constraint */
+		void add_constraint(ClockID clock, const automata::ClockConstraint &clock_constraint);
+
+		/** Raise the default bounds so that they cover the constant of the clock constraint */
+		void add_default_constraint(const automata::ClockConstraint &clock_constraint);
+
+		/** Get L(x) */
+		Endpoint get_lower_bound(ClockID clock) const;
+
+		/** Get U(x) */
+		Endpoint get_upper_bound(ClockID clock) const;
+
+		private:
+		struct Bounds
+		{
+			Endpoint lower = 0;
+			Endpoint upper = 0;
+		};
+
+		static void add_constraint(Bounds &bounds, const automata::ClockConstraint &clock_constraint);
+
+		const Bounds &get_bounds(ClockID clock) const;
+
+		//Indexed by clock ID, since IDs are dense
+		std::vector<std::optional<Bounds>> bounds_;
+		Bounds default_bounds_;
+	};
+
+	/** The amount of vertices up to which the matrix of a DBM is stored inline, i.e. up to 8 clocks and the zero clock.
+	 * Most models do not have more clocks than that, counting the ATA locations.
+	 */
+	constexpr std::size_t DBM_INLINE_DIMENSION = 9;
+
+	/** A dynamically sized array that keeps up to InlineCapacity elements inline, only larger arrays are on the heap.
+	 *
+	 * DBMs are copied for every successor, so their matrices and clocks are stored in such arrays, which costs no
+	 * allocations at all for models with few clocks.
+	 */
+	template <typename T, std::size_t InlineCapacity>
+	class Inline_Array
+	{
+		static_assert(std::is_trivially_copyable_v<T>);
+
+		public:
+		Inline_Array()
+		{
+
+		}
+
+		/** An array of size copies of value */
+		Inline_Array(std::size_t size, const T &value) : size_(size)
+		{
+			if(is_inline()) {
+				std::fill(inline_.begin(), inline_.begin() + size_, value);
+			} else {
+				heap_.assign(size_, value);
+			}
+		}
+
+		Inline_Array(const Inline_Array &other) : size_(other.size_), heap_(other.heap_)
+		{
+			copy_inline(other);
+		}
+
+		Inline_Array(Inline_Array &&other) noexcept : size_(other.size_), heap_(std::move(other.heap_))
+		{
+			copy_inline(other);
+			other.clear();
+		}
+
+		Inline_Array &
+		operator=(const Inline_Array &other)
+		{
+			if(this != &other) {
+				size_ = other.size_;
+				heap_ = other.heap_;
+				copy_inline(other);
+			}
+
+			return *this;
+		}
+
+		Inline_Array &
+		operator=(Inline_Array &&other) noexcept
+		{
+			if(this != &other) {
+				size_ = other.size_;
+				heap_ = std::move(other.heap_);
+				copy_inline(other);
+				other.clear();
+			}
+
+			return *this;
+		}
+
+		/** Returns true iff the elements are stored inline */
+		bool
+		is_inline() const
+		{
+			return size_ <= InlineCapacity;
+		}
+
+		std::size_t
+		size() const
+		{
+			return size_;
+		}
+
+		T *
+		data()
+		{
+			return is_inline() ? inline_.data() : heap_.data();
+		}
+
+		const T *
+		data() const
+		{
+			return is_inline() ? inline_.data() : heap_.data();
+		}
+
+		T *begin() { return data(); }
+		T *end() { return data() + size_; }
+		const T *begin() const { return data(); }
+		const T *end() const { return data() + size_; }
+
+		T &
+		operator[](std::size_t index)
+		{
+			assert(index < size_);
+			return data()[index];
+		}
+
+		const T &
+		operator[](std::size_t index) const
+		{
+			assert(index < size_);
+			return data()[index];
+		}
+
+		/** Appends an element, moving all elements to the heap once they don't fit inline anymore */
+		void
+		push_back(const T &value)
+		{
+			if(size_ < InlineCapacity) {
+				inline_[size_] = value;
+			} else {
+				if(size_ == InlineCapacity) {
+					heap_.assign(inline_.begin(), inline_.end());
+				}
+				heap_.push_back(value);
+			}
+			size_++;
+		}
+
+		/** Removes the element at this index, moving all elements back inline once they fit */
+		void
+		erase(std::size_t index)
+		{
+			assert(index < size_);
+
+			if(is_inline()) {
+				std::copy(inline_.begin() + index + 1, inline_.begin() + size_, inline_.begin() + index);
+			} else {
+				heap_.erase(heap_.begin() + index);
+				if(heap_.size() == InlineCapacity) {
+					std::copy(heap_.begin(), heap_.end(), inline_.begin());
+					heap_ = std::vector<T>{};
+				}
+			}
+			size_--;
+		}
+
+		friend bool
+		operator==(const Inline_Array &a1, const Inline_Array &a2)
+		{
+			return a1.size_ == a2.size_ && std::equal(a1.begin(), a1.end(), a2.begin());
+		}
+
+		friend bool
+		operator<(const Inline_Array &a1, const Inline_Array &a2)
+		{
+			return std::lexicographical_compare(a1.begin(), a1.end(), a2.begin(), a2.end());
+		}
+
+		private:
+		/** Only the used part of the inline storage is copied */
+		void
+		copy_inline(const Inline_Array &other)
+		{
+			if(is_inline()) {
+				std::copy(other.inline_.begin(), other.inline_.begin() + size_, inline_.begin());
+			}
+		}
+
+		void
+		clear()
+		{
+			size_ = 0;
+			heap_.clear();
+		}
+
+		std::size_t size_ = 0;
+		std::array<T, InlineCapacity> inline_;
+		std::vector<T> heap_;
+	};
+
 	/** Class for a weighted graph modelled as an Adjacency Matrix
 	 * 
-	 * Vertexes are clock names together with an extra vertex for the zero clock
-	 * Edge weights are DBM_Entries
+	 * Vertexes are clock IDs together with an extra vertex for the zero clock
+	 * Edge weights are packed DBM_Bounds
+	 * Graphs with up to DBM_INLINE_DIMENSION vertices are stored without any heap allocations, and their closure uses
+	 * loops that are unrolled for their exact dimension.
 	 */
 	class Graph
 	{
@@ -389,28 +730,78 @@ namespace tacos::zones {
 
 		}
 
-		/** Constructs a new Graph for this set of clocks. Each edge is labeled with infinity */
-		Graph(std::set<std::string> clocks) {
-			//TODO Verbose name to avoid collision, "temporary", although I don't know a better solution
-			clock_to_index.push_back("zero_clock_please_do_not_use_this_name_80798sand8sa7s8a7dms90amdsvxcy9x0cy90c");
-
-			//Assign each clock an index:
-			int k = 1;
-			for(const auto &clock : clocks) {
+		/** Constructs a new Graph for these clocks, in that order. Each edge except for the diagonal is labeled with infinity,
+		 * so the graph is already in canonical form.
+		 */
+		Graph(const std::vector<ClockID> &clocks) {
+			clock_to_index.push_back(ZERO_CLOCK_ID);
+			for(const ClockID clock : clocks) {
 				clock_to_index.push_back(clock);
-				k++;
 			}
 
-			matrix_ = Matrix(k);
+			matrix_ = Matrix(clock_to_index.size());
 
 			//Make consistent
-			get(0,0) = DBM_Entry{0, true};
+			for(std::size_t i = 0; i < size(); i++) {
+				get(i, i) = DBM_BOUND_LE_ZERO;
+			}
 		}
 
 		public:
 		/** Calculate shortest path from each vertex to each vertex and update the matrix accordingly */
 		void floyd_warshall();
 
+		/** Restores the canonical form after only edges between the given vertices have been tightened.
+		 * 
+		 * This runs the Floyd-Warshall iteration only for the given vertices as intermediate nodes, which is enough if
+		 * the graph was canonical before the edges were tightened. This costs O(k*n^2) for k vertices instead of O(n^3).
+		 * If a negative cycle is found, the graph is marked as inconsistent.
+		 * 
+		 * @param vertices Indices of all endpoints of tightened edges
+		 * @return True if the graph is still consistent
+		 */
+		bool close_over(const std::vector<std::size_t> &vertices);
+
+		/** Tightens the edge x->y to bound, if bound is smaller than the current edge. The canonical form is not restored.
+		 * 
+		 * @return True if the edge was changed
+		 */
+		bool
+		tighten(std::size_t x, std::size_t y, DBM_Bound bound)
+		{
+			if(bound < get(x, y)) {
+				get(x, y) = bound;
+				return true;
+			}
+
+			return false;
+		}
+
+		/** Makes the clock at new_index an exact copy of the clock at old_index, overwriting all constraints of the
+		 * former. The canonical form is preserved, so this only costs O(n).
+		 */
+		void copy_clock(std::size_t new_index, std::size_t old_index);
+
+		/** Marks this graph as inconsistent, see Zone_DBM::is_consistent() */
+		void
+		mark_inconsistent()
+		{
+			get(0, 0) = make_bound(-1, false);
+		}
+
+		/** Returns true iff some vertex has a negative distance to itself, i.e. the graph has a negative cycle */
+		bool
+		has_negative_diagonal() const
+		{
+			for(std::size_t i = 0; i < size(); i++) {
+				if(get_bound(i, i) < DBM_BOUND_LE_ZERO) {
+					return true;
+				}
+			}
+
+			return false;
+		}
+
 		/** Returns size of graph. The size is the amount of clocks including the implicit zero clock*/
 		std::size_t
 		size() const
@@ -418,27 +809,54 @@ namespace tacos::zones {
 			return matrix_.size();
 		}
 
-		/** Adds a new clock to this graph. This results in recalculating the Adjacency Matrix 
+		/** Adds a new, unbounded clock to this graph. The new vertex has no bounded edges, so the canonical form is preserved
 		 * 
 		 * @return True if clock successfully added
 		*/
-		bool add_clock(std::string clock_name);
+		bool add_clock(ClockID clock);
 
-		/** Unbinds a clock, setting everything in its row and column to infinity */
-		bool unbound_clock(std::string clock_name);
+		/** Unbinds a clock, setting everything in its row and column to infinity. No path can lead through an unbounded
+		 * vertex, so the canonical form is preserved and this only costs O(n)
+		 */
+		bool unbound_clock(ClockID clock);
 
-		/** Removes clock if it exists
+		/** Removes clock if it exists. Removing a vertex preserves the canonical form
 		 * 
 		 * @return True if clock successfully removed, false if clock didn't exist or something went wrong
 		 */
-		bool remove_clock(std::string clock_name);
+		bool remove_clock(ClockID clock);
 
 		/** Returns whether the given clock already exists in this DBM graph */
-		bool has_clock(std::string clock_name) const;
+		bool
+		has_clock(ClockID clock) const
+		{
+			return std::find(clock_to_index.begin(), clock_to_index.end(), clock) != clock_to_index.end();
+		}
+
+		/** Hash of the clocks and all bounds. The clocks are hashed by their names, so equal graphs with different
+		 * registries have the same hash.
+		 *
+		 * @param registry The registry the clock IDs of this graph belong to
+		 */
+		std::size_t hash(const ClockRegistry &registry) const;
+
+		/** Returns whether both graphs have the same clock IDs at the same indices. The IDs must be from the same registry */
+		bool
+		has_same_clocks(const Graph &other) const
+		{
+			return clock_to_index == other.clock_to_index;
+		}
+
+		/** Returns whether both graphs have the same matrix, regardless of their clocks */
+		bool
+		has_same_bounds(const Graph &other) const
+		{
+			return matrix_ == other.matrix_;
+		}
 
 		/** Get the index as which this clock is saved at */
 		std::size_t
-		get_index_of_clock(std::string clock) const
+		get_index_of_clock(ClockID clock) const
 		{
 			auto it = std::find(clock_to_index.begin(), clock_to_index.end(), clock);
 			assert(it != clock_to_index.end());
@@ -446,42 +864,76 @@ namespace tacos::zones {
 			return std::distance(clock_to_index.begin(), it);
 		}
 
+		/** Get the clock saved at this index */
+		ClockID
+		get_clock_at(std::size_t index) const
+		{
+			return clock_to_index[index];
+		}
+
 		/** Returns a vector of all clocks except for the zero clock */
-		std::vector<std::string> get_clocks() const;
+		std::vector<ClockID> get_clocks() const;
 
-		/** Get the DBM_Entry at these indices */
-		DBM_Entry& get(std::size_t x, std::size_t y)
+		/** Get the packed bound at these indices */
+		DBM_Bound& get(std::size_t x, std::size_t y)
 		{
 			return matrix_(x, y);
 		}
 
-		/** Get the DBM_Entry of these clocks */
-		DBM_Entry& get(std::string clock1, std::string clock2)
+		/** Get the packed bound as a value at these indices */
+		DBM_Bound get_bound(std::size_t x, std::size_t y) const
 		{
-			return matrix_(get_index_of_clock(clock1), get_index_of_clock(clock2));
+			return matrix_.get(x, y);
 		}
 
-		/** Get the DBM_Entry of this index and clock */
-		DBM_Entry& get(std::size_t x, std::string clock)
+		/** Get the DBM_Entry as a value at these indices (For constness, mostly testing) */
+		DBM_Entry get_value(std::size_t x, std::size_t y) const
 		{
-			return matrix_(x, get_index_of_clock(clock));
+			return DBM_Entry::from_bound(matrix_.get(x, y));
 		}
 
-		/** Get the DBM_Entry of this clock and index */
-		DBM_Entry& get(std::string clock, std::size_t y)
+		/** Get all size() * size() packed bounds in row-major order, e.g. to run a DBM kernel over the whole matrix */
+		DBM_Bound *
+		data()
 		{
-			return matrix_(get_index_of_clock(clock), y);
+			return matrix_.data();
 		}
 
-		/** Get the DBM_Entry as a value at these indices (For constness, mostly testing) */
-		DBM_Entry get_value(std::size_t x, std::size_t y) const
+		/** Get all size() * size() packed bounds in row-major order */
+		const DBM_Bound *
+		data() const
 		{
-			return matrix_.get(x, y);
+			return matrix_.data();
+		}
+
+		/** Compare only the matrices of two graphs, first by size and then lexicographically row by row */
+		bool
+		has_smaller_bounds(const Graph &other) const
+		{
+			return matrix_ < other.matrix_;
+		}
+
+		/** Compare two graphs by their clock IDs and then by their matrices, consistent with operator== */
+		friend bool
+		operator<(const Graph &g1, const Graph &g2)
+		{
+			return std::tie(g1.clock_to_index, g1.matrix_) < std::tie(g2.clock_to_index, g2.matrix_);
+		}
+
+		/** Check whether two graphs have the same clocks at the same indices and the same matrix. */
+		friend bool
+		operator==(const Graph &g1, const Graph &g2)
+		{
+			return g1.has_same_clocks(g2) && g1.matrix_ == g2.matrix_;
 		}
 
 		private:
 		//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~HELPING MATRIX~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-		/** Class of Matrix in which the graph is stored */
+		/** Class of Matrix in which the graph is stored.
+		 * 
+		 * The bounds are stored contiguously in row-major order, so a row is a single cache-friendly array and copying
+		 * a matrix is at most a single allocation.
+		 */
 		class Matrix
 		{
 			public:
@@ -491,39 +943,162 @@ namespace tacos::zones {
 
 			}
 
-			Matrix(std::size_t size)
+			Matrix(std::size_t size) : size_(size), m_(size * size, DBM_BOUND_INFINITY)
 			{
-				m_.resize(size, std::vector<DBM_Entry>(size, DBM_Entry{true, 0, false}));
+
 			}
 
-			DBM_Entry& operator()(std::size_t x, std::size_t y)
+			DBM_Bound& operator()(std::size_t x, std::size_t y)
 			{
-				return m_.at(x).at(y);
+				assert(x < size_ && y < size_);
+				return m_[x * size_ + y];
 			}
 
-			DBM_Entry get(std::size_t x, std::size_t y) const
+			DBM_Bound get(std::size_t x, std::size_t y) const
 			{
-				return m_.at(x).at(y);
+				assert(x < size_ && y < size_);
+				return m_[x * size_ + y];
+			}
+
+			/** Returns a pointer to all bounds */
+			const DBM_Bound *
+			data() const
+			{
+				return m_.data();
+			}
+
+			/** Returns a pointer to all bounds */
+			DBM_Bound *
+			data()
+			{
+				return m_.data();
+			}
+
+			/** Returns a pointer to the first bound of row x */
+			const DBM_Bound *
+			row(std::size_t x) const
+			{
+				assert(x < size_);
+				return m_.data() + x * size_;
+			}
+
+			/** Returns a pointer to the first bound of row x */
+			DBM_Bound *
+			row(std::size_t x)
+			{
+				assert(x < size_);
+				return m_.data() + x * size_;
 			}
 
 			/** Returns the size of this matrix */
 			std::size_t
 			size() const
 			{
-				return m_.size();
+				return size_;
+			}
+
+			friend bool
+			operator<(const Matrix &m1, const Matrix &m2)
+			{
+				return std::tie(m1.size_, m1.m_) < std::tie(m2.size_, m2.m_);
+			}
+
+			friend bool
+			operator==(const Matrix &m1, const Matrix &m2)
+			{
+				return m1.size_ == m2.size_ && m1.m_ == m2.m_;
 			}
 
 			private:
-			std::vector<std::vector<DBM_Entry>> m_;
+			std::size_t size_ = 0;
+			Inline_Array<DBM_Bound, DBM_INLINE_DIMENSION * DBM_INLINE_DIMENSION> m_;
 		};
 
 		//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~END MATRIX~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 
 		private:
 		Matrix matrix_;
-		std::vector<std::string> clock_to_index;
+		Inline_Array<ClockID, DBM_INLINE_DIMENSION> clock_to_index;
 	};
 
+	/** The minimal constraints of a canonical graph, i.e. its reduced difference constraint graph.
+	 *
+	 * Vertices with a zero cycle between them form an equivalence class, which is kept as a single cycle through its
+	 * members. Between the classes only the edges that are not implied by a path over a third class are kept. Closing
+	 * the kept edges gives back the canonical graph, and for a canonical graph the kept edges are unique, so this
+	 * usually needs far less memory than the size() * size() bounds of the full matrix.
+	 *
+	 * This follows the algorithm presented in:
+	 *
+	 * Larsen, K. G., Larsson, F., Pettersson, P., & Yi, W. (1997, December). Efficient verification of real-time
+	 * systems: compact data structure and state-space reduction. In Proceedings Real-Time Systems Symposium (pp. 14-24).
+	 */
+	class Reduced_DBM
+	{
+		public:
+		/** A kept edge x -> y, i.e. the constraint x - y <= bound */
+		struct Constraint
+		{
+			std::uint32_t x;
+			std::uint32_t y;
+			DBM_Bound bound;
+
+			friend bool
+			operator==(const Constraint &c1, const Constraint &c2)
+			{
+				return c1.x == c2.x && c1.y == c2.y && c1.bound == c2.bound;
+			}
+		};
+
+		/** Compute the minimal constraints of a canonical graph. This costs O(n^3) for n vertices */
+		explicit Reduced_DBM(const Graph &graph);
+
+		/** Rebuild the canonical graph by closing the kept edges */
+		Graph get_graph() const;
+
+		/** Returns false iff the graph was inconsistent, in which case no constraints are kept */
+		bool
+		is_consistent() const
+		{
+			return consistent_;
+		}
+
+		/** Returns the amount of vertices of the graph, including the zero clock */
+		std::size_t
+		size() const
+		{
+			return clocks_.size() + 1;
+		}
+
+		/** Returns all clocks except for the zero clock, in the order of their indices */
+		const std::vector<ClockID> &
+		get_clocks() const
+		{
+			return clocks_;
+		}
+
+		/** Returns the kept edges */
+		const std::vector<Constraint> &
+		get_constraints() const
+		{
+			return constraints_;
+		}
+
+		friend bool
+		operator==(const Reduced_DBM &r1, const Reduced_DBM &r2)
+		{
+			return r1.consistent_ == r2.consistent_ && r1.clocks_ == r2.clocks_ && r1.constraints_ == r2.constraints_;
+		}
+
+		private:
+		std::vector<ClockID> clocks_;
+		std::vector<Constraint> constraints_;
+		bool consistent_ = true;
+	};
+
+	class DBM_Pool;
+	class Federation;
+
 	/** Class for storing zones as a Difference Bound Matrix
 	 * 
 	 * This allows for the easy storing of differences between clocks, while also ensuring they stay consistent.
@@ -535,6 +1110,9 @@ namespace tacos::zones {
 	 */
 	class Zone_DBM
 	{
+		friend class DBM_Pool;
+		friend class Federation;
+
 		public:
 		/** Default Constructor creating an empty DBM. Used when zones aren't needed.
 		 */
@@ -550,16 +1128,19 @@ namespace tacos::zones {
 		 * @param clocks The set of all clocks that will be covered by this zone
 		 * @param max_constant The maximal constant that can appear for any given clock
 		 * @param reset_clocks True if all clocks should be initialized as 0, false if all clocks should be left unbounded
+		 * @param registry The registry used to translate clock names to IDs
 		 */
-		Zone_DBM(std::set<std::string> clocks, Endpoint max_constant, bool reset_clocks = false) : max_constant_(max_constant) {
-			graph_ = Graph(clocks);
+		Zone_DBM(std::set<std::string> clocks, Endpoint max_constant, bool reset_clocks = false,
+				 std::shared_ptr<ClockRegistry> registry = ClockRegistry::get_default())
+		: registry_(std::move(registry)), max_constant_(max_constant) {
+			storage_ = std::make_shared<Graph_Storage>(Graph(get_clock_ids(clocks)));
 
 			if(reset_clocks) {
-				for(const auto &clock : clocks) {
-					reset(clock);
+				for(std::size_t i = 1; i < graph().size(); i++) {
+					reset(graph().get_clock_at(i));
 				}
 
-				graph_.floyd_warshall();
+				mutable_graph().floyd_warshall();
 			}
 		}
 
@@ -568,8 +1149,11 @@ namespace tacos::zones {
 		 * 
 		 * @param clock_constraints The multimap of all clock constraints that will be covered by this zone. This must also contain all possible clocks
 		 * @param max_constant The maximal constant that can appear for any given clock
+		 * @param registry The registry used to translate clock names to IDs
 		 */
-		Zone_DBM(std::multimap<std::string, automata::ClockConstraint> clock_constraints, Endpoint max_constant) : max_constant_(max_constant) {
+		Zone_DBM(std::multimap<std::string, automata::ClockConstraint> clock_constraints, Endpoint max_constant,
+				 std::shared_ptr<ClockRegistry> registry = ClockRegistry::get_default())
+		: registry_(std::move(registry)), max_constant_(max_constant) {
 			std::set<std::string> clocks; // set of all clocks
 
 			//TODO This is done naively due to me not having time T.T
@@ -578,14 +1162,39 @@ namespace tacos::zones {
 				clocks.insert(iter1->first);
 			}
 
-			graph_ = Graph(clocks);
+			storage_ = std::make_shared<Graph_Storage>(Graph(get_clock_ids(clocks)));
 
 			conjunct(clock_constraints);
 		}
 
+		/** Construct the canonical DBM from its minimal constraints, see get_minimal_constraints()
+		 *
+		 * @param minimal_constraints The minimal constraints of the DBM
+		 * @param max_constant The maximal constant that can appear for any given clock
+		 * @param registry The registry the clock IDs of the minimal constraints belong to
+		 */
+		Zone_DBM(const Reduced_DBM &minimal_constraints, Endpoint max_constant,
+				 std::shared_ptr<ClockRegistry> registry = ClockRegistry::get_default())
+		: storage_(std::make_shared<Graph_Storage>(minimal_constraints.get_graph())), registry_(std::move(registry)),
+		  max_constant_(max_constant) {
+
+		}
+
+		/** Copies share the matrix until one of them changes it, see mutable_graph() */
+		Zone_DBM(const Zone_DBM &other) = default;
+
+		Zone_DBM(Zone_DBM &&other) = default;
+
+		Zone_DBM &operator=(const Zone_DBM &other) = default;
+
+		Zone_DBM &operator=(Zone_DBM &&other) = default;
+
 		/** Get the Zone_slice of this clock */
 		Zone_slice get_zone_slice(std::string clock) const;
 
+		/** Get the Zone_slice of this clock */
+		Zone_slice get_zone_slice(ClockID clock) const;
+
 		/** Delays a DBM. Every Entry at graph_.get(i, 0) is set to infinity */
 		void delay();
 
@@ -595,6 +1204,24 @@ namespace tacos::zones {
 		 */
 		void reset(std::string clock);
 
+		/** Resets a clock back to zero. The canonical form is preserved
+		 * 
+		 * @param clock The ID of the clock to reset to zero
+		 */
+		void reset(ClockID clock);
+
+		/** Frees a clock, i.e., removes all its constraints except for being non-negative. The canonical form is preserved
+		 *
+		 * @param clock The clock to free
+		 */
+		void free_clock(std::string clock);
+
+		/** Frees a clock, i.e., removes all its constraints except for being non-negative. The canonical form is preserved
+		 *
+		 * @param clock The ID of the clock to free
+		 */
+		void free_clock(ClockID clock);
+
 		/** Conjuncts this DBM with a clock constraint
 		 * 
 		 * If the DBM stops being in canonical form because of this, it is put back in line as well.
@@ -603,17 +1230,46 @@ namespace tacos::zones {
 		 */
 		void conjunct(std::string clock, automata::ClockConstraint constraint);
 
-		/** Conjuncts this DBM with a multimap of clock constraints
+		/** Conjuncts this DBM with a clock constraint on the clock with this ID
 		 * 
 		 * If the DBM stops being in canonical form because of this, it is put back in line as well.
 		 * 
+		 * @param constraint The clock constraint to change the DBM with
+		 */
+		void conjunct(ClockID clock, automata::ClockConstraint constraint);
+
+		/** Conjuncts this DBM with a multimap of clock constraints
+		 * 
+		 * All constraints are applied first and the canonical form is restored once afterwards, which only uses the
+		 * constrained clocks as intermediate nodes.
+		 * 
 		 * @param clock_constraints The clock constraints to change the DBM with
 		 */
-		void conjunct(std::multimap<std::string, automata::ClockConstraint> clock_constraints);
+		void conjunct(const std::multimap<std::string, automata::ClockConstraint> &clock_constraints);
 
-		/** Normalize this DBM according to max_constant_ */
+		/** Normalize this DBM.
+		 * 
+		 * If clock bounds are set, this is the Extra_LU+ extrapolation by Behrmann et al., which is coarser than the
+		 * max-constant normalization, since each clock only keeps the precision its own constraints need. The canonical
+		 * form is restored afterwards. Otherwise all bounds are clamped according to max_constant_.
+		 */
 		void normalize();
 
+		/** Use LU extrapolation with these bounds when normalizing. nullptr switches back to max_constant_ */
+		void
+		set_clock_bounds(std::shared_ptr<const ClockBounds> clock_bounds)
+		{
+			clock_bounds_ = std::move(clock_bounds);
+			normalized_   = false;
+		}
+
+		/** Get the bounds used for LU extrapolation, or nullptr if max_constant_ is used */
+		const std::shared_ptr<const ClockBounds> &
+		get_clock_bounds() const
+		{
+			return clock_bounds_;
+		}
+
 		/** Check whether this zone is consistent, i.e. it has no empty sets.
 		 * 
 		 * This is accomplished by always marking inconsistent DBMs with a negative value at D_00
@@ -623,12 +1279,35 @@ namespace tacos::zones {
 		/** Returns a vector containing all clocks except for the zero clock within this DBM */
 		std::vector<std::string> get_clocks() const;
 
+		/** Returns the IDs of all clocks except for the zero clock within this DBM, in the order of their indices */
+		std::vector<ClockID> get_clock_ids() const;
+
+		/** Get the ID of a clock name in this DBM's registry. The clock does not need to be part of this DBM */
+		ClockID
+		get_clock_id(const std::string &clock_name) const
+		{
+			return registry_->get_id(clock_name);
+		}
+
+		/** Get the registry this DBM uses to translate clock names */
+		const std::shared_ptr<ClockRegistry> &
+		get_registry() const
+		{
+			return registry_;
+		}
+
 		/** Adds a new clock.
 		 * 
 		 * @return Returns True if successful, false if clock already exists or something bad happened
 		 */
 		bool add_clock(std::string clock_name);
 
+		/** Adds a new clock by its ID.
+		 * 
+		 * @return Returns True if successful, false if clock already exists or something bad happened
+		 */
+		bool add_clock(ClockID clock);
+
 		/** Creates a copy of a clock. This means the new clock will have the exact same difference constraints
 		 * 
 		 * @param new_clock_name Name of the new clock. If it already exists, then it is completely overwritten
@@ -637,25 +1316,102 @@ namespace tacos::zones {
 		 */
 		bool copy_clock(std::string new_clock_name, std::string clock_to_copy);
 
+		/** Creates a copy of a clock, see copy_clock(std::string, std::string) */
+		bool copy_clock(ClockID new_clock, ClockID clock_to_copy);
+
 		/** Removes a clock.
 		 * 
 		 * @return True if successful, false if clock doesn't exist or something bad happened
 		 */
 		bool remove_clock(std::string clock_name);
 
+		/** Removes a clock by its ID.
+		 * 
+		 * @return True if successful, false if clock doesn't exist or something bad happened
+		 */
+		bool remove_clock(ClockID clock);
+
 		/** Returns true iff the clock exists in the DBM */
 		bool has_clock(std::string clock_name) const;
 
+		/** Returns true iff the clock with this ID exists in the DBM */
+		bool has_clock(ClockID clock) const;
+
 		/** Calculates the increment needed in order to reach the new DBM.
 		 * 
 		 * @param new_dbm The new DBM that is supposed to be reached
 		 * @return The needed increment as a Region Index
 		 */
-		RegionIndex get_increment(Zone_DBM new_dbm) const;
+		RegionIndex get_increment(const Zone_DBM &new_dbm) const;
+
+		/** Check whether this zone is a subset of another zone over the same clocks.
+		 * 
+		 * Both DBMs must be canonical. Then this holds iff every bound of this DBM is at most the corresponding bound of
+		 * the other one, which is a single pass of the inclusion kernel if the clocks are stored in the same order.
+		 * Inconsistent zones are included in every zone.
+		 * 
+		 * @param other The zone that may include this one
+		 * @return False if the clocks differ or some valuation of this zone is not in the other zone
+		 */
+		bool is_included_in(const Zone_DBM &other) const;
+
+		/** Check whether the projection of this zone onto the clocks of the other zone is included in the other zone.
+		 * 
+		 * Both DBMs must be canonical, then the projection is the submatrix of the other zone's clocks, so this compares
+		 * these bounds in place. Unlike is_included_in(), this zone may have additional clocks.
+		 * 
+		 * @param other The zone that may include the projection of this one
+		 * @return False if some clock of the other zone is missing in this zone or some valuation of this zone is not
+		 * in the other zone on the shared clocks
+		 */
+		bool is_projection_included_in(const Zone_DBM &other) const;
+
+		/** Get the hash of the matrix and the names of its clocks, so it doesn't depend on the registry. It is computed
+		 * once and cached until the DBM changes.
+		 */
+		std::size_t hash() const;
+
+		/** Returns true iff this DBM shares its matrix with a DBM_Pool */
+		bool
+		is_interned() const
+		{
+			return storage_ != nullptr && storage_->pool_id != 0;
+		}
+
+		/** Returns true iff both DBMs use the same matrix, e.g. a copy that hasn't been changed yet */
+		bool
+		shares_matrix_with(const Zone_DBM &other) const
+		{
+			return storage_ != nullptr && storage_ == other.storage_;
+		}
+
+		/** Get the minimal constraints of this DBM, from which it can be rebuilt */
+		Reduced_DBM get_minimal_constraints() const;
+
+		/** Replace the matrix by its minimal constraints to save memory, e.g. once a search node has been expanded.
+		 *
+		 * A compressed DBM can still be compared, hashed and read, but reading bounds decompresses a temporary copy
+		 * each time, so DBMs that are read often should be decompressed first. Changing a compressed DBM decompresses
+		 * it. Inconsistent DBMs are not compressed.
+		 */
+		void compress();
+
+		/** Restore the full matrix of a compressed DBM */
+		void decompress();
+
+		/** Returns true iff only the minimal constraints of this DBM are stored */
+		bool
+		is_compressed() const
+		{
+			return storage_ != nullptr && storage_->compressed;
+		}
 
 		/** Get the DBM for only these clocks. Always include the zero clock */
 		Zone_DBM get_subset(std::set<std::string> clocks) const;
 
+		/** Get the DBM for only the clocks with these IDs, in the given order. Always include the zero clock */
+		Zone_DBM get_subset_of_ids(const std::vector<ClockID> &clocks) const;
+
 		/** Gets graph element at x,y
 		 */
 		DBM_Entry at(std::size_t x, std::size_t y) const;
@@ -683,36 +1439,163 @@ namespace tacos::zones {
 			std::map<std::string, std::size_t> ret;
 
 			for(const auto &clock : clocks) {
-				ret.insert( {clock, graph_.get_index_of_clock(clock)} );
+				ret.insert( {clock, get_index_of_clock(clock)} );
 			}
 
 			return ret;
 		}
 		private:
 		/** Private Constructor for constructing directly with a graph */
-		Zone_DBM(Graph graph, Endpoint max_constant) : graph_(graph), max_constant_(max_constant)
+		Zone_DBM(Graph graph, std::shared_ptr<ClockRegistry> registry, std::shared_ptr<const ClockBounds> clock_bounds,
+				 Endpoint max_constant)
+		: storage_(std::make_shared<Graph_Storage>(std::move(graph))), registry_(std::move(registry)), clock_bounds_(std::move(clock_bounds)),
+		  max_constant_(max_constant)
 		{
 
 		}
 
+		/** Translates clock names to IDs, in the order of the set */
+		std::vector<ClockID> get_clock_ids(const std::set<std::string> &clocks) const;
+
+		/** Returns whether the graph of this DBM has the same clocks at the same indices as the graph of the other DBM.
+		 * If the DBMs use different registries, the clocks are compared by their names.
+		 */
+		bool has_same_clocks(const Graph &graph, const Zone_DBM &other, const Graph &other_graph) const;
+
+		/** Compare the clocks of the graph of this DBM lexicographically by their names to the clocks of the graph of
+		 * the other DBM. Names are used even within one registry, so the order doesn't depend on the IDs.
+		 */
+		bool has_smaller_clocks(const Graph &graph, const Zone_DBM &other, const Graph &other_graph) const;
+
 		/** Conjuncts the DBM with this diagonal clock constraint: comparison(x,y)
 		 * 
 		 * e.g. if comparison is (2, <=), then the clock constraint is:
 		 * x - y <= 2
 		 * 
-		 * TODO Use the actual algorithm provided by Bengtsson and Yi, instead of the text description, as that is supposed
-		 * to be O(n^2) instead of O(n^3)
+		 * The canonical form is restored in O(n^2) by only using x and y as intermediate nodes, following the algorithm
+		 * by Bengtsson and Yi.
 		 * 
 		 * @param x index of first clock
 		 * @param y index of second clock
-		 * @param comparison DBM_Entry denoting the constant and type of the comparison
+		 * @param comparison Packed bound denoting the constant and type of the comparison
+		 * @return true if the DBM has changed
+		 */
+		bool and_func(std::size_t x, std::size_t y, DBM_Bound comparison);
+
+		/** Get the bounds of an atomic clock constraint as a pair of (upper bound x - 0, lower bound 0 - x).
+		 * Unconstrained directions are infinity
 		 */
-		void and_func(std::size_t x, std::size_t y, DBM_Entry comparison);
+		static std::pair<DBM_Bound, DBM_Bound> get_bounds(const automata::ClockConstraint &clock_constraint);
 
 		/** Get the index of a clock */
 		std::size_t get_index_of_clock(std::string clock) const;
 
-		Graph graph_;
+		/** Extra_LU+ extrapolation, see normalize() */
+		void extrapolate_lu();
+
+		/** True iff the max-constant normalization clamps this bound */
+		bool exceeds_max_constant(DBM_Bound bound) const;
+
+		/** Normalize after a conjunction, unless the DBM is known to stay normalized
+		 *
+		 * @param was_normalized Whether the DBM was normalized before the conjunction
+		 * @param exceeds_limits Whether the max-constant normalization clamps a bound of the conjuncted constraints
+		 */
+		void keep_normalized(bool was_normalized, bool exceeds_limits);
+
+		/** The matrix of a DBM together with its hash.
+		 *
+		 * Storages are shared by copies of a DBM and are copied on the first change of a shared one. Interned and
+		 * compressed storages are never changed again, not even by their only owner.
+		 */
+		struct Storage
+		{
+			Storage(bool compressed, std::size_t hash) : hash(hash), compressed(compressed)
+			{
+
+			}
+
+			//Cached hash of the graph, 0 if it has not been computed yet
+			mutable std::atomic<std::size_t> hash;
+			//ID of the pool this storage is interned in, 0 if it isn't interned
+			std::uint64_t pool_id = 0;
+			//True for a Reduced_Storage, false for a Graph_Storage
+			const bool compressed;
+		};
+
+		/** A storage of the full matrix */
+		struct Graph_Storage : Storage
+		{
+			explicit Graph_Storage(Graph graph) : Storage(false, 0), graph(std::move(graph))
+			{
+
+			}
+
+			/** Copies are not interned */
+			Graph_Storage(const Graph_Storage &other)
+			: Storage(false, other.hash.load(std::memory_order_relaxed)), graph(other.graph)
+			{
+
+			}
+
+			Graph graph;
+		};
+
+		/** A storage of the minimal constraints only. It is a separate type, so it doesn't carry an empty inline
+		 * matrix around. The hash is still the one of the full matrix.
+		 */
+		struct Reduced_Storage : Storage
+		{
+			Reduced_Storage(Reduced_DBM reduced, std::size_t hash) : Storage(true, hash), reduced(std::move(reduced))
+			{
+
+			}
+
+			Reduced_DBM reduced;
+		};
+
+		/** Get the matrix for reading. The DBM must not be compressed */
+		const Graph &
+		graph() const
+		{
+			assert(!is_compressed());
+			static const Graph empty_graph{};
+			return storage_ != nullptr ? static_cast<const Graph_Storage &>(*storage_).graph : empty_graph;
+		}
+
+		/** Get the minimal constraints of a compressed DBM */
+		const Reduced_DBM &
+		reduced() const
+		{
+			assert(is_compressed());
+			return static_cast<const Reduced_Storage &>(*storage_).reduced;
+		}
+
+		/** Get the matrix for reading, a compressed matrix is decompressed into the buffer */
+		const Graph &
+		read_graph(Graph &buffer) const
+		{
+			if(is_compressed()) {
+				buffer = reduced().get_graph();
+				return buffer;
+			}
+
+			return graph();
+		}
+
+		/** Get the matrix for changing it. If it is shared or immutable, this DBM gets its own copy first */
+		Graph &mutable_graph();
+
+		/** True iff the storage is owned by this DBM alone and may be changed in place */
+		bool owns_storage() const;
+
+		//nullptr for the empty DBM without any clocks
+		std::shared_ptr<Storage> storage_;
+		std::shared_ptr<ClockRegistry> registry_ = ClockRegistry::get_default();
+		//Not part of the comparison, since all DBMs of one search share the same bounds
+		std::shared_ptr<const ClockBounds> clock_bounds_;
+		//True iff normalize() wouldn't change the matrix, cleared by mutable_graph()
+		bool normalized_ = false;
 		public:
 		//Max constant that may appear in any zone
 		Endpoint max_constant_;
@@ -720,41 +1603,83 @@ namespace tacos::zones {
 		/** Compare two DBMs.
 		 * Not really a lot of theoretical meaning. Just for sets to be happy
 		 * 
+		 * DBMs are ordered by size, then by max constant, then by hash and only then lexicographically by their
+		 * matrices, so DBMs of the same size rarely need to be compared cell by cell. DBMs with equal matrices are
+		 * ordered by the names of their clocks, so two DBMs are equivalent iff they are equal.
+		 * 
 		 * @param s1 The first dbm
 		 * @param s2 The second dbm
-		 * @return true if s1 is lexicographically smaller than s2
+		 * @return true if s1 is smaller than s2
 		 */
 		friend bool
 		operator<(const Zone_DBM &s1, const Zone_DBM &s2) {
-			if(s1.size() < s2.size()) {
-				return true;
-			} else if(s1.size() > s2.size()) {
+			if(s1.size() != s2.size()) {
+				return s1.size() < s2.size();
+			}
+
+			if(s1.max_constant_ != s2.max_constant_) {
+				return s1.max_constant_ < s2.max_constant_;
+			}
+
+			//The same matrix only means the same zone if the clock IDs are from the same registry
+			if(s1.registry_ == s2.registry_ && s1.storage_ == s2.storage_) {
 				return false;
 			}
 
-			if(s1.max_constant_ < s2.max_constant_) {
-				return true;
+			if(s1.hash() != s2.hash()) {
+				return s1.hash() < s2.hash();
 			}
 
-			for(std::size_t i = 0; i < s1.size() + 1; i++) {
-				for(std::size_t j = 0; j < s1.size() + 1; j++) {
-					if(s1.at(i, j) < s2.at(i,j)) {
-						return true;
-					}
-				}
+			Graph buffer1, buffer2;
+			const Graph &graph1 = s1.read_graph(buffer1);
+			const Graph &graph2 = s2.read_graph(buffer2);
+			if(!graph1.has_same_bounds(graph2)) {
+				return graph1.has_smaller_bounds(graph2);
 			}
 
-			return false;
+			return s1.has_smaller_clocks(graph1, s2, graph2);
 		}
 
 		/** Check two DBMs for equality.
+		 * 
+		 * DBMs interned or compressed by the same pool are equal iff they share their matrix or their minimal
+		 * constraints, respectively. DBMs with different registries are equal iff they have the same bounds over clocks
+		 * with the same names.
+		 * 
 		 * @param s1 The first dbm
 		 * @param s2 The second dbm
 		 * @return true if s1 is equal to s2
 		 */
 		friend bool
 		operator==(const Zone_DBM &s1, const Zone_DBM &s2) {
-			return !(s1 < s2) && !(s2 < s1);
+			if(s1.max_constant_ != s2.max_constant_) {
+				return false;
+			}
+
+			const bool same_registry = s1.registry_ == s2.registry_;
+
+			if(same_registry && s1.storage_ == s2.storage_) {
+				return true;
+			}
+
+			if(same_registry && s1.storage_ != nullptr && s2.storage_ != nullptr && s1.storage_->pool_id != 0
+			   && s1.storage_->pool_id == s2.storage_->pool_id && s1.is_compressed() == s2.is_compressed()) {
+				return false;
+			}
+
+			if(s1.hash() != s2.hash()) {
+				return false;
+			}
+
+			if(same_registry && s1.is_compressed() && s2.is_compressed()) {
+				return s1.reduced().get_clocks() == s2.reduced().get_clocks()
+				       && s1.reduced().get_constraints() == s2.reduced().get_constraints();
+			}
+
+			Graph buffer1, buffer2;
+			const Graph &graph1 = s1.read_graph(buffer1);
+			const Graph &graph2 = s2.read_graph(buffer2);
+			return graph1.has_same_bounds(graph2) && s1.has_same_clocks(graph1, s2, graph2);
 		}
 
 		/** Check two DBMs for inequality.
@@ -768,6 +1693,131 @@ namespace tacos::zones {
 		}
 	};
 
+	/** A thread-safe pool of immutable DBM matrices, so that equal DBMs share one matrix (hash consing).
+	 * 
+	 * Interning a DBM replaces its matrix by the equal matrix from the pool, or adds its matrix to the pool. Afterwards,
+	 * copies of the DBM share the matrix, and comparing two DBMs of the same pool is a pointer comparison.
+	 * Changing an interned DBM gives it its own copy of the matrix again.
+	 * The pool only holds weak references, so matrices are freed once no DBM uses them anymore.
+	 */
+	class DBM_Pool
+	{
+		public:
+		DBM_Pool();
+
+		DBM_Pool(const DBM_Pool &) = delete;
+		DBM_Pool &operator=(const DBM_Pool &) = delete;
+
+		/** Share the matrix of this DBM with all equal DBMs interned in this pool */
+		void intern(Zone_DBM &dbm);
+
+		/** Replace the matrix of this DBM by its minimal constraints, see Zone_DBM::compress(), and share them with all
+		 * equal DBMs compressed by this pool. DBMs that share an interned matrix thus also share its compressed form
+		 * instead of each getting their own copy.
+		 */
+		void compress(Zone_DBM &dbm);
+
+		/** Returns the number of distinct matrices in this pool that are still in use */
+		std::size_t size() const;
+
+		/** Returns the number of distinct minimal constraints in this pool that are still in use */
+		std::size_t compressed_size() const;
+
+		private:
+		using Storages = std::unordered_map<std::size_t, std::vector<std::weak_ptr<Zone_DBM::Storage>>>;
+
+		/** Count the storages that are still in use */
+		static std::size_t count_in_use(const Storages &storages);
+
+		const std::uint64_t id_;
+		mutable std::shared_mutex mutex_;
+		Storages storages_;
+		Storages reduced_storages_;
+	};
+
+	/** A union of zones over the same clocks, i.e. a possibly non-convex set of clock valuations.
+	 *
+	 * The members are consistent, but may overlap or include each other until reduce() is called. The operations are
+	 * exact, i.e. results are neither normalized nor extrapolated.
+	 */
+	class Federation
+	{
+		public:
+		/** The empty federation */
+		Federation()
+		{
+
+		}
+
+		/** A federation consisting of a single zone, which is empty if the zone is inconsistent */
+		explicit Federation(const Zone_DBM &zone);
+
+		/** Adds a zone to this federation, inconsistent zones are ignored */
+		void add(const Zone_DBM &zone);
+
+		/** Get the union of this and another federation */
+		Federation unite(const Federation &other) const;
+
+		/** Get the intersection of this and another federation */
+		Federation intersect(const Federation &other) const;
+
+		/** Get all valuations of this federation that are not in the other federation */
+		Federation subtract(const Federation &other) const;
+
+		/** Returns true iff this federation doesn't contain any valuation */
+		bool
+		is_empty() const
+		{
+			return zones_.empty();
+		}
+
+		/** Returns true iff every valuation of this federation is also in the other federation */
+		bool is_included_in(const Federation &other) const;
+
+		/** Removes members that are included in other members, and replaces each pair of members whose union is convex
+		 * by that union. This doesn't change the represented valuations, but usually decreases the number of members.
+		 */
+		void reduce();
+
+		/** Get the convex members */
+		const std::vector<Zone_DBM> &
+		get_zones() const
+		{
+			return zones_;
+		}
+
+		/** Returns the number of convex members */
+		std::size_t
+		size() const
+		{
+			return zones_.size();
+		}
+
+		std::vector<Zone_DBM>::const_iterator
+		begin() const
+		{
+			return zones_.begin();
+		}
+
+		std::vector<Zone_DBM>::const_iterator
+		end() const
+		{
+			return zones_.end();
+		}
+
+		/** Get the intersection of two zones over the same clocks, which is inconsistent if they don't intersect */
+		static Zone_DBM intersect(const Zone_DBM &zone1, const Zone_DBM &zone2);
+
+		/** Get zone1 without zone2 as disjoint zones */
+		static std::vector<Zone_DBM> subtract(const Zone_DBM &zone1, const Zone_DBM &zone2);
+
+		/** Get the smallest zone that includes both consistent zones */
+		static Zone_DBM convex_hull(const Zone_DBM &zone1, const Zone_DBM &zone2);
+
+		private:
+		std::vector<Zone_DBM> zones_;
+	};
+
 	/**
 	 * @brief Checks whether a zone's interval is valid, i.e. lower bound is less equal to upper bound, and no bounds exceed the max constant
 	 * Kind of a trivial check now that empty sets can be represented by "invalid" zones.
@@ -827,6 +1877,40 @@ namespace tacos::zones {
 
 } //namespace tacos::zones
 
+namespace std {
+
+/** Hash a zone slice */
+template <>
+struct hash<tacos::zones::Zone_slice>
+{
+	/** Get the hash of the bounds of a zone slice */
+	std::size_t
+	operator()(const tacos::zones::Zone_slice &zone) const
+	{
+		std::size_t seed = 0;
+		tacos::utilities::hash_combine(seed, zone.lower_bound_);
+		tacos::utilities::hash_combine(seed, zone.upper_bound_);
+		tacos::utilities::hash_combine(seed, zone.lower_isOpen_);
+		tacos::utilities::hash_combine(seed, zone.upper_isOpen_);
+		tacos::utilities::hash_combine(seed, zone.max_constant_);
+		return seed;
+	}
+};
+
+/** Hash a DBM, see tacos::zones::Zone_DBM::hash() */
+template <>
+struct hash<tacos::zones::Zone_DBM>
+{
+	/** Get the cached hash of a DBM */
+	std::size_t
+	operator()(const tacos::zones::Zone_DBM &dbm) const
+	{
+		return dbm.hash();
+	}
+};
+
+} // namespace std
+
 namespace fmt {
 
 template <>
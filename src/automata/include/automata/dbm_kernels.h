@@ -0,0 +1,68 @@
+#ifndef SRC_AUTOMATA_INCLUDE_AUTOMATA_DBM_KERNELS_H
+#define SRC_AUTOMATA_INCLUDE_AUTOMATA_DBM_KERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace tacos::zones {
+
+	/** A single DBM bound packed into one integer.
+	 *
+	 * The value is stored in the upper bits and the strictness in the lowest bit (1 for <=, 0 for <), so for finite
+	 * bounds the integer order is exactly the order of DBM_Entries, i.e. (c, <) < (c, <=) < (c+1, <).
+	 * DBM_BOUND_INFINITY is reserved for unbounded entries and is larger than every finite bound.
+	 */
+	using DBM_Bound = std::int32_t;
+
+	/** Reserved encoding of an unbounded entry */
+	constexpr DBM_Bound DBM_BOUND_INFINITY = std::numeric_limits<DBM_Bound>::max();
+
+	/** The instruction sets for which DBM kernels exist */
+	enum class InstructionSet {
+		SCALAR,
+		SSE2,
+		AVX2,
+	};
+
+	/** The inner loops over packed DBM bounds that dominate zone operations.
+	 *
+	 * All kernels work on plain arrays of packed bounds (see zones::DBM_Bound), so the same kernels are used for
+	 * whole matrices and for single rows. Every instruction set provides the same results as the scalar reference.
+	 */
+	struct DBM_Kernels
+	{
+		/** One step of the Floyd-Warshall closure for a single row, i.e. for all j < n:
+		 *  row_i[j] = min(row_i[j], distance_ik + row_k[j])
+		 *
+		 * @param row_i The row that is relaxed
+		 * @param row_k The row of the intermediate vertex k
+		 * @param distance_ik The finite bound of the edge i->k
+		 * @param n The length of the rows
+		 */
+		void (*relax_row)(DBM_Bound *row_i, const DBM_Bound *row_k, DBM_Bound distance_ik, std::size_t n);
+
+		/** Returns true iff lhs[j] <= rhs[j] for all j < n, i.e. the inclusion test of two matrices */
+		bool (*is_less_equal)(const DBM_Bound *lhs, const DBM_Bound *rhs, std::size_t n);
+
+		/** Max-constant normalization of n bounds: bounds above upper_limit become infinity and bounds below lower_limit
+		 * are raised to lower_limit
+		 */
+		void (*normalize)(DBM_Bound *bounds, std::size_t n, DBM_Bound upper_limit, DBM_Bound lower_limit);
+	};
+
+	/** Returns true iff the current CPU can run kernels of this instruction set */
+	bool is_supported(InstructionSet instruction_set);
+
+	/** Returns the best instruction set supported by the current CPU. This is only detected once */
+	InstructionSet get_best_instruction_set();
+
+	/** Returns the kernels for this instruction set. The instruction set must be supported. Mostly for testing */
+	const DBM_Kernels &get_dbm_kernels(InstructionSet instruction_set);
+
+	/** Returns the kernels for the best instruction set of the current CPU */
+	const DBM_Kernels &get_dbm_kernels();
+
+} //namespace tacos::zones
+
+#endif
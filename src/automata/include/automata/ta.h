@@ -10,6 +10,7 @@
 #define SRC_AUTOMATA_INCLUDE_AUTOMATA_TA_H
 
 #include "automata.h"
+#include "utilities/hash.h"
 #include "utilities/types.h"
 
 #include <fmt/ostream.h>
@@ -493,6 +494,14 @@ public:
 	 */
 	Endpoint get_largest_constant() const;
 
+	/** Get the active clocks of each location.
+	 * A clock is active in a location if its value may be read by some guard before the clock is reset. The value
+	 * of an inactive clock does not affect the future behavior, so configurations that only differ in inactive
+	 * clocks are equivalent.
+	 * @return A map from each location to its active clocks
+	 */
+	std::map<Location, std::set<std::string>> get_active_clocks() const;
+
 	/** Get the initial configuration of the automaton.
 	 * @return The initial configuration
 	 */
@@ -553,6 +562,23 @@ struct formatter<tacos::automata::ta::TimedAutomaton<LocationT, AP>> : ostream_f
 
 } // namespace fmt
 
+namespace std {
+
+/** Hash a TA location. Unlike the hash of NamedType, this also works for locations of product automata, which are
+ * vectors of locations. */
+template <typename LocationT>
+struct hash<tacos::automata::ta::Location<LocationT>>
+{
+	/** Get the hash of a location. */
+	std::size_t
+	operator()(const tacos::automata::ta::Location<LocationT> &location) const
+	{
+		return tacos::utilities::hash_value(location.get());
+	}
+};
+
+} // namespace std
+
 #include "ta.hpp"
 
 #endif /* ifndef SRC_AUTOMATA_INCLUDE_AUTOMATA_TA_H */
@@ -298,6 +298,34 @@ TimedAutomaton<LocationT, AP>::get_largest_constant() const
 	return res;
 }
 
+template <typename LocationT, typename AP>
+std::map<Location<LocationT>, std::set<std::string>>
+TimedAutomaton<LocationT, AP>::get_active_clocks() const
+{
+	std::map<Location, std::set<std::string>> active;
+	for (const auto &location : locations_) {
+		active[location];
+	}
+	for (const auto &[source, transition] : transitions_) {
+		for (const auto &[clock, constraint] : transition.get_guards()) {
+			active[source].insert(clock);
+		}
+	}
+	// A clock is also active if it is active in a successor and not reset on the way.
+	bool changed = true;
+	while (changed) {
+		changed = false;
+		for (const auto &[source, transition] : transitions_) {
+			for (const auto &clock : active[transition.get_target()]) {
+				if (transition.get_reset().count(clock) == 0 && active[source].insert(clock).second) {
+					changed = true;
+				}
+			}
+		}
+	}
+	return active;
+}
+
 template <typename LocationT, typename AP>
 TAConfiguration<LocationT>
 TimedAutomaton<LocationT, AP>::get_initial_configuration() const
@@ -10,13 +10,16 @@
 #define SRC_MTL_INCLUDE_MTL_MTLFORMULA_H
 
 #include "utilities/Interval.h"
+#include "utilities/hash.h"
 #include "utilities/types.h"
 
 #include <fmt/ostream.h>
 
 #include <algorithm>
 #include <cassert>
+#include <cstddef>
 #include <iostream>
+#include <memory>
 #include <optional>
 #include <set>
 #include <string>
@@ -134,6 +137,10 @@ private:
 /**
  * @brief Class representing an MTL-formula with the usual operators.
  *
+ * Formulas are hash-consed: every distinct formula is stored exactly once as an immutable node, which all equal
+ * formulas share. Copying a formula only copies a pointer to its node, and two formulas are equal iff they share
+ * the same node. The nodes are kept for the lifetime of the program, as specifications only have few distinct
+ * subformulas.
  */
 template <typename APType>
 class MTLFormula
@@ -147,15 +154,11 @@ public:
 	 */
 	MTLFormula(const AtomicProposition<APType> &ap);
 
-	/** * @brief Copy-constructor */
+	/** * @brief Copy-constructor. This only copies the pointer to the node, so it needs neither locks nor atomics. */
 	MTLFormula(const MTLFormula &) = default;
-	/** Move constructor */
-	MTLFormula(MTLFormula &&) = default;
 
 	/** Copy assignment. */
 	MTLFormula &operator=(const MTLFormula &) = default;
-	/** Move assignment. */
-	MTLFormula &operator=(MTLFormula &&) = default;
 
 	/// Get a formula that is always true.
 	static MTLFormula
@@ -229,11 +232,11 @@ public:
 		return *this > rhs || *this == rhs;
 	}
 
-	/// equal operator
+	/// equal operator, equal formulas share the same node
 	bool
 	operator==(const MTLFormula &rhs) const
 	{
-		return !(*this < rhs) && !(rhs < *this);
+		return node_ == rhs.node_;
 	}
 	/// not-equal operator
 	bool
@@ -259,13 +262,13 @@ public:
 	const std::vector<MTLFormula> &
 	get_operands() const
 	{
-		return operands_;
+		return node_->operands;
 	}
 	/// getter for the logical operator
 	LOP
 	get_operator() const
 	{
-		return operator_;
+		return node_->op;
 	}
 	/**
 	 * @brief getter for the duration
@@ -275,7 +278,7 @@ public:
 	TimeInterval
 	get_interval() const
 	{
-		return duration_.value_or(TimeInterval{});
+		return node_->duration.value_or(TimeInterval{});
 	}
 
 	/**
@@ -286,13 +289,29 @@ public:
 	AtomicProposition<APType>
 	get_atomicProposition() const
 	{
-		assert(ap_.has_value());
-		return ap_.value();
+		assert(node_->ap.has_value());
+		return node_->ap.value();
 	}
 
 	/** Get the value of the largest constant occurring in the formula.  */
 	Endpoint get_largest_constant() const;
 
+	/** Get the hash of the formula. It is computed from the hashes of the operands on construction. */
+	std::size_t
+	hash() const
+	{
+		return node_->hash;
+	}
+
+	/** Get the unique ID of the formula. Equal formulas have the same ID, and IDs are handed out in the order in
+	 * which distinct formulas are first constructed.
+	 */
+	std::size_t
+	get_id() const
+	{
+		return node_->id;
+	}
+
 	// TODO Refactor into utilities.
 	/** Get the value of the largest constant occurring in the formula.  */
 	std::size_t
@@ -302,15 +321,27 @@ public:
 	}
 
 private:
+	/** The immutable node of a formula, which is shared by all equal formulas */
+	struct Node
+	{
+		std::optional<AtomicProposition<APType>> ap;
+		LOP                                      op;
+		//Only set for until and dual until formulas, the only ones where the interval is part of the comparison
+		std::optional<TimeInterval>     duration;
+		std::vector<MTLFormula<APType>> operands;
+		std::size_t                     hash{0};
+		std::size_t                     id{0};
+	};
+
 	bool
 	is_consistent() const
 	{
-		return (ap_.has_value() == (operator_ == LOP::AP));
+		return (node_->ap.has_value() == (node_->op == LOP::AP));
 	}
 
 	template <class It>
 	MTLFormula(LOP op, It first, It last, const TimeInterval &duration = TimeInterval())
-	: operator_(op), duration_(duration), operands_(first, last)
+	: node_(intern(Node{std::nullopt, op, duration, std::vector<MTLFormula>(first, last)}))
 	{
 		assert(is_consistent());
 	}
@@ -322,10 +353,12 @@ private:
 	{
 	}
 
-	std::optional<AtomicProposition<APType>> ap_;
-	LOP                                      operator_;
-	std::optional<TimeInterval>              duration_;
-	std::vector<MTLFormula<APType>>          operands_;
+	/** Get the node of the given formula, which is created if no equal formula exists yet. Nodes are never freed. */
+	static const Node *intern(Node node);
+
+	static std::size_t compute_hash(const Node &node);
+
+	const Node *node_;
 };
 
 /// Logical AND
@@ -388,6 +421,34 @@ std::ostream &operator<<(std::ostream &out, const logic::MTLFormula<APType> &f);
 
 } // namespace tacos::logic
 
+namespace std {
+
+/** Hash an atomic proposition. */
+template <typename APType>
+struct hash<tacos::logic::AtomicProposition<APType>>
+{
+	/** Get the hash of the underlying proposition. */
+	std::size_t
+	operator()(const tacos::logic::AtomicProposition<APType> &ap) const
+	{
+		return tacos::utilities::hash_value(ap.ap_);
+	}
+};
+
+/** Hash an MTL formula, see tacos::logic::MTLFormula::hash(). */
+template <typename APType>
+struct hash<tacos::logic::MTLFormula<APType>>
+{
+	/** Get the cached hash of the formula. */
+	std::size_t
+	operator()(const tacos::logic::MTLFormula<APType> &formula) const
+	{
+		return formula.hash();
+	}
+};
+
+} // namespace std
+
 namespace fmt {
 
 template <typename APType>
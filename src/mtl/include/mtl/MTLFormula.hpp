@@ -15,6 +15,9 @@
 #include <fmt/format.h>
 #include <fmt/ostream.h>
 
+#include <mutex>
+#include <unordered_map>
+
 namespace tacos::logic {
 
 template <typename APType>
@@ -113,7 +116,7 @@ MTLWord<APType>::satisfies_at(const MTLFormula<APType> &phi, std::size_t i) cons
 	if (i >= this->word_.size())
 		return false;
 
-	switch (phi.operator_) {
+	switch (phi.get_operator()) {
 	case LOP::TRUE: return true;
 	case LOP::FALSE: return false;
 	case LOP::AP:
@@ -121,29 +124,29 @@ MTLWord<APType>::satisfies_at(const MTLFormula<APType> &phi, std::size_t i) cons
 		       != word_[i].first.end();
 		break;
 	case LOP::LAND:
-		return std::all_of(phi.operands_.begin(), phi.operands_.end(), [this, i](const auto &subf) {
+		return std::all_of(phi.get_operands().begin(), phi.get_operands().end(), [this, i](const auto &subf) {
 			return satisfies_at(subf, i);
 		});
 		break;
 	case LOP::LOR:
-		return std::any_of(phi.operands_.begin(), phi.operands_.end(), [this, i](const auto &subf) {
+		return std::any_of(phi.get_operands().begin(), phi.get_operands().end(), [this, i](const auto &subf) {
 			return satisfies_at(subf, i);
 		});
 		break;
 	case LOP::LNEG:
-		return std::none_of(phi.operands_.begin(), phi.operands_.end(), [this, i](const auto &subf) {
+		return std::none_of(phi.get_operands().begin(), phi.get_operands().end(), [this, i](const auto &subf) {
 			return satisfies_at(subf, i);
 		});
 		break;
 	case LOP::LUNTIL:
 		for (std::size_t j = i + 1; j < word_.size(); ++j) {
 			// check if termination condition is satisfied, in time.
-			if (satisfies_at(phi.operands_.back(), j)) {
-				assert(phi.duration_.has_value());
-				return phi.duration_.value().contains(word_[j].second - word_[i].second);
+			if (satisfies_at(phi.get_operands().back(), j)) {
+				assert(phi.node_->duration.has_value());
+				return phi.node_->duration.value().contains(word_[j].second - word_[i].second);
 			} else {
 				// check whether first part is satisfied continuously.
-				if (!satisfies_at(phi.operands_.front(), j)) {
+				if (!satisfies_at(phi.get_operands().front(), j)) {
 					return false;
 				}
 			}
@@ -152,17 +155,17 @@ MTLWord<APType>::satisfies_at(const MTLFormula<APType> &phi, std::size_t i) cons
 		return false;
 		break;
 	case LOP::LDUNTIL:
-		assert(phi.duration_.has_value());
+		assert(phi.node_->duration.has_value());
 		// using  p DU q <=> !(!p U !q) (also called RELEASE operator)
 		// satisfied if:
 		// * q holds always, or
 		// * q holds until (and including this point in time) p becomes true
 		for (std::size_t j = i + 1; j < word_.size(); ++j) {
-			if (satisfies_at(phi.operands_.front(), j) and satisfies_at(phi.operands_.back(), j)) {
-				return phi.duration_.value().contains(word_[j].second - word_[i].second);
+			if (satisfies_at(phi.get_operands().front(), j) and satisfies_at(phi.get_operands().back(), j)) {
+				return phi.node_->duration.value().contains(word_[j].second - word_[i].second);
 			} else {
 				// check whether q is satisfied (probably indefinitely)
-				if (!satisfies_at(phi.operands_.back(), j)) {
+				if (!satisfies_at(phi.get_operands().back(), j)) {
 					return false;
 				}
 			}
@@ -183,11 +186,64 @@ MTLWord<APType>::satisfies(const MTLFormula<APType> &phi) const
 }
 
 template <typename APType>
-MTLFormula<APType>::MTLFormula(const AtomicProposition<APType> &ap) : ap_(ap), operator_(LOP::AP)
+MTLFormula<APType>::MTLFormula(const AtomicProposition<APType> &ap)
+: node_(intern(Node{ap, LOP::AP, std::nullopt, {}}))
 {
 	assert(is_consistent());
 }
 
+template <typename APType>
+const typename MTLFormula<APType>::Node *
+MTLFormula<APType>::intern(Node node)
+{
+	// Only the interval of until formulas is part of the comparison.
+	if (node.op != LOP::LUNTIL && node.op != LOP::LDUNTIL) {
+		node.duration.reset();
+	}
+	node.hash = compute_hash(node);
+	// The operands are already interned, so they are equal iff they share their nodes.
+	const auto is_equal = [&node](const Node &other) {
+		return other.op == node.op && other.ap == node.ap && other.duration == node.duration
+		       && other.operands.size() == node.operands.size()
+		       && std::equal(other.operands.begin(), other.operands.end(), node.operands.begin());
+	};
+
+	// The table owns all nodes, formulas only point to them.
+	static std::mutex                                                        mutex;
+	static std::unordered_multimap<std::size_t, std::unique_ptr<const Node>> nodes;
+	std::lock_guard                                                          lock{mutex};
+	for (auto [it, last] = nodes.equal_range(node.hash); it != last; ++it) {
+		if (is_equal(*it->second)) {
+			return it->second.get();
+		}
+	}
+	node.id       = nodes.size();
+	auto interned = std::make_unique<const Node>(std::move(node));
+	return nodes.emplace(interned->hash, std::move(interned))->second.get();
+}
+
+template <typename APType>
+std::size_t
+MTLFormula<APType>::compute_hash(const Node &node)
+{
+	std::size_t seed = 0;
+	utilities::hash_combine(seed, node.op);
+	if (node.op == LOP::AP) {
+		utilities::hash_combine(seed, node.ap.value());
+		return seed;
+	}
+	if (node.duration) {
+		utilities::hash_combine(seed, node.duration->lower());
+		utilities::hash_combine(seed, node.duration->lowerBoundType());
+		utilities::hash_combine(seed, node.duration->upper());
+		utilities::hash_combine(seed, node.duration->upperBoundType());
+	}
+	for (const auto &operand : node.operands) {
+		utilities::hash_combine(seed, operand.hash());
+	}
+	return seed;
+}
+
 template <typename APType>
 MTLFormula<APType>
 MTLFormula<APType>::operator&&(const MTLFormula &rhs) const
@@ -232,6 +288,11 @@ template <typename APType>
 bool
 MTLFormula<APType>::operator<(const MTLFormula &rhs) const
 {
+	// equal formulas share their node, this also makes comparing equal operands cheap
+	if (node_ == rhs.node_) {
+		return false;
+	}
+
 	// compare operation
 	if (this->get_operator() != rhs.get_operator()) {
 		return this->get_operator() < rhs.get_operator();
@@ -243,14 +304,12 @@ MTLFormula<APType>::operator<(const MTLFormula &rhs) const
 		return this->get_atomicProposition() < rhs.get_atomicProposition();
 	}
 
-	// Compare intervals before operands.
-	if (operator_ == LOP::LUNTIL || operator_ == LOP::LDUNTIL) {
-		if (duration_ < rhs.duration_) {
-			return true;
-		}
-		if (rhs.duration_ < duration_) {
-			return false;
-		}
+	// Compare intervals before operands, they are only set for until formulas.
+	if (node_->duration < rhs.node_->duration) {
+		return true;
+	}
+	if (rhs.node_->duration < node_->duration) {
+		return false;
 	}
 
 	return std::lexicographical_compare(this->get_operands().begin(),
@@ -262,26 +321,27 @@ template <typename APType>
 MTLFormula<APType>
 MTLFormula<APType>::to_positive_normal_form() const
 {
-	switch (operator_) {
+	const auto &operands = get_operands();
+	switch (get_operator()) {
 	case LOP::TRUE:
 	case LOP::FALSE:
 	case LOP::AP: return *this; break;
 	case LOP::LNEG: {
-		switch (operands_.front().get_operator()) {
+		switch (operands.front().get_operator()) {
 		case LOP::TRUE:
 		case LOP::FALSE:
 		case LOP::AP: return *this; break; // negation in front of ap is conformant
 		case LOP::LNEG:
-			return MTLFormula(operands_.front().get_operands().front())
+			return MTLFormula(operands.front().get_operands().front())
 			  .to_positive_normal_form(); // remove duplicate negations
 			break;
 		case LOP::LAND:
 		case LOP::LOR: {
 			std::vector<MTLFormula<APType>> normalized;
-			for (const auto &op : operands_.front().get_operands()) {
+			for (const auto &op : operands.front().get_operands()) {
 				normalized.push_back(MTLFormula(LOP::LNEG, {op}).to_positive_normal_form());
 			}
-			return MTLFormula(dual(operands_.front().get_operator()),
+			return MTLFormula(dual(operands.front().get_operator()),
 			                  std::begin(normalized),
 			                  std::end(normalized));
 		} break;
@@ -289,12 +349,12 @@ MTLFormula<APType>::to_positive_normal_form() const
 		case LOP::LDUNTIL: {
 			// binary operators: negate operands, use dual operator
 			auto neglhs =
-			  MTLFormula(LOP::LNEG, {operands_.front().get_operands().front()}).to_positive_normal_form();
+			  MTLFormula(LOP::LNEG, {operands.front().get_operands().front()}).to_positive_normal_form();
 			auto negrhs =
-			  MTLFormula(LOP::LNEG, {operands_.front().get_operands().back()}).to_positive_normal_form();
-			return MTLFormula(dual(operands_.front().get_operator()),
+			  MTLFormula(LOP::LNEG, {operands.front().get_operands().back()}).to_positive_normal_form();
+			return MTLFormula(dual(operands.front().get_operator()),
 			                  {neglhs, negrhs},
-			                  operands_.front().get_interval());
+			                  operands.front().get_interval());
 		} break;
 		}
 	} break;
@@ -303,12 +363,10 @@ MTLFormula<APType>::to_positive_normal_form() const
 	case LOP::LUNTIL:
 	case LOP::LDUNTIL: {
 		std::vector<MTLFormula<APType>> normalized;
-		for (const auto &op : operands_) {
+		for (const auto &op : operands) {
 			normalized.push_back(op.to_positive_normal_form());
 		}
-		auto res      = MTLFormula(operator_, std::begin(normalized), std::end(normalized));
-		res.duration_ = duration_;
-		return res;
+		return MTLFormula(get_operator(), std::begin(normalized), std::end(normalized), get_interval());
 	} break;
 	}
 	throw std::logic_error("Error in to_positive_normal_form: should have returned.");
@@ -337,7 +395,7 @@ MTLFormula<APType>::get_subformulas_of_type(LOP op) const
 		res.insert(*this);
 	}
 
-	std::for_each(operands_.begin(), operands_.end(), [&res, op](const MTLFormula &o) {
+	std::for_each(get_operands().begin(), get_operands().end(), [&res, op](const MTLFormula &o) {
 		auto tmp = o.get_subformulas_of_type(op);
 		res.insert(tmp.begin(), tmp.end());
 	});
@@ -349,30 +407,32 @@ template <typename APType>
 Endpoint
 MTLFormula<APType>::get_largest_constant() const
 {
-	Endpoint largest_constant = 0;
-	switch (operator_) {
+	Endpoint    largest_constant = 0;
+	const auto &operands         = get_operands();
+	const auto &duration         = node_->duration;
+	switch (get_operator()) {
 	case LOP::AP:
 	case LOP::TRUE:
 	case LOP::FALSE: largest_constant = 0; break;
-	case LOP::LNEG: largest_constant = operands_[0].get_largest_constant(); break;
+	case LOP::LNEG: largest_constant = operands[0].get_largest_constant(); break;
 	case LOP::LAND:
 	case LOP::LOR:
-		for (const auto &sub_formula : operands_) {
+		for (const auto &sub_formula : operands) {
 			largest_constant = std::max(0u, sub_formula.get_largest_constant());
 		}
 		break;
 	case LOP::LUNTIL:
 	case LOP::LDUNTIL: {
-		if (duration_) {
-			if (duration_->upperBoundType() != utilities::arithmetic::BoundType::INFTY) {
-				largest_constant = std::max(largest_constant, duration_->upper());
+		if (duration) {
+			if (duration->upperBoundType() != utilities::arithmetic::BoundType::INFTY) {
+				largest_constant = std::max(largest_constant, duration->upper());
 			}
-			if (duration_->lowerBoundType() != utilities::arithmetic::BoundType::INFTY) {
-				largest_constant = std::max(largest_constant, duration_->lower());
+			if (duration->lowerBoundType() != utilities::arithmetic::BoundType::INFTY) {
+				largest_constant = std::max(largest_constant, duration->lower());
 			}
 		}
 		largest_constant = std::max(
-		  {largest_constant, operands_[0].get_largest_constant(), operands_[1].get_largest_constant()});
+		  {largest_constant, operands[0].get_largest_constant(), operands[1].get_largest_constant()});
 		break;
 	}
 	}
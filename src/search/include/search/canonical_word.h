@@ -16,9 +16,12 @@
 // TODO Regions should not be TA-specific
 #include "automata/ta_regions.h"
 #include "mtl/MTLFormula.h"
+#include "utilities/hash.h"
 #include "utilities/numbers.h"
 #include "utilities/types.h"
 
+#include <memory>
+
 /** Get the regionalized synchronous product of a TA and an ATA. */
 namespace tacos::search {
 
@@ -59,12 +62,14 @@ struct CanonicalABZoneWord {
 	 * @param plant_configuration The Configuration of the Plant
 	 * @param ata_configuration The configuration of the ATA
 	 * @param K The maximal constant that can appear in this word
+	 * @param registry The registry the DBM uses to translate clock names to IDs
 	 * @return A CanonicalABZoneWord where the zones correspond to there the real value is. E.g. if x := 2.5, then the zone is (2,3)
 	 */
 	CanonicalABZoneWord(const PlantConfiguration<LocationT>          &plant_configuration,
 						const ATAConfiguration<ConstraintSymbolT>    &ata_configuration,
-						const unsigned int                            K)
-	: dbm(zones::Zone_DBM{std::set<std::string>{}, K})
+						const unsigned int                            K,
+						std::shared_ptr<zones::ClockRegistry>         registry = zones::ClockRegistry::get_default())
+	: dbm(zones::Zone_DBM{std::set<std::string>{}, K, false, std::move(registry)})
 	{
 		//TA-Part
 		ta_location = plant_configuration.location;
@@ -85,8 +90,8 @@ struct CanonicalABZoneWord {
 
 		//ATA Part
 		for(const auto &state : ata_configuration) {
-			add_ata_location(state.location, false);
-			std::string clock_name = ata_formula_to_string(state.location);
+			zones::ClockID clock_name = dbm.get_clock_id(ata_formula_to_string(state.location));
+			add_ata_location(state.location, clock_name, false);
 
 			Time valuation = state.clock_valuation;
 			//Check whether there isn't a fractional part.
@@ -120,10 +125,23 @@ struct CanonicalABZoneWord {
 	 * @return True if successful, false if something went wrong, e.g. ATA location already exists
 	 */
 	bool add_ata_location(logic::MTLFormula<ConstraintSymbolT> new_location, bool reset_new_clock = true) {
+		return add_ata_location(new_location, dbm.get_clock_id(ata_formula_to_string(new_location)), reset_new_clock);
+	}
+
+	/**
+	 * Adds a new ata_location to this Canonical Word, whose clock has already been looked up.
+	 * 
+	 * @param new_location The new location
+	 * @param clock The ID of the clock of the new location in the registry of the DBM
+	 * @param reset_new_clock Whether the new clock should immediately be reset to equal 0. Default is true
+	 * @return True if successful, false if something went wrong, e.g. ATA location already exists
+	 */
+	bool add_ata_location(const logic::MTLFormula<ConstraintSymbolT> &new_location, zones::ClockID clock, bool reset_new_clock = true) {
 		//Check whether successful or not
-		if(ata_locations.insert(new_location).second && dbm.add_clock(ata_formula_to_string(new_location))) {
+		if(ata_locations.insert(new_location).second && dbm.add_clock(clock)) {
+			clear_cache();
 			if(reset_new_clock) {
-				dbm.reset(ata_formula_to_string(new_location));
+				dbm.reset(clock);
 			}
 
 			return true;
@@ -168,6 +186,158 @@ struct CanonicalABZoneWord {
 	 * @return A CanonicalABWord
 	 */
 	operator CanonicalABWord<LocationT, ConstraintSymbolT>() const
+	{
+		return get_ab_word();
+	}
+
+	/**
+	 * Get this word as a CanonicalABWord, see the conversion operator.
+	 * It is computed on the first call and cached until the DBM or the ATA locations change.
+	 *
+	 * @return A reference to the cached CanonicalABWord, valid until this word is changed
+	 */
+	const CanonicalABWord<LocationT, ConstraintSymbolT> &
+	get_ab_word() const
+	{
+		return ab_word_cache_.get(dbm, [this]() { return compute_ab_word(); });
+	}
+
+	/**
+	 * Get reg_a of this word, i.e. this word without its ATA locations, see search::reg_a().
+	 * It is computed on the first call and cached until the DBM changes.
+	 *
+	 * @return A reference to the cached word, valid until this word is changed
+	 */
+	const CanonicalABZoneWord &
+	get_reg_a() const
+	{
+		return reg_a_cache_.get(dbm, [this]() {
+			return CanonicalABZoneWord{ta_location, ta_clocks, {}, dbm.get_subset(ta_clocks)};
+		});
+	}
+
+	/** Compress the DBM of this word, see zones::Zone_DBM::compress(). This also drops the cached conversions, which
+	 * would otherwise keep the uncompressed matrix alive.
+	 *
+	 * @param pool If given, the minimal constraints are shared with equal DBMs compressed by this pool, see
+	 * zones::DBM_Pool::compress()
+	 */
+	void
+	compress(zones::DBM_Pool *pool = nullptr)
+	{
+		if(pool != nullptr) {
+			pool->compress(dbm);
+		} else {
+			dbm.compress();
+		}
+		clear_cache();
+	}
+
+	/** Drop the cached conversions of this word. Their DBMs share the matrix of this word, which thus has to be copied
+	 * on the next change, so the conversions should not be kept once they are no longer needed. Must not be called
+	 * while a reference returned by get_ab_word() or get_reg_a() is still in use.
+	 */
+	void
+	clear_cache() const
+	{
+		ab_word_cache_.clear();
+		reg_a_cache_.clear();
+	}
+
+	/** Check whether this word is subsumed by another word, i.e. both have the same locations and clocks, and the zone
+	 * of this word is included in the zone of the other word.
+	 * 
+	 * @param other The word that may subsume this one
+	 * @return true if every configuration of this word is also a configuration of the other word
+	 */
+	bool
+	is_subsumed_by(const CanonicalABZoneWord &other) const
+	{
+		return ta_location == other.ta_location && ta_clocks == other.ta_clocks &&
+			   ata_locations == other.ata_locations && dbm.is_included_in(other.dbm);
+	}
+
+	/** Get the hash of this word. The hashes of the DBM and the ATA locations are cached, so this is cheap compared
+	 * to comparing words.
+	 */
+	std::size_t
+	hash() const
+	{
+		std::size_t seed = 0;
+		utilities::hash_combine(seed, ta_location);
+		utilities::hash_combine(seed, ta_clocks);
+		utilities::hash_combine(seed, ata_locations);
+		utilities::hash_combine(seed, dbm);
+		return seed;
+	}
+
+	/** Check two CanonicalABZoneWords for equality.
+	 * They must share the same ta_location, ta_clocks, ata_locations, and the same DBM and max_constant
+	 * @param s1 The first word
+	 * @param s2 The second word
+	 * @return true if s1 is equal to s2
+	 */
+	friend bool
+	operator<(const CanonicalABZoneWord &s1, const CanonicalABZoneWord &s2) {
+		return  std::tie(s1.ta_location, s1.ta_clocks, s1.ata_locations, s1.dbm) <
+				std::tie(s2.ta_location, s2.ta_clocks, s2.ata_locations, s2.dbm);
+	}
+
+	/** Check two CanonicalABZoneWords for equality.
+	 * They must share the same ta_location, ta_clocks, ata_locations, and the same DBM and max_constant
+	 * @param s1 The first word
+	 * @param s2 The second word
+	 * @return true if s1 is equal to s2
+	 */
+	friend bool
+	operator==(const CanonicalABZoneWord &s1, const CanonicalABZoneWord &s2) {
+		return  s1.ta_location == s2.ta_location && s1.ta_clocks == s2.ta_clocks &&
+				s1.ata_locations == s2.ata_locations && s1.dbm == s2.dbm;
+	}
+
+	/** Check two CanonicalABZoneWords for inequality.
+	 * 
+	 * @param s1 The first word
+	 * @param s2 The second word
+	 * @return true if s1 is not equal to s2
+	 */
+	friend bool
+	operator!=(const CanonicalABZoneWord &s1, const CanonicalABZoneWord &s2) {
+		return !(s1 == s2);
+	}
+
+	friend std::ostream &
+	operator<<(std::ostream &os, const CanonicalABZoneWord &word) {
+		os << "[ {TA: " << word.ta_location << " | ";
+		bool first = true;
+		for(const auto &clock : word.ta_clocks) {
+			if(first) {
+				os << clock << ": " << word.dbm.get_zone_slice(clock);
+				first = false;
+			} else {
+				os << ", " << clock << ": " << word.dbm.get_zone_slice(clock);
+			}
+		}
+		os << " }";
+
+		os << "{ATA: ";
+		first = true;
+		for(const auto &ata_location : word.ata_locations) {
+			if(first) {
+				os << ata_location << ": " << word.dbm.get_zone_slice(ata_formula_to_string(ata_location));
+			} else {
+				os << ", " << ata_location << ": " << word.dbm.get_zone_slice(ata_formula_to_string(ata_location));
+			}
+		}
+		os << " } ]";
+
+		return os;
+	}
+
+private:
+	/** Compute the CanonicalABWord of this word, see get_ab_word() */
+	CanonicalABWord<LocationT, ConstraintSymbolT>
+	compute_ab_word() const
 	{
 		CanonicalABWord<LocationT, ConstraintSymbolT> ab_word;
 
@@ -250,68 +420,81 @@ struct CanonicalABZoneWord {
 		return ab_word;
 	}
 
-	/** Check two CanonicalABZoneWords for equality.
-	 * They must share the same ta_location, ta_clocks, ata_locations, and the same DBM and max_constant
-	 * @param s1 The first word
-	 * @param s2 The second word
-	 * @return true if s1 is equal to s2
+	/** A value computed from a word that stays valid as long as the DBM of the word shares its matrix with the DBM
+	 * the value was computed for. Holding that DBM keeps its matrix from being changed in place, so any change of the
+	 * DBM replaces the matrix and thus invalidates the value. Copies of a word start without cached values.
+	 * Values may be computed concurrently by several readers of the same word, only the first one is kept.
 	 */
-	friend bool
-	operator<(const CanonicalABZoneWord &s1, const CanonicalABZoneWord &s2) {
-		return  std::tie(s1.ta_location, s1.ta_clocks, s1.ata_locations, s1.dbm) <
-				std::tie(s2.ta_location, s2.ta_clocks, s2.ata_locations, s2.dbm);
-	}
-
-	/** Check two CanonicalABZoneWords for equality.
-	 * They must share the same ta_location, ta_clocks, ata_locations, and the same DBM and max_constant
-	 * @param s1 The first word
-	 * @param s2 The second word
-	 * @return true if s1 is equal to s2
-	 */
-	friend bool
-	operator==(const CanonicalABZoneWord &s1, const CanonicalABZoneWord &s2) {
-		return  s1.ta_location == s2.ta_location && s1.ta_clocks == s2.ta_clocks &&
-				s1.ata_locations == s2.ata_locations && s1.dbm == s2.dbm;
-	}
-
-	/** Check two CanonicalABZoneWords for inequality.
-	 * 
-	 * @param s1 The first word
-	 * @param s2 The second word
-	 * @return true if s1 is not equal to s2
-	 */
-	friend bool
-	operator!=(const CanonicalABZoneWord &s1, const CanonicalABZoneWord &s2) {
-		return !(s1 == s2);
-	}
+	template <typename T>
+	class Cache
+	{
+	public:
+		Cache() = default;
+		Cache(const Cache &)
+		{
+		}
+		Cache(Cache &&other) noexcept : entry_(std::move(other.entry_))
+		{
+		}
+		Cache &
+		operator=(const Cache &)
+		{
+			clear();
+			return *this;
+		}
+		Cache &
+		operator=(Cache &&other) noexcept
+		{
+			entry_ = std::move(other.entry_);
+			return *this;
+		}
 
-	friend std::ostream &
-	operator<<(std::ostream &os, const CanonicalABZoneWord &word) {
-		os << "[ {TA: " << word.ta_location << " | ";
-		bool first = true;
-		for(const auto &clock : word.ta_clocks) {
-			if(first) {
-				os << clock << ": " << word.dbm.get_zone_slice(clock);
-				first = false;
-			} else {
-				os << ", " << clock << ": " << word.dbm.get_zone_slice(clock);
+		/** Get the value for the given DBM, computing it if there is no valid one */
+		template <typename Compute>
+		const T &
+		get(const zones::Zone_DBM &dbm, Compute compute) const
+		{
+			auto entry = std::atomic_load(&entry_);
+			if(entry != nullptr && is_valid(*entry, dbm)) {
+				return entry->value;
+			}
+			auto computed = std::make_shared<const Entry>(Entry{dbm, compute()});
+			if(std::atomic_compare_exchange_strong(&entry_, &entry, computed)) {
+				return computed->value;
 			}
+			//Another reader has been faster
+			assert(is_valid(*entry, dbm));
+			return entry->value;
 		}
-		os << " }";
 
-		os << "{ATA: ";
-		first = true;
-		for(const auto &ata_location : word.ata_locations) {
-			if(first) {
-				os << ata_location << ": " << word.dbm.get_zone_slice(ata_formula_to_string(ata_location));
-			} else {
-				os << ", " << ata_location << ": " << word.dbm.get_zone_slice(ata_formula_to_string(ata_location));
-			}
+		/** Drop the cached value */
+		void
+		clear() const
+		{
+			std::atomic_store(&entry_, std::shared_ptr<const Entry>{});
 		}
-		os << " } ]";
 
-		return os;
-	}
+	private:
+		struct Entry
+		{
+			zones::Zone_DBM dbm;
+			T               value;
+		};
+
+		static bool
+		is_valid(const Entry &entry, const zones::Zone_DBM &dbm)
+		{
+			//A DBM without any clocks has no matrix to share, but it can't be changed without getting one
+			const bool same_matrix = dbm.shares_matrix_with(entry.dbm)
+			                         || (!dbm.shares_matrix_with(dbm) && !entry.dbm.shares_matrix_with(entry.dbm));
+			return same_matrix && dbm.max_constant_ == entry.dbm.max_constant_;
+		}
+
+		mutable std::shared_ptr<const Entry> entry_;
+	};
+
+	Cache<CanonicalABWord<LocationT, ConstraintSymbolT>> ab_word_cache_;
+	Cache<CanonicalABZoneWord>                           reg_a_cache_;
 };
 
 /** Get the clock valuation for an ABSymbol, which is either a TA state or an ATA state.
@@ -834,6 +1017,59 @@ get_canonical_word(const PlantConfiguration<Location>           &plant_configura
 	
 }
 
+/** Merge zone words that share their locations and clocks.
+ *
+ * The zones of all words with the same locations form a federation, which is reduced, such that no remaining word is
+ * subsumed by another one and no two remaining words have a convex union. The configurations of all words stay the
+ * same, but there are fewer words.
+ * @param words The words to merge
+ * @param pool If given, the DBMs of merged words are interned in this pool
+ * @return The merged words
+ */
+template <typename Location, typename ConstraintSymbolType>
+std::set<CanonicalABZoneWord<Location, ConstraintSymbolType>>
+merge_zone_words(const std::set<CanonicalABZoneWord<Location, ConstraintSymbolType>> &words,
+                 zones::DBM_Pool                                                     *pool = nullptr)
+{
+	using Word = CanonicalABZoneWord<Location, ConstraintSymbolType>;
+
+	//Words are ordered by their locations and clocks first, so words with the same ones are adjacent
+	auto has_same_locations = [](const Word &word1, const Word &word2) {
+		return word1.ta_location == word2.ta_location && word1.ta_clocks == word2.ta_clocks
+		       && word1.ata_locations == word2.ata_locations;
+	};
+
+	std::set<Word> merged;
+	for (auto first = words.begin(); first != words.end();) {
+		auto last = std::find_if(std::next(first), words.end(), [&](const Word &word) {
+			return !has_same_locations(word, *first);
+		});
+		if (std::next(first) == last) {
+			merged.insert(merged.end(), *first);
+			first = last;
+			continue;
+		}
+
+		zones::Federation federation;
+		for (auto word = first; word != last; ++word) {
+			federation.add(word->dbm);
+		}
+		federation.reduce();
+
+		for (const auto &zone : federation) {
+			Word word = *first;
+			word.dbm  = zone;
+			if (pool != nullptr) {
+				pool->intern(word.dbm);
+			}
+			merged.insert(std::move(word));
+		}
+		first = last;
+	}
+
+	return merged;
+}
+
 /** Print an ABRegionSymbol. */
 template <typename LocationT, typename ConstraintSymbolType>
 std::ostream &
@@ -1056,6 +1292,25 @@ operator<<(std::ostream
 
 } // namespace tacos::search
 
+namespace std {
+
+/** Hash a CanonicalABZoneWord, see tacos::search::CanonicalABZoneWord::hash().
+ * A CanonicalABWord is a vector of sets of region symbols and can be hashed element-wise with
+ * tacos::utilities::hash_value.
+ */
+template <typename LocationT, typename ConstraintSymbolT>
+struct hash<tacos::search::CanonicalABZoneWord<LocationT, ConstraintSymbolT>>
+{
+	/** Get the hash of the word */
+	std::size_t
+	operator()(const tacos::search::CanonicalABZoneWord<LocationT, ConstraintSymbolT> &word) const
+	{
+		return word.hash();
+	}
+};
+
+} // namespace std
+
 namespace fmt {
 
 template <typename LocationT, typename ConstraintSymbolType>
@@ -0,0 +1,80 @@
+/***************************************************************************
+ *  clock_registry.h - Dense integer IDs for the clocks of a zone search
+ *
+ *  SPDX-License-Identifier: LGPL-3.0-or-later
+ ****************************************************************************/
+
+#pragma once
+
+#include "automata/automata_zones.h"
+#include "mtl/MTLFormula.h"
+#include "symbolic_state.h"
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+
+namespace tacos::search {
+
+/** Interns the clocks of a zone search to dense integer IDs.
+ *
+ * TA clocks are interned by their names. ATA clocks are named after their location, so each ATA location is printed
+ * with ata_formula_to_string only once and afterwards looked up by the formula itself.
+ * IDs are only comparable between DBMs that use the same name registry. By default each registry has its own name
+ * registry, so the IDs of one search are dense and don't depend on earlier searches in the same process. Words that
+ * are handed to the search have to use get_clock_names().
+ * The registry may be shared between threads.
+ */
+template <typename ConstraintSymbolT>
+class ClockRegistry
+{
+public:
+	/** Create a registry that interns names in the given name registry */
+	explicit ClockRegistry(
+	  std::shared_ptr<zones::ClockRegistry> clock_names = std::make_shared<zones::ClockRegistry>())
+	: clock_names_(std::move(clock_names))
+	{
+	}
+
+	/** Get the ID of a TA clock */
+	zones::ClockID
+	get_clock_id(const std::string &clock)
+	{
+		return clock_names_->get_id(clock);
+	}
+
+	/** Get the ID of the clock belonging to an ATA location */
+	zones::ClockID
+	get_clock_id(const logic::MTLFormula<ConstraintSymbolT> &location)
+	{
+		{
+			std::shared_lock lock{mutex_};
+			auto it = ata_clocks_.find(location);
+			if (it != ata_clocks_.end()) {
+				return it->second;
+			}
+		}
+
+		const zones::ClockID id = clock_names_->get_id(ata_formula_to_string(location));
+
+		std::unique_lock lock{mutex_};
+		ata_clocks_.insert({location, id});
+		return id;
+	}
+
+	/** Get the registry of clock names, which is handed to the DBMs */
+	const std::shared_ptr<zones::ClockRegistry> &
+	get_clock_names() const
+	{
+		return clock_names_;
+	}
+
+private:
+	std::shared_ptr<zones::ClockRegistry>                       clock_names_;
+	mutable std::shared_mutex                                   mutex_;
+	std::map<logic::MTLFormula<ConstraintSymbolT>, zones::ClockID> ata_clocks_;
+};
+
+} // namespace tacos::search
@@ -139,7 +139,7 @@ public:
 	ValueT
 	compute_cost(NodeT *node) override
 	{
-		for (const auto &parent : node->parents) {
+		for (const auto &parent : node->get_parents()) {
 			for (const auto &[timed_action, child] : parent->get_children()) {
 				if (child.get() == node
 				    && environment_actions.find(timed_action.second) != std::end(environment_actions)) {
@@ -0,0 +1,240 @@
+/***************************************************************************
+ *  node_table.h - A concurrent table of search nodes
+ *
+ *  SPDX-License-Identifier: LGPL-3.0-or-later
+ ****************************************************************************/
+
+#pragma once
+
+#include "utilities/hash.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+
+namespace tacos::search {
+
+/** A concurrent table of the nodes of a search graph by their keys.
+ *
+ * The table is split into shards by the hash of the keys. Each shard has its own map and lock, so threads that look up
+ * or insert different nodes rarely wait for each other. If the keys are not hashed, the table consists of a single
+ * ordered shard, which also iterates over the nodes deterministically.
+ * Looking up and inserting nodes is thread-safe. Iterating over the table is not synchronized, so it must only happen
+ * while no other thread changes the table, e.g., after the search.
+ *
+ * @tparam Key The key of a node, e.g., its words
+ * @tparam Value The stored node, e.g., a shared pointer to it
+ * @tparam use_hash_table Whether the keys are hashed with utilities::Hash
+ */
+template <typename Key, typename Value, bool use_hash_table>
+class ShardedNodeTable
+{
+public:
+	/** The map of a single shard */
+	using Map = std::conditional_t<use_hash_table,
+	                               std::unordered_map<Key, Value, utilities::Hash>,
+	                               std::map<Key, Value>>;
+	/** The entries of the table */
+	using value_type = typename Map::value_type;
+
+	/** The number of shards. Many more shards than threads make it unlikely that two threads need the same one. */
+	static constexpr std::size_t shard_count = use_hash_table ? 64 : 1;
+
+	/** A forward iterator over all entries of all shards */
+	class const_iterator
+	{
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type        = typename Map::value_type;
+		using difference_type   = std::ptrdiff_t;
+		using pointer           = const value_type *;
+		using reference         = const value_type &;
+
+		/** Get the current entry */
+		reference
+		operator*() const
+		{
+			return *entry_;
+		}
+		/** Access the current entry */
+		pointer
+		operator->() const
+		{
+			return &*entry_;
+		}
+		/** Advance to the next entry, which may be in one of the next shards */
+		const_iterator &
+		operator++()
+		{
+			++entry_;
+			skip_empty_shards();
+			return *this;
+		}
+		/** Advance to the next entry */
+		const_iterator
+		operator++(int)
+		{
+			auto copy = *this;
+			++*this;
+			return copy;
+		}
+		/** Compare two iterators */
+		bool
+		operator==(const const_iterator &other) const
+		{
+			return shard_ == other.shard_ && (shard_ == shard_count || entry_ == other.entry_);
+		}
+		/** Compare two iterators */
+		bool
+		operator!=(const const_iterator &other) const
+		{
+			return !(*this == other);
+		}
+
+	private:
+		friend class ShardedNodeTable;
+		const_iterator(const ShardedNodeTable *table, std::size_t shard) : table_(table), shard_(shard)
+		{
+			if (shard_ < shard_count) {
+				entry_ = table_->shards_[shard_].map.begin();
+				skip_empty_shards();
+			}
+		}
+		void
+		skip_empty_shards()
+		{
+			while (shard_ < shard_count && entry_ == table_->shards_[shard_].map.end()) {
+				if (++shard_ < shard_count) {
+					entry_ = table_->shards_[shard_].map.begin();
+				}
+			}
+		}
+		const ShardedNodeTable      *table_;
+		std::size_t                  shard_;
+		typename Map::const_iterator entry_;
+	};
+
+	/** Find the node of a key.
+	 * @param key The key to look up
+	 * @return The node, or a default-constructed value if there is none
+	 */
+	Value
+	find(const Key &key) const
+	{
+		const auto     &shard = get_shard(key);
+		std::lock_guard lock{shard.mutex};
+		const auto      entry = shard.map.find(key);
+		return entry != shard.map.end() ? entry->second : Value{};
+	}
+
+	/** Insert a node for a key unless the key already has a node.
+	 * @param key The key of the new node
+	 * @param create A function that creates the new node, it is only called if the key doesn't have a node yet
+	 * @return The node of the key and whether it has been created
+	 */
+	template <typename Create>
+	std::pair<Value, bool>
+	insert_if_absent(Key key, Create &&create)
+	{
+		auto           &shard = get_shard(key);
+		std::lock_guard lock{shard.mutex};
+		if (const auto entry = shard.map.find(key); entry != shard.map.end()) {
+			return {entry->second, false};
+		}
+		return {shard.map.emplace(std::move(key), create()).first->second, true};
+	}
+
+	/** Replace the key of an entry by an equal key, e.g., one that uses less memory.
+	 * @param key The current key of the entry
+	 * @param new_key The key to replace it with, it must be equal to key
+	 * @param is_entry Only replace the key if this predicate holds for the value of the entry
+	 */
+	template <typename Predicate>
+	void
+	replace_key(const Key &key, Key new_key, Predicate &&is_entry)
+	{
+		auto           &shard = get_shard(key);
+		std::lock_guard lock{shard.mutex};
+		if (auto entry = shard.map.extract(key); !entry.empty()) {
+			if (is_entry(entry.mapped())) {
+				entry.key() = std::move(new_key);
+			}
+			shard.map.insert(std::move(entry));
+		}
+	}
+
+	/** Replace all entries by a single one */
+	void
+	reset(Key key, Value value)
+	{
+		for (auto &shard : shards_) {
+			std::lock_guard lock{shard.mutex};
+			shard.map.clear();
+		}
+		auto           &shard = get_shard(key);
+		std::lock_guard lock{shard.mutex};
+		shard.map.emplace(std::move(key), std::move(value));
+	}
+
+	/** Get the number of entries */
+	std::size_t
+	size() const
+	{
+		std::size_t size = 0;
+		for (const auto &shard : shards_) {
+			std::lock_guard lock{shard.mutex};
+			size += shard.map.size();
+		}
+		return size;
+	}
+
+	/** Get an iterator to the first entry */
+	const_iterator
+	begin() const
+	{
+		return const_iterator{this, 0};
+	}
+
+	/** Get the end of the entries */
+	const_iterator
+	end() const
+	{
+		return const_iterator{this, shard_count};
+	}
+
+private:
+	/** Shards are aligned to cache lines, so locking one shard doesn't slow down threads using the next one */
+	struct alignas(64) Shard
+	{
+		mutable std::mutex mutex;
+		Map                map;
+	};
+
+	const Shard &
+	get_shard(const Key &key) const
+	{
+		if constexpr (shard_count == 1) {
+			return shards_[0];
+		} else {
+			// Use the high bits of the mixed hash, the maps of the shards use the low bits for their buckets.
+			const std::uint64_t hash = utilities::hash_value(key) * 0x9e3779b97f4a7c15ULL;
+			return shards_[(hash >> 32) % shard_count];
+		}
+	}
+
+	Shard &
+	get_shard(const Key &key)
+	{
+		return const_cast<Shard &>(std::as_const(*this).get_shard(key));
+	}
+
+	std::array<Shard, shard_count> shards_;
+};
+
+} // namespace tacos::search
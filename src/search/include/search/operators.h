@@ -12,12 +12,46 @@
 #include "canonical_word.h"
 
 #include <algorithm>
+#include <map>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_set>
+#include <vector>
 
 namespace tacos::search {
 
 template <typename CanonicalWord, typename LocationT, typename ActionT, typename ConstraintSymbolT>
 class SearchTreeNode;
 
+/** Get the plant location of a region word.
+ * @param word The word, which must contain a plant state
+ * @return The location of the plant states of the word
+ */
+template <typename LocationT, typename ConstraintSymbolT>
+LocationT
+get_plant_location(const CanonicalABWord<LocationT, ConstraintSymbolT> &word)
+{
+	for (const auto &partition : word) {
+		for (const auto &symbol : partition) {
+			if (std::holds_alternative<PlantRegionState<LocationT>>(symbol)) {
+				return std::get<PlantRegionState<LocationT>>(symbol).location;
+			}
+			if (std::holds_alternative<PlantZoneState<LocationT>>(symbol)) {
+				return std::get<PlantZoneState<LocationT>>(symbol).location;
+			}
+		}
+	}
+	throw std::invalid_argument("Word without plant state");
+}
+
+/** Get the plant location of a zone word. */
+template <typename LocationT, typename ConstraintSymbolT>
+const LocationT &
+get_plant_location(const CanonicalABZoneWord<LocationT, ConstraintSymbolT> &word)
+{
+	return word.ta_location;
+}
+
 /**
  * @brief Checks if the word w1 is monotonically dominated by w2.
  * The word w1 is monotonically dominated by w2 if each partition of w1 is a subset of a partition
@@ -53,11 +87,12 @@ is_monotonically_dominated(const CanonicalABWord<LocationT, ConstraintSymbolT> &
 
 /**
  * @brief Checks if the zone word w1 is monotonically dominated by w2.
- * The word w1 is monotonically dominated by w2 if each partition of w1 is a subset of a partition
- * in w2, and those partitions in w2 are strictly monotonically increasing.
+ * This is the zone analogue of domination for region words: both words are in the same TA location, each clock and
+ * ATA location of w1 also occurs in w2, and every valuation of w2 restricted to the clocks of w1 is a valuation of w1.
+ * The check works directly on the DBMs and does not convert the words to region words.
  *
- * @param w1 The word which may be dominated. Must be using zones
- * @param w2 The potentially dominating word. Must also be using zones
+ * @param zone_w1 The word which may be dominated. Must be using zones
+ * @param zone_w2 The potentially dominating word. Must also be using zones
  * @return true if w2 dominates w1.
  * @return false otherwise.
  */
@@ -66,24 +101,20 @@ bool
 is_monotonically_dominated(const CanonicalABZoneWord<LocationT, ConstraintSymbolT> &zone_w1,
                            const CanonicalABZoneWord<LocationT, ConstraintSymbolT> &zone_w2)
 {
-	CanonicalABWord<LocationT, ConstraintSymbolT> w1 = zone_w1;
-	CanonicalABWord<LocationT, ConstraintSymbolT> w2 = zone_w2;
-	auto current_w2_it = w2.begin();
-	for (const auto &w1_partition : w1) {
-		// Find the w2 partition that includes the current w1 partition.
-		const auto next_w2_it =
-		  std::find_if(current_w2_it, w2.end(), [&w1_partition](const auto &w2_partition) {
-			  return std::includes(w2_partition.begin(),
-			                       w2_partition.end(),
-			                       w1_partition.begin(),
-			                       w1_partition.end());
-		  });
-		if (next_w2_it == w2.end()) {
-			return false;
-		}
-		current_w2_it = std::next(next_w2_it);
+	if (zone_w1.ta_location != zone_w2.ta_location) {
+		return false;
 	}
-	return true;
+	if (!std::includes(zone_w2.ta_clocks.begin(),
+	                   zone_w2.ta_clocks.end(),
+	                   zone_w1.ta_clocks.begin(),
+	                   zone_w1.ta_clocks.end())
+	    || !std::includes(zone_w2.ata_locations.begin(),
+	                   zone_w2.ata_locations.end(),
+	                   zone_w1.ata_locations.begin(),
+	                   zone_w1.ata_locations.end())) {
+		return false;
+	}
+	return zone_w2.dbm.is_projection_included_in(zone_w1.dbm);
 }
 
 /**
@@ -138,7 +169,7 @@ is_monotonically_dominated(const std::set<CanonicalABZoneWord<LocationT, Constra
  *
  * @param node Check this node and its ancestors whether its words is monotonically dominated
  * @param words The set of words to compare against the node's words
- * @param seen_nodes A vector of nodes that have already been seen; if the current node has already
+ * @param seen_nodes The nodes that have already been seen; if the current node has already
  * been seen, the check is aborted.
  * @return true if the given node or one of its ancestors is monotonically dominated
  */
@@ -147,18 +178,18 @@ bool
 ancestor_is_monotonically_dominated(
   const SearchTreeNode<CanonicalABWord<LocationT, ConstraintSymbolT>, LocationT, ActionT, ConstraintSymbolT> &               node,
   const std::set<CanonicalABWord<LocationT, ConstraintSymbolT>> &             words,
-  std::vector<const SearchTreeNode<CanonicalABWord<LocationT, ConstraintSymbolT>, LocationT, ActionT, ConstraintSymbolT> *> &seen_nodes)
+  std::unordered_set<const SearchTreeNode<CanonicalABWord<LocationT, ConstraintSymbolT>, LocationT, ActionT, ConstraintSymbolT> *> &seen_nodes)
 {
-	if (std::find(std::begin(seen_nodes), std::end(seen_nodes), &node) != std::end(seen_nodes)) {
+	if (!seen_nodes.insert(&node).second) {
 		return false;
 	}
-	seen_nodes.push_back(&node);
-	return is_monotonically_dominated(node.words, words)
-	       || std::any_of(node.parents.begin(),
-	                      node.parents.end(),
-	                      [&words, &seen_nodes](const auto &parent) {
-		                      return ancestor_is_monotonically_dominated(*parent, words, seen_nodes);
-	                      });
+	if (is_monotonically_dominated(node.words, words)) {
+		return true;
+	}
+	const auto parents = node.get_parents();
+	return std::any_of(parents.begin(), parents.end(), [&words, &seen_nodes](const auto &parent) {
+		return ancestor_is_monotonically_dominated(*parent, words, seen_nodes);
+	});
 	return false;
 }
 
@@ -172,7 +203,7 @@ ancestor_is_monotonically_dominated(
  *
  * @param node Check this node and its ancestors whether its words is monotonically dominated
  * @param words The set of words to compare against the node's words
- * @param seen_nodes A vector of nodes that have already been seen; if the current node has already
+ * @param seen_nodes The nodes that have already been seen; if the current node has already
  * been seen, the check is aborted.
  * @return true if the given node or one of its ancestors is monotonically dominated
  */
@@ -181,18 +212,34 @@ bool
 ancestor_is_monotonically_dominated(
   const SearchTreeNode<CanonicalABZoneWord<LocationT, ConstraintSymbolT>, LocationT, ActionT, ConstraintSymbolT> &               node,
   const std::set<CanonicalABZoneWord<LocationT, ConstraintSymbolT>> &             words,
-  std::vector<const SearchTreeNode<CanonicalABZoneWord<LocationT, ConstraintSymbolT>, LocationT, ActionT, ConstraintSymbolT> *> &seen_nodes)
+  std::unordered_set<const SearchTreeNode<CanonicalABZoneWord<LocationT, ConstraintSymbolT>, LocationT, ActionT, ConstraintSymbolT> *> &seen_nodes)
 {
-	if (std::find(std::begin(seen_nodes), std::end(seen_nodes), &node) != std::end(seen_nodes)) {
+	if (!seen_nodes.insert(&node).second) {
 		return false;
 	}
-	seen_nodes.push_back(&node);
-	return is_monotonically_dominated(node.words, words)
-	       || std::any_of(node.parents.begin(),
-	                      node.parents.end(),
-	                      [&words, &seen_nodes](const auto &parent) {
-		                      return ancestor_is_monotonically_dominated(*parent, words, seen_nodes);
-	                      });
+	bool dominated;
+	{
+		std::shared_lock lock{node.words_mutex};
+		if (std::none_of(node.words.begin(), node.words.end(), [](const auto &word) { return word.dbm.is_compressed(); })) {
+			dominated = is_monotonically_dominated(node.words, words);
+		} else {
+			// The node has already been expanded and compressed, decompress its DBMs once instead of on every access.
+			std::set<CanonicalABZoneWord<LocationT, ConstraintSymbolT>> node_words;
+			for (auto word : node.words) {
+				word.dbm.decompress();
+				node_words.insert(node_words.end(), std::move(word));
+			}
+			lock.unlock();
+			dominated = is_monotonically_dominated(node_words, words);
+		}
+	}
+	if (dominated) {
+		return true;
+	}
+	const auto parents = node.get_parents();
+	return std::any_of(parents.begin(), parents.end(), [&words, &seen_nodes](const auto &parent) {
+		return ancestor_is_monotonically_dominated(*parent, words, seen_nodes);
+	});
 	return false;
 }
 
@@ -203,12 +250,178 @@ template <typename LocationT, typename ActionT, typename ConstraintSymbolT, type
 bool
 dominates_ancestor(SearchTreeNode<CanonicalWord, LocationT, ActionT, ConstraintSymbolT> *node)
 {
-	std::vector<const SearchTreeNode<CanonicalWord, LocationT, ActionT, ConstraintSymbolT> *> seen_nodes = {node};
-	return std::any_of(node->parents.begin(),
-					node->parents.end(),
+	std::unordered_set<const SearchTreeNode<CanonicalWord, LocationT, ActionT, ConstraintSymbolT> *> seen_nodes = {node};
+	const auto parents = node->get_parents();
+	return std::any_of(parents.begin(),
+					parents.end(),
 					[node, &seen_nodes](const auto &parent) {
 						return ancestor_is_monotonically_dominated(*parent, node->words, seen_nodes);
 				});
 }
 
+/** @brief An index of expanded nodes to rule out monotonic domination without walking the ancestors.
+ *
+ * A node can only dominate one of its ancestors if it dominates some expanded node. For each plant location, the index
+ * keeps an antichain of the minimal word sets of the expanded nodes that have a word in that location. Monotonic
+ * domination is transitive, so a set of words dominates some expanded node iff it dominates a node in the antichain of
+ * the location of any of its words. Most nodes don't dominate any expanded node, which is checked against a single
+ * antichain instead of all ancestors. The index may be shared by all worker threads, each antichain has its own lock,
+ * which is only held exclusively to modify the antichain.
+ */
+template <typename CanonicalWord, typename LocationT, typename ActionT, typename ConstraintSymbolT>
+class DominationIndex
+{
+public:
+	/** The type of the indexed nodes */
+	using Node = SearchTreeNode<CanonicalWord, LocationT, ActionT, ConstraintSymbolT>;
+
+	/** Add a node that is being expanded. Its words must not change concurrently, i.e., the caller expands the node.
+	 * @param node The node to add
+	 */
+	void
+	insert(const Node *node)
+	{
+		for (const auto &word : node->words) {
+			Antichain                &antichain = get_antichain(get_plant_location(word));
+			std::vector<const Node *> dominating;
+			std::size_t               version;
+			{
+				std::shared_lock lock{antichain.mutex};
+				if (is_redundant(node, antichain)) {
+					continue;
+				}
+				dominating = get_dominating(node, antichain);
+				version   = antichain.version;
+			}
+			std::unique_lock lock{antichain.mutex};
+			if (antichain.version != version) {
+				// The antichain has changed in the meantime, check again.
+				if (is_redundant(node, antichain)) {
+					continue;
+				}
+				dominating = get_dominating(node, antichain);
+			}
+			antichain.nodes.erase(std::remove_if(antichain.nodes.begin(),
+			                                     antichain.nodes.end(),
+			                                     [&dominating](const Node *other) {
+				                                     return std::find(dominating.begin(), dominating.end(), other)
+				                                            != dominating.end();
+			                                     }),
+			                      antichain.nodes.end());
+			antichain.nodes.push_back(node);
+			++antichain.version;
+		}
+	}
+
+	/** Check whether the given words dominate any indexed node.
+	 * @param words The words of a node
+	 * @return false if the words dominate no indexed node, and therefore no ancestor of their node
+	 */
+	bool
+	dominates_some_node(const std::set<CanonicalWord> &words) const
+	{
+		if (words.empty()) {
+			return true;
+		}
+		const Antichain *antichain;
+		{
+			std::shared_lock lock{mutex_};
+			const auto       it = antichains_.find(get_plant_location(*words.begin()));
+			if (it == antichains_.end()) {
+				return false;
+			}
+			antichain = &it->second;
+		}
+		std::shared_lock lock{antichain->mutex};
+		return std::any_of(antichain->nodes.begin(), antichain->nodes.end(), [&words](const Node *other) {
+			return dominates(words, other);
+		});
+	}
+
+	/** Get the number of nodes in all antichains. */
+	std::size_t
+	size() const
+	{
+		std::shared_lock lock{mutex_};
+		std::size_t      size = 0;
+		for (const auto &[location, antichain] : antichains_) {
+			std::shared_lock antichain_lock{antichain.mutex};
+			size += antichain.nodes.size();
+		}
+		return size;
+	}
+
+private:
+	/** The minimal nodes with a word in some location */
+	struct Antichain
+	{
+		mutable std::shared_mutex mutex;
+		std::vector<const Node *> nodes;
+		/** Incremented on every change, to detect changes between reading and modifying the antichain */
+		std::size_t version{0};
+	};
+
+	/** Get the antichain of a location, which is created if it doesn't exist yet. Antichains are never removed, so the
+	 * reference stays valid. */
+	Antichain &
+	get_antichain(const LocationT &location)
+	{
+		{
+			std::shared_lock lock{mutex_};
+			if (auto it = antichains_.find(location); it != antichains_.end()) {
+				return it->second;
+			}
+		}
+		std::unique_lock lock{mutex_};
+		return antichains_[location];
+	}
+
+	/** Check if the node is already in the antichain or dominates some node of it, the antichain must be locked */
+	static bool
+	is_redundant(const Node *node, const Antichain &antichain)
+	{
+		return std::any_of(antichain.nodes.begin(), antichain.nodes.end(), [node](const Node *other) {
+			return other == node || dominates(node->words, other);
+		});
+	}
+
+	/** Get the nodes of the antichain that dominate the node, the antichain must be locked */
+	static std::vector<const Node *>
+	get_dominating(const Node *node, const Antichain &antichain)
+	{
+		std::vector<const Node *> dominating;
+		for (const Node *other : antichain.nodes) {
+			std::shared_lock words_lock{other->words_mutex};
+			if (is_monotonically_dominated(node->words, other->words)) {
+				dominating.push_back(other);
+			}
+		}
+		return dominating;
+	}
+
+	static bool
+	dominates(const std::set<CanonicalWord> &words, const Node *other)
+	{
+		std::shared_lock words_lock{other->words_mutex};
+		return is_monotonically_dominated(other->words, words);
+	}
+
+	/** Guards the map of antichains, but not the antichains themselves */
+	mutable std::shared_mutex      mutex_;
+	std::map<LocationT, Antichain> antichains_;
+};
+
+/** Check if there is an ancestor that monotonally dominates the given node, using an index to skip the walk over
+ * the ancestors if the node does not dominate any expanded node.
+ * @param node The node to check
+ * @param index The index of all expanded nodes, which include all ancestors of the node
+ */
+template <typename LocationT, typename ActionT, typename ConstraintSymbolT, typename CanonicalWord>
+bool
+dominates_ancestor(SearchTreeNode<CanonicalWord, LocationT, ActionT, ConstraintSymbolT>               *node,
+                   const DominationIndex<CanonicalWord, LocationT, ActionT, ConstraintSymbolT> &index)
+{
+	return index.dominates_some_node(node->words) && dominates_ancestor(node);
+}
+
 } // namespace tacos::search
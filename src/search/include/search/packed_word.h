@@ -0,0 +1,327 @@
+/***************************************************************************
+ *  packed_word.h - A compact encoding of canonical words
+ *
+ *  SPDX-License-Identifier: LGPL-3.0-or-later
+ ****************************************************************************/
+
+#pragma once
+
+#include "automata/automata_zones.h"
+#include "canonical_word.h"
+#include "mtl/MTLFormula.h"
+#include "symbolic_state.h"
+#include "utilities/hash.h"
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <set>
+#include <shared_mutex>
+#include <string>
+#include <variant>
+#include <vector>
+
+namespace tacos::search {
+
+/** The amount of 32 bit units up to which a packed word is stored inline, i.e., four plant region states or six ATA
+ * region states. */
+constexpr std::size_t PACKED_WORD_INLINE_SIZE = 12;
+
+/** A CanonicalABWord packed into a contiguous buffer of 32 bit units.
+ *
+ * Locations, clocks and formulas are replaced by the IDs of a WordPacker, which is needed to unpack the word
+ * again. Packed words are only comparable if they were packed by the same WordPacker.
+ * Each symbol starts with a header unit that holds the kind of the symbol, whether it starts a new partition, and
+ * either its region index or the open flags of its zone slice. The header is followed by the location or formula ID,
+ * the clock ID of plant states, and the endpoints of zone slices.
+ * The hash is computed once on construction.
+ */
+class PackedCanonicalABWord
+{
+public:
+	/** The buffer of a packed word */
+	using Storage = zones::Inline_Array<std::uint32_t, PACKED_WORD_INLINE_SIZE>;
+
+	/** An empty word */
+	PackedCanonicalABWord() = default;
+
+	/** Wrap an already packed buffer */
+	explicit PackedCanonicalABWord(Storage data)
+	: data_(std::move(data)), hash_(utilities::hash_range(data_.begin(), data_.end()))
+	{
+	}
+
+	/** Get the precomputed hash of the word */
+	std::size_t
+	hash() const
+	{
+		return hash_;
+	}
+
+	/** Get the packed buffer */
+	const Storage &
+	get_data() const
+	{
+		return data_;
+	}
+
+	/** Check two packed words for equality */
+	friend bool
+	operator==(const PackedCanonicalABWord &w1, const PackedCanonicalABWord &w2)
+	{
+		return w1.hash_ == w2.hash_ && w1.data_ == w2.data_;
+	}
+
+	/** Check two packed words for inequality */
+	friend bool
+	operator!=(const PackedCanonicalABWord &w1, const PackedCanonicalABWord &w2)
+	{
+		return !(w1 == w2);
+	}
+
+	/** Compare two packed words lexicographically by their buffers */
+	friend bool
+	operator<(const PackedCanonicalABWord &w1, const PackedCanonicalABWord &w2)
+	{
+		return w1.data_ < w2.data_;
+	}
+
+private:
+	Storage     data_;
+	std::size_t hash_{0};
+};
+
+/** Interns the values of a single type to dense IDs. The interner may be shared between threads. */
+template <typename T>
+class Interner
+{
+public:
+	/** Get the ID of a value, interning it if it has not been seen before */
+	std::uint32_t
+	get_id(const T &value)
+	{
+		{
+			std::shared_lock lock{mutex_};
+			if (auto it = ids_.find(value); it != ids_.end()) {
+				return it->second;
+			}
+		}
+		std::unique_lock lock{mutex_};
+		auto [it, inserted] = ids_.insert({value, static_cast<std::uint32_t>(values_.size())});
+		if (inserted) {
+			values_.push_back(value);
+		}
+		return it->second;
+	}
+
+	/** Get the value of an ID */
+	T
+	get_value(std::uint32_t id) const
+	{
+		std::shared_lock lock{mutex_};
+		assert(id < values_.size());
+		return values_[id];
+	}
+
+	/** Get the number of interned values */
+	std::size_t
+	size() const
+	{
+		std::shared_lock lock{mutex_};
+		return values_.size();
+	}
+
+private:
+	mutable std::shared_mutex  mutex_;
+	std::map<T, std::uint32_t> ids_;
+	std::vector<T>             values_;
+};
+
+/** Packs CanonicalABWords into PackedCanonicalABWords and back.
+ *
+ * The packer interns every location, clock and formula it sees, so all words that are compared with each other must
+ * be packed by the same packer. It may be shared between threads.
+ */
+template <typename LocationT, typename ConstraintSymbolT>
+class WordPacker
+{
+public:
+	/** The unpacked word type */
+	using Word = CanonicalABWord<LocationT, ConstraintSymbolT>;
+
+	/** Pack a canonical word */
+	PackedCanonicalABWord
+	pack(const Word &word)
+	{
+		PackedCanonicalABWord::Storage data;
+		for (const auto &partition : word) {
+			bool first_in_partition = true;
+			for (const auto &symbol : partition) {
+				pack_symbol(symbol, first_in_partition, data);
+				first_in_partition = false;
+			}
+		}
+		return PackedCanonicalABWord{std::move(data)};
+	}
+
+	/** Pack each word of a set of words, e.g., the words of a node. The packed words are in the order of the set. */
+	std::vector<PackedCanonicalABWord>
+	pack(const std::set<Word> &words)
+	{
+		std::vector<PackedCanonicalABWord> packed;
+		packed.reserve(words.size());
+		for (const auto &word : words) {
+			packed.push_back(pack(word));
+		}
+		return packed;
+	}
+
+	/** Unpack a word that has been packed by this packer */
+	Word
+	unpack(const PackedCanonicalABWord &packed) const
+	{
+		Word        word;
+		const auto &data = packed.get_data();
+		for (std::size_t i = 0; i < data.size();) {
+			const std::uint32_t header = data[i++];
+			if (header & NEW_PARTITION || word.empty()) {
+				word.emplace_back();
+			}
+			auto &partition = word.back();
+			switch (header & KIND_MASK) {
+			case PLANT_REGION: {
+				const auto location = locations_.get_value(data[i]);
+				const auto clock    = clocks_.get_value(data[i + 1]);
+				i += 2;
+				partition.insert(PlantRegionState<LocationT>{location, clock, header >> PAYLOAD_SHIFT});
+				break;
+			}
+			case ATA_REGION:
+				partition.insert(ATARegionState<ConstraintSymbolT>{formulas_.get_value(data[i++]),
+				                                                   header >> PAYLOAD_SHIFT});
+				break;
+			case PLANT_ZONE: {
+				const auto location = locations_.get_value(data[i]);
+				const auto clock    = clocks_.get_value(data[i + 1]);
+				const auto slice    = unpack_zone_slice(header, &data[i + 2]);
+				i += 2 + ZONE_SLICE_SIZE;
+				partition.insert(PlantZoneState<LocationT>{location, clock, slice});
+				break;
+			}
+			case ATA_ZONE: {
+				const auto formula = formulas_.get_value(data[i]);
+				const auto slice   = unpack_zone_slice(header, &data[i + 1]);
+				i += 1 + ZONE_SLICE_SIZE;
+				partition.insert(ATAZoneState<ConstraintSymbolT>{formula, slice});
+				break;
+			}
+			}
+		}
+		return word;
+	}
+
+	/** Unpack each word of a set of packed words */
+	std::set<Word>
+	unpack(const std::vector<PackedCanonicalABWord> &packed) const
+	{
+		std::set<Word> words;
+		for (const auto &word : packed) {
+			words.insert(unpack(word));
+		}
+		return words;
+	}
+
+private:
+	static constexpr std::uint32_t KIND_MASK      = 0b11;
+	static constexpr std::uint32_t PLANT_REGION   = 0;
+	static constexpr std::uint32_t ATA_REGION     = 1;
+	static constexpr std::uint32_t PLANT_ZONE     = 2;
+	static constexpr std::uint32_t ATA_ZONE       = 3;
+	static constexpr std::uint32_t NEW_PARTITION  = 1 << 2;
+	static constexpr std::uint32_t LOWER_OPEN     = 1 << 3;
+	static constexpr std::uint32_t UPPER_OPEN     = 1 << 4;
+	static constexpr unsigned int  PAYLOAD_SHIFT  = 5;
+	static constexpr std::size_t   ZONE_SLICE_SIZE = 3;
+
+	void
+	pack_symbol(const ABRegionSymbol<LocationT, ConstraintSymbolT> &symbol,
+	            bool                                                 first_in_partition,
+	            PackedCanonicalABWord::Storage                      &data)
+	{
+		const std::uint32_t partition_flag = first_in_partition ? NEW_PARTITION : 0;
+		if (const auto *state = std::get_if<PlantRegionState<LocationT>>(&symbol)) {
+			data.push_back(PLANT_REGION | partition_flag | pack_region_index(state->symbolic_valuation));
+			data.push_back(locations_.get_id(state->location));
+			data.push_back(clocks_.get_id(state->clock));
+		} else if (const auto *state = std::get_if<ATARegionState<ConstraintSymbolT>>(&symbol)) {
+			data.push_back(ATA_REGION | partition_flag | pack_region_index(state->symbolic_valuation));
+			data.push_back(formulas_.get_id(state->location));
+		} else if (const auto *state = std::get_if<PlantZoneState<LocationT>>(&symbol)) {
+			data.push_back(PLANT_ZONE | partition_flag | pack_open_flags(state->symbolic_valuation));
+			data.push_back(locations_.get_id(state->location));
+			data.push_back(clocks_.get_id(state->clock));
+			pack_zone_slice(state->symbolic_valuation, data);
+		} else {
+			const auto &ata_state = std::get<ATAZoneState<ConstraintSymbolT>>(symbol);
+			data.push_back(ATA_ZONE | partition_flag | pack_open_flags(ata_state.symbolic_valuation));
+			data.push_back(formulas_.get_id(ata_state.location));
+			pack_zone_slice(ata_state.symbolic_valuation, data);
+		}
+	}
+
+	static std::uint32_t
+	pack_region_index(RegionIndex region_index)
+	{
+		assert(region_index < (std::uint32_t{1} << (32 - PAYLOAD_SHIFT)));
+		return region_index << PAYLOAD_SHIFT;
+	}
+
+	static std::uint32_t
+	pack_open_flags(const zones::Zone_slice &slice)
+	{
+		return (slice.lower_isOpen_ ? LOWER_OPEN : 0) | (slice.upper_isOpen_ ? UPPER_OPEN : 0);
+	}
+
+	static void
+	pack_zone_slice(const zones::Zone_slice &slice, PackedCanonicalABWord::Storage &data)
+	{
+		data.push_back(slice.lower_bound_);
+		data.push_back(slice.upper_bound_);
+		data.push_back(slice.max_constant_);
+	}
+
+	static zones::Zone_slice
+	unpack_zone_slice(std::uint32_t header, const std::uint32_t *endpoints)
+	{
+		zones::Zone_slice slice{0, 0, false, false, 0};
+		// Set the members directly, the constructor would clamp the upper bound to the maximal constant.
+		slice.lower_bound_  = endpoints[0];
+		slice.upper_bound_  = endpoints[1];
+		slice.max_constant_ = endpoints[2];
+		slice.lower_isOpen_ = header & LOWER_OPEN;
+		slice.upper_isOpen_ = header & UPPER_OPEN;
+		return slice;
+	}
+
+	Interner<LocationT>                          locations_;
+	Interner<std::string>                        clocks_;
+	Interner<logic::MTLFormula<ConstraintSymbolT>> formulas_;
+};
+
+} // namespace tacos::search
+
+namespace std {
+/** Hash a packed word by its precomputed hash */
+template <>
+struct hash<tacos::search::PackedCanonicalABWord>
+{
+	std::size_t
+	operator()(const tacos::search::PackedCanonicalABWord &word) const
+	{
+		return word.hash();
+	}
+};
+} // namespace std
@@ -49,15 +49,13 @@ reg_a(const CanonicalABWord<Location, ConstraintSymbolType> &word)
  * This is for zone.
  * @param word The zone word to compute reg_a(word) of
  * @return The word reg_a(word), which is the same as word, but without any configurations from the
- * ATA
+ * ATA. It is cached in the word, so the reference is valid until the word is changed
  */
 template <typename Location, typename ConstraintSymbolType>
-CanonicalABZoneWord<Location, ConstraintSymbolType>
+const CanonicalABZoneWord<Location, ConstraintSymbolType> &
 reg_a(const CanonicalABZoneWord<Location, ConstraintSymbolType> &word)
 {
-	auto new_dbm = word.dbm.get_subset(word.ta_clocks);
-
-	return CanonicalABZoneWord<Location, ConstraintSymbolType>{word.ta_location, word.ta_clocks, {}, new_dbm};
+	return word.get_reg_a();
 }
 
 } // namespace tacos::search
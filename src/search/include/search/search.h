@@ -13,25 +13,39 @@
 #include "automata/ata.h"
 #include "automata/ta.h"
 #include "canonical_word.h"
+#include "clock_registry.h"
 #include "heuristics.h"
 #include "mtl/MTLFormula.h"
 #include "mtl_ata_translation/translator.h"
+#include "node_table.h"
 #include "operators.h"
+#include "packed_word.h"
 #include "reg_a.h"
 #include "search_tree.h"
 #include "synchronous_product.h"
+#include "utilities/hash.h"
+#include "utilities/multi_queue_pool.h"
 #include "utilities/priority_thread_pool.h"
 #include "utilities/type_traits.h"
 #include "utilities/types.h"
+#include "utilities/work_stealing_pool.h"
 
 #include <fmt/ranges.h>
 #include <spdlog/spdlog.h>
 
 #include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
 #include <iterator>
 #include <limits>
 #include <memory>
+#include <mutex>
 #include <queue>
+#include <shared_mutex>
+#include <type_traits>
+#include <unordered_map>
 #include <variant>
 
 /** @brief The search algorithm.
@@ -207,6 +221,9 @@ label_graph(SearchTreeNode<CanonicalWord, Location, ActionType, ConstraintSymbol
  * This abstract class implements the main algorithm to check the existence of a controller. It builds a
  * search graph following the transitions of the plant (e.g., the TA) and the ATA and then labels
  * nodes recursively bottom-up.
+ * Nodes are expanded by the jobs of a JobPool, either utilities::ThreadPool with a single priority queue, or
+ * utilities::WorkStealingPool with a queue per worker, or utilities::MultiQueuePool with a relaxed priority queue. The
+ * latter two scale better, but only expand nodes in approximate order of the heuristic.
  */
 template <typename Location,
           typename ActionType,
@@ -216,7 +233,9 @@ template <typename Location,
             automata::ta::TimedAutomaton<typename Location::UnderlyingType, ActionType>,
           bool use_set_semantics = false,
 		  typename Node = SearchTreeNode<CanonicalABWord<Location, ConstraintSymbolType>, Location, ActionType, ConstraintSymbolType>,
-		  typename CanonicalWord = CanonicalABWord<Location, ConstraintSymbolType>>
+		  typename CanonicalWord = CanonicalABWord<Location, ConstraintSymbolType>,
+		  bool use_ordered_node_table = false,
+		  template <class, class> class JobPool = utilities::ThreadPool>
 class TreeSearch
 {
 public:
@@ -229,6 +248,123 @@ public:
 	    utilities::values_equal<use_set_semantics, true, std::set<ConstraintSymbolType>>,
 	    std::void_t<void>>::type;
 
+	/** Whether the nodes are stored in a hash table. This needs hashable plant locations, otherwise and if
+	 * use_ordered_node_table is set, an ordered map is used, which iterates over the nodes deterministically. */
+	static constexpr bool use_node_hash_table = !use_ordered_node_table && utilities::is_hashable_v<Location>;
+
+	/** Whether the node table is keyed by packed words, which only need a fraction of the memory of the words
+	 * themselves. Zone words are not packed, as their DBMs are already shared with the nodes. Packed words are
+	 * ordered by interned IDs, which depend on the order in which the workers intern them, so an ordered node table
+	 * keeps the words themselves as keys. */
+	static constexpr bool use_packed_node_keys =
+	  !use_ordered_node_table && std::is_same_v<CanonicalWord, CanonicalABWord<Location, ConstraintSymbolType>>;
+
+	/** The key of a node in the node table, see get_words() to unpack it */
+	using NodeKey = std::conditional_t<use_packed_node_keys,
+	                                   std::vector<PackedCanonicalABWord>,
+	                                   std::set<CanonicalWord>>;
+
+	/** Successors of the words of a node that are computed in chunks, both by the worker that expands the node and
+	 * by other workers of the pool, see compute_successors(). The task is shared by reference counting, because jobs
+	 * that run late may still hold it after the expanding worker is done. */
+	class SuccessorTask
+	{
+	public:
+		/** Create a task with the given number of chunks, initially only referenced by its creator */
+		explicit SuccessorTask(std::size_t chunk_count) : chunk_count_(chunk_count)
+		{
+		}
+		virtual ~SuccessorTask() = default;
+		/** Compute chunks until every chunk has been claimed by some thread.
+		 * An exception thrown by a chunk is kept and rethrown by wait(). */
+		void
+		run()
+		{
+			for (std::size_t chunk = next_chunk_++; chunk < chunk_count_; chunk = next_chunk_++) {
+				std::exception_ptr exception;
+				try {
+					run_chunk(chunk);
+				} catch (...) {
+					exception = std::current_exception();
+				}
+				std::lock_guard lock{mutex_};
+				if (exception && !exception_) {
+					exception_ = exception;
+				}
+				if (++finished_chunks_ == chunk_count_) {
+					finished_.notify_all();
+				}
+			}
+		}
+		/** Wait for the chunks claimed by other threads, only call this after run() */
+		void
+		wait()
+		{
+			std::unique_lock lock{mutex_};
+			finished_.wait(lock, [this] { return finished_chunks_ == chunk_count_; });
+			if (exception_) {
+				std::rethrow_exception(exception_);
+			}
+		}
+		/** Add a reference for another job */
+		void
+		acquire()
+		{
+			++references_;
+		}
+		/** Drop a reference, the last one deletes the task */
+		void
+		release()
+		{
+			if (--references_ == 0) {
+				delete this;
+			}
+		}
+
+	protected:
+		/** Compute the successors of a single chunk */
+		virtual void run_chunk(std::size_t chunk) = 0;
+
+	private:
+		const std::size_t        chunk_count_;
+		std::atomic<std::size_t> next_chunk_{0};
+		std::atomic<std::size_t> references_{1};
+		std::mutex               mutex_;
+		std::condition_variable  finished_;
+		std::size_t              finished_chunks_{0};
+		std::exception_ptr       exception_;
+	};
+
+	/** A job of the pool, either expanding a node or helping with the successors of a node. It is a plain tuple of
+	 * pointers, so the pool stores it without a type-erased std::function, which may allocate and is copied with each
+	 * job. */
+	struct ExpansionJob
+	{
+		/** The search that expands the node */
+		TreeSearch *search;
+		/** The node to expand */
+		Node *node;
+		/** If set, help computing these successors instead of expanding a node, the job holds a reference */
+		SuccessorTask *successor_task{nullptr};
+		/** Expand the node or help with the successors */
+		void
+		operator()() const
+		{
+			if (successor_task != nullptr) {
+				successor_task->run();
+				successor_task->release();
+			} else {
+				search->expand_node(node);
+			}
+		}
+	};
+
+	/** The pool that expands the nodes, ordered by the negated cost of the heuristic */
+	using JobQueue = JobPool<long, ExpansionJob>;
+
+	/** The nodes of the search graph by their words, sharded so that worker threads can insert nodes concurrently */
+	using NodeTable = ShardedNodeTable<NodeKey, std::shared_ptr<Node>, use_node_hash_table>;
+
 	/** Initialize the search.
 	 * @param ta The plant to be controlled
 	 * @param ata The specification of undesired behaviors
@@ -239,6 +375,9 @@ public:
 	 * @param terminate_early If true, cancel the children of a node that has already been labeled
 	 * @param search_heuristic The heuristic to use during tree expansion
 	 * @param use_zones Whether to use zones, otherwise regions are used
+	 * @param use_subsumption If true, a child whose zone words are subsumed by an existing node is linked to that node
+	 * @param compress_expanded_nodes If true, the zone words of expanded nodes only keep the minimal constraints of
+	 * their DBMs
 	 */
 	TreeSearch(
 		// const automata::ta::TimedAutomaton<Location, ActionType> *                                ta,
@@ -252,7 +391,9 @@ public:
 		bool                                   terminate_early      = false,
 		std::unique_ptr<Heuristic<long, Node>> search_heuristic =
 			std::make_unique<BfsHeuristic<long, Node>>(),
-		bool                                   use_zones = false)
+		bool                                   use_zones = false,
+		bool                                   use_subsumption = false,
+		bool                                   compress_expanded_nodes = false)
 	: ta_(ta),
 	  ata_(ata),
 	  controller_actions_(controller_actions),
@@ -260,7 +401,9 @@ public:
 	  K_(K),
 	  incremental_labeling_(incremental_labeling),
 	  terminate_early_(terminate_early),
-	  use_zones_(use_zones)
+	  use_zones_(use_zones),
+	  use_subsumption_(use_subsumption),
+	  compress_expanded_nodes_(compress_expanded_nodes)
 	{
 		static_assert(use_location_constraints || std::is_same_v<ActionType, ConstraintSymbolType>);
 		// Assert that the two action sets are disjoint.
@@ -306,7 +449,7 @@ public:
 	void
 	add_node_to_queue(Node *node)
 	{
-		pool_.add_job([this, node] { expand_node(node); }, -heuristic->compute_cost(node));
+		pool_.add_job(ExpansionJob{this, node}, -heuristic->compute_cost(node));
 	}
 
 	/** Build the complete search tree by expanding nodes recursively.
@@ -315,6 +458,7 @@ public:
 	void
 	build_tree(bool multi_threaded = true)
 	{
+		multi_threaded_ = multi_threaded;
 		if (multi_threaded) {
 			pool_.start();
 			pool_.wait();
@@ -334,8 +478,7 @@ public:
 		if (queue_access.empty()) {
 			return false;
 		}
-		auto step_function = std::get<1>(queue_access.top());
-		queue_access.pop();
+		auto step_function = std::get<1>(queue_access.take());
 		step_function();
 		return true;
 	}
@@ -358,6 +501,7 @@ public:
 			SPDLOG_DEBUG("Node {} is BAD", *node);
 			node->label_reason = LabelReason::BAD_NODE;
 			node->state        = NodeState::BAD;
+			compress_words(node);
 			node->is_expanded  = true;
 			node->is_expanding = false;
 			if (incremental_labeling_) {
@@ -369,6 +513,7 @@ public:
 		if (!has_satisfiable_ata_configuration(*node)) {
 			node->label_reason = LabelReason::NO_ATA_SUCCESSOR;
 			node->state        = NodeState::GOOD;
+			compress_words(node);
 			node->is_expanded  = true;
 			node->is_expanding = false;
 			if (incremental_labeling_) {
@@ -377,9 +522,10 @@ public:
 			}
 			return;
 		}
-		if (dominates_ancestor(node)) {
+		if (dominates_ancestor(node, domination_index_)) {
 			node->label_reason = LabelReason::MONOTONIC_DOMINATION;
 			node->state        = NodeState::GOOD;
+			compress_words(node);
 			node->is_expanded  = true;
 			node->is_expanding = false;
 			if (incremental_labeling_) {
@@ -389,12 +535,16 @@ public:
 			return;
 		}
 
+		// The node becomes an ancestor of its children, so it must be indexed before they can be expanded.
+		domination_index_.insert(node);
+
 		std::set<Node *> new_children;
 		std::set<Node *> existing_children;
 		if (node->get_children().empty()) {
 			std::tie(new_children, existing_children) = compute_children(node);
 		}
 
+		compress_words(node);
 		node->is_expanded  = true;
 		node->is_expanding = false;
 		if (node->label == NodeLabel::CANCELED) {
@@ -450,23 +600,147 @@ public:
 	size_t
 	get_size() const
 	{
-		std::lock_guard lock{nodes_mutex_};
 		return nodes_.size();
 	}
 
-	/** Get the current search nodes. */
-	const std::map<std::set<CanonicalWord>, std::shared_ptr<Node>> &
+	/** Get the current search nodes. The table must not be iterated while the search is running. */
+	const NodeTable &
 	get_nodes()
 	{
 		return nodes_;
 	}
 
+	/** Get the words of a key of the node table.
+	 * @param key The key of a node as returned by get_nodes()
+	 * @return The words of the key, unpacked if the keys are packed
+	 */
+	std::set<CanonicalWord>
+	get_words(const NodeKey &key) const
+	{
+		if constexpr (use_packed_node_keys) {
+			return word_packer_.unpack(key);
+		} else {
+			return key;
+		}
+	}
+
+	/** Set the number of words from which the successors of the words of a node are computed in parallel. This only
+	 * has an effect if the tree is built multi-threaded.
+	 * @param threshold The minimal number of words, 0 disables the parallel successor computation
+	 */
+	void
+	set_parallel_successor_threshold(std::size_t threshold)
+	{
+		parallel_successor_threshold_ = threshold;
+	}
+
+	/** Set the number of workers that build the tree if it is built multi-threaded. By default, there is one worker
+	 * per hardware thread. This must be called before the tree is built.
+	 * @param num_threads The number of workers
+	 */
+	void
+	set_num_threads(std::size_t num_threads)
+	{
+		pool_.set_num_threads(num_threads);
+	}
+
 	protected:
+	/** The words of the children of a node by the time increment and action that lead to them */
+	using ChildClasses = std::map<std::pair<RegionIndex, ActionType>, std::set<CanonicalWord>>;
 
 	virtual
 	std::pair<std::set<Node *>, std::set<Node *>>
 	compute_children(Node *node) = 0;
 
+	/** Compute the successors of some words of a node and add them to the child classes.
+	 * If the tree is built multi-threaded and there are at least parallel_successor_threshold_ words, the words are
+	 * split into interleaved chunks, each of which collects its own child classes, which are merged afterwards. Nodes
+	 * close to the root often have many words while the queue is nearly empty, so this keeps the other workers busy.
+	 * The chunks are offered to the pool as jobs with the highest priority and the expanding worker computes chunks
+	 * itself until none is left, so no thread is started and nothing waits for a job that is still queued.
+	 * @param words The words whose successors are computed
+	 * @param child_classes The child classes to add the successors to
+	 * @param add_successors Adds the successors of a single word to the given child classes, it must be safe to call
+	 * concurrently
+	 */
+	template <typename Words, typename AddSuccessors>
+	void
+	compute_successors(const Words &words, ChildClasses &child_classes, AddSuccessors &&add_successors)
+	{
+		const std::size_t workers = pool_.get_num_threads();
+		if (!multi_threaded_ || workers < 2 || parallel_successor_threshold_ == 0
+		    || words.size() < parallel_successor_threshold_) {
+			for (const auto &word : words) {
+				add_successors(word, child_classes);
+			}
+			return;
+		}
+
+		class Chunks : public SuccessorTask
+		{
+			AddSuccessors                                  &add_successors_;
+			std::vector<const typename Words::value_type *> word_ptrs_;
+
+		public:
+			Chunks(const Words &words, AddSuccessors &add_successors, std::size_t chunk_count)
+			: SuccessorTask(chunk_count), add_successors_(add_successors), child_classes(chunk_count)
+			{
+				word_ptrs_.reserve(words.size());
+				for (const auto &word : words) {
+					word_ptrs_.push_back(&word);
+				}
+			}
+			/** The child classes of each chunk */
+			std::vector<ChildClasses> child_classes;
+
+		protected:
+			void
+			run_chunk(std::size_t chunk) override
+			{
+				// Interleave the words, neighboring words often have a similar number of successors.
+				for (std::size_t i = chunk; i < word_ptrs_.size(); i += child_classes.size()) {
+					add_successors_(*word_ptrs_[i], child_classes[chunk]);
+				}
+			}
+		};
+
+		/** Holds the reference of the expanding worker. The chunks refer to the words and to add_successors, so
+		 * before they go out of scope, every chunk must have been computed, even if an exception is thrown. */
+		struct TaskReference
+		{
+			Chunks *task;
+			~TaskReference()
+			{
+				task->run();
+				try {
+					task->wait();
+				} catch (...) {
+					// Already rethrown in the regular case.
+				}
+				task->release();
+			}
+		};
+
+		const std::size_t chunk_count = std::min(workers, words.size());
+		TaskReference     reference{new Chunks(words, add_successors, chunk_count)};
+		for (std::size_t chunk = 1; chunk < chunk_count; ++chunk) {
+			reference.task->acquire();
+			try {
+				pool_.add_job(ExpansionJob{this, nullptr, reference.task}, std::numeric_limits<long>::max());
+			} catch (...) {
+				reference.task->release();
+				throw;
+			}
+		}
+		reference.task->run();
+		reference.task->wait();
+		for (auto &partial : reference.task->child_classes) {
+			for (auto &[timed_action, successors] : partial) {
+				child_classes[timed_action].merge(successors);
+			}
+		}
+	}
+
 	std::pair<std::set<Node *>, std::set<Node *>>
 	insert_children(std::map<std::pair<RegionIndex, ActionType>, std::set<CanonicalWord>> child_classes, Node *node)
 	{
@@ -474,27 +748,140 @@ public:
 		std::set<Node *> existing_children;
 		// Create child nodes, where each child contains all successors words of
 		// the same reg_a class.
-		{
-			std::lock_guard lock{nodes_mutex_};
-			for (const auto &[timed_action, words] : child_classes) {
-				auto [child_it, is_new] = nodes_.insert({words, std::make_shared<Node>(words)});
-				const std::shared_ptr<Node> &child_ptr = child_it->second;
-				node->add_child(timed_action, child_ptr);
-				SPDLOG_TRACE("Action ({}, {}): Adding child {}",
-							timed_action.first,
-							timed_action.second,
-							words);
-				if (is_new) {
-					new_children.insert(child_ptr.get());
-				} else {
-					existing_children.insert(child_ptr.get());
+		for (const auto &[timed_action, words] : child_classes) {
+			std::shared_ptr<Node> child_ptr;
+			bool                  is_new = false;
+			auto                  key    = make_node_key(words);
+			if (use_subsumption_) {
+				child_ptr = nodes_.find(key);
+				if (!child_ptr && (child_ptr = find_subsuming_node(words))) {
+					SPDLOG_TRACE("Words {} are subsumed by {}", words, fmt::ptr(child_ptr.get()));
+				}
+			}
+			if (!child_ptr) {
+				// Only the shard of the key is locked, and the node is only constructed if the key is still missing.
+				std::tie(child_ptr, is_new) =
+				  nodes_.insert_if_absent(std::move(key), [&words]() { return std::make_shared<Node>(words); });
+				if (is_new && use_subsumption_) {
+					add_to_subsumption_index(child_ptr);
 				}
 			}
+			node->add_child(timed_action, child_ptr);
+			SPDLOG_TRACE("Action ({}, {}): Adding child {}",
+						timed_action.first,
+						timed_action.second,
+						words);
+			if (is_new) {
+				new_children.insert(child_ptr.get());
+			} else {
+				existing_children.insert(child_ptr.get());
+			}
 		}
 		return {new_children, existing_children};
 	}
 
+	/** The locations of each word in a set of zone words. Words can only subsume words with the same signature */
+	using LocationSignature =
+	  std::set<std::pair<Location, std::set<logic::MTLFormula<ConstraintSymbolType>>>>;
+
+	/** Get the signature of a set of zone words */
+	static LocationSignature
+	get_location_signature(const std::set<CanonicalWord> &words)
+	{
+		LocationSignature signature;
+		if constexpr (is_zone_word) {
+			for (const auto &word : words) {
+				signature.insert({word.ta_location, word.ata_locations});
+			}
+		}
+		return signature;
+	}
+
+	/** Find an existing node whose words subsume the given words, i.e., each of the words is subsumed by a word of the
+	 * node. Only zone words can be subsumed. A node that is inserted concurrently may be missed, in which case the
+	 * words simply get a node of their own.
+	 * @param words The words of a new child
+	 * @return The subsuming node, or nullptr if there is none
+	 */
+	std::shared_ptr<Node>
+	find_subsuming_node(const std::set<CanonicalWord> &words) const
+	{
+		if constexpr (is_zone_word) {
+			std::shared_lock lock{subsumption_mutex_};
+			auto             candidates = subsumption_index_.find(get_location_signature(words));
+			if (candidates == subsumption_index_.end()) {
+				return nullptr;
+			}
+			for (const auto &candidate : candidates->second) {
+				std::shared_lock words_lock{candidate->words_mutex};
+				if (std::all_of(words.begin(), words.end(), [&candidate](const auto &word) {
+					    return std::any_of(candidate->words.begin(),
+					                       candidate->words.end(),
+					                       [&word](const auto &other) { return word.is_subsumed_by(other); });
+				    })) {
+					return candidate;
+				}
+			}
+		}
+		return nullptr;
+	}
+
+	/** Replace the words of a node that is done expanding by their compressed form, see
+	 * zones::Zone_DBM::compress(). Only zone words are compressed, and only if compress_expanded_nodes_ is set.
+	 * Otherwise, only the cached conversions of the words are dropped, as they are not needed after the expansion.
+	 * @param node The node whose words are compressed
+	 */
+	void
+	compress_words(Node *node)
+	{
+		if constexpr (is_zone_word) {
+			if (!compress_expanded_nodes_) {
+				std::unique_lock words_lock{node->words_mutex};
+				for (const auto &word : node->words) {
+					word.clear_cache();
+				}
+				return;
+			}
+			std::set<CanonicalWord> compressed_words;
+			for (auto word : node->words) {
+				// Words of different nodes often share an interned matrix, so they also share its compressed form.
+				word.compress(&dbm_pool_);
+				compressed_words.insert(compressed_words.end(), std::move(word));
+			}
+			// The key of the node shares the matrices with its words, so it needs to be compressed as well.
+			nodes_.replace_key(node->words, compressed_words, [node](const auto &entry) {
+				return entry.get() == node;
+			});
+			std::unique_lock words_lock{node->words_mutex};
+			node->words = std::move(compressed_words);
+		}
+	}
+
+	/** Get the key of the node with the given words in the node table. */
+	NodeKey
+	make_node_key(const std::set<CanonicalWord> &words)
+	{
+		if constexpr (use_packed_node_keys) {
+			return word_packer_.pack(words);
+		} else {
+			return words;
+		}
+	}
+
+	/** Make a new node available for subsumption. */
+	void
+	add_to_subsumption_index(const std::shared_ptr<Node> &node)
+	{
+		if constexpr (is_zone_word) {
+			std::unique_lock lock{subsumption_mutex_};
+			subsumption_index_[get_location_signature(node->words)].push_back(node);
+		}
+	}
+
 protected:
+	/** Whether the words of this search are zone words, which support subsumption */
+	static constexpr bool is_zone_word =
+	  std::is_same_v<CanonicalWord, CanonicalABZoneWord<Location, ConstraintSymbolType>>;
 
 	const Plant *const ta_;
 	const automata::ata::AlternatingTimedAutomaton<logic::MTLFormula<ConstraintSymbolType>,
@@ -507,11 +894,25 @@ protected:
 	const bool                 incremental_labeling_;
 	const bool                 terminate_early_{false};
 	const bool                 use_zones_;
+	const bool                 use_subsumption_;
+	const bool                 compress_expanded_nodes_;
+	/** Whether the tree is built multi-threaded, only then successors are computed in parallel */
+	std::atomic_bool multi_threaded_{false};
+	/** The number of words of a node from which their successors are computed in parallel */
+	std::size_t parallel_successor_threshold_{64};
 
-	mutable std::mutex    nodes_mutex_;
 	std::shared_ptr<Node> tree_root_;
-	std::map<std::set<CanonicalWord>, std::shared_ptr<Node>> nodes_;
-	utilities::ThreadPool<long> pool_{utilities::ThreadPool<long>::StartOnInit::NO};
+	NodeTable             nodes_;
+	/** Packs the keys of nodes_ if use_packed_node_keys is set */
+	WordPacker<Location, ConstraintSymbolType> word_packer_;
+	/** All nodes that passed the domination check and are expanded, to rule out domination of ancestors quickly */
+	DominationIndex<CanonicalWord, Location, ActionType, ConstraintSymbolType> domination_index_;
+	mutable std::shared_mutex subsumption_mutex_;
+	/** Nodes of zone words by their locations, as candidates for subsumption. Guarded by subsumption_mutex_ */
+	std::map<LocationSignature, std::vector<std::shared_ptr<Node>>> subsumption_index_;
+	/** The matrices of all DBMs in the zone words of this search, and the minimal constraints of compressed ones */
+	zones::DBM_Pool dbm_pool_;
+	JobQueue pool_{JobQueue::StartOnInit::NO};
 	std::unique_ptr<Heuristic<long, SearchTreeNode<CanonicalWord, Location, ActionType, ConstraintSymbolType>>>
 	  heuristic;
 };
@@ -525,15 +926,17 @@ template <typename Location,
           bool use_location_constraints = false,
           typename Plant =
             automata::ta::TimedAutomaton<typename Location::UnderlyingType, ActionType>,
-          bool use_set_semantics = false>
+          bool use_set_semantics = false,
+          bool use_ordered_node_table = false,
+          template <class, class> class JobPool = utilities::ThreadPool>
 class RegionTreeSearch : public TreeSearch<Location, ActionType, ConstraintSymbolType, use_location_constraints, Plant, use_set_semantics,
 									SearchTreeNode<CanonicalABWord<Location, ConstraintSymbolType>, Location, ActionType, ConstraintSymbolType>,
-									CanonicalABWord<Location, ConstraintSymbolType>>
+									CanonicalABWord<Location, ConstraintSymbolType>, use_ordered_node_table, JobPool>
 {
 	//C++ compilers are dumb dumbs and you cannot properly inherit from templated Base Classes
 	using Base = TreeSearch<Location, ActionType, ConstraintSymbolType, use_location_constraints, Plant, use_set_semantics,
 					SearchTreeNode<CanonicalABWord<Location, ConstraintSymbolType>, Location, ActionType, ConstraintSymbolType>,
-					CanonicalABWord<Location, ConstraintSymbolType>>;
+					CanonicalABWord<Location, ConstraintSymbolType>, use_ordered_node_table, JobPool>;
 	using Base::ta_;
 	using Base::ata_;
 	using Base::controller_actions_;
@@ -544,6 +947,8 @@ class RegionTreeSearch : public TreeSearch<Location, ActionType, ConstraintSymbo
 
 	using Base::add_node_to_queue;
 	using Base::insert_children;
+	using Base::compute_successors;
+	using typename Base::ChildClasses;
 
 	public:
 	using Node = SearchTreeNode<CanonicalABWord<Location, ConstraintSymbolType>, Location, ActionType, ConstraintSymbolType>;
@@ -600,7 +1005,7 @@ class RegionTreeSearch : public TreeSearch<Location, ActionType, ConstraintSymbo
 			                       ata->get_initial_configuration(),
 			                       K)});
 		}
-		nodes_                                  = {{{}, tree_root_}};
+		nodes_.reset({}, tree_root_);
 		tree_root_->min_total_region_increments = 0;
 		add_node_to_queue(tree_root_.get());
 	}
@@ -612,13 +1017,13 @@ class RegionTreeSearch : public TreeSearch<Location, ActionType, ConstraintSymbo
 			return {};
 		}
 		assert(node->get_children().empty());
-		std::map<std::pair<RegionIndex, ActionType>,
-				 std::set<CanonicalABWord<Location, ConstraintSymbolType>>>
-			child_classes;
+		ChildClasses child_classes;
 
-		const auto time_successors = get_time_successors(node->words, K_);
-		for (std::size_t increment = 0; increment < time_successors.size(); ++increment) {
-			for (const auto &time_successor : time_successors[increment]) {
+		// Compute the time successors lazily, one region increment at a time.
+		TimeSuccessors<Location, ConstraintSymbolType> time_successors{node->words, K_};
+		for (auto it = time_successors.begin(); it != time_successors.end(); ++it) {
+			const RegionIndex increment = time_successors.get_increment();
+			compute_successors(*it, child_classes, [this, increment](const auto &time_successor, auto &classes) {
 				std::multimap<ActionType, CanonicalABWord<Location, ConstraintSymbolType>> successors =
 				get_next_canonical_words<Plant,
 										ActionType,
@@ -633,9 +1038,9 @@ class RegionTreeSearch : public TreeSearch<Location, ActionType, ConstraintSymbo
 						!= std::end(controller_actions_)
 					|| std::find(std::begin(environment_actions_), std::end(environment_actions_), symbol)
 						!= std::end(environment_actions_));
-					child_classes[std::make_pair(increment, symbol)].insert(successor);
+					classes[std::make_pair(increment, symbol)].insert(successor);
 				}
-			}
+			});
 		}
 
 		return insert_children(child_classes, node);
@@ -651,15 +1056,17 @@ template <typename Location,
           bool use_location_constraints = false,
           typename Plant =
             automata::ta::TimedAutomaton<typename Location::UnderlyingType, ActionType>,
-          bool use_set_semantics = false>
+          bool use_set_semantics = false,
+          bool use_ordered_node_table = false,
+          template <class, class> class JobPool = utilities::ThreadPool>
 class ZoneTreeSearch : public TreeSearch<Location, ActionType, ConstraintSymbolType, use_location_constraints, Plant, use_set_semantics,
 								  SearchTreeNode<CanonicalABZoneWord<Location, ConstraintSymbolType>, Location, ActionType, ConstraintSymbolType>,
-								  CanonicalABZoneWord<Location, ConstraintSymbolType>>
+								  CanonicalABZoneWord<Location, ConstraintSymbolType>, use_ordered_node_table, JobPool>
 {
 	//C++ compilers are dumb dumbs and you cannot properly inherit from templated Base Classes
 	using Base = TreeSearch<Location, ActionType, ConstraintSymbolType, use_location_constraints, Plant, use_set_semantics,
 					SearchTreeNode<CanonicalABZoneWord<Location, ConstraintSymbolType>, Location, ActionType, ConstraintSymbolType>,
-					CanonicalABZoneWord<Location, ConstraintSymbolType>>;
+					CanonicalABZoneWord<Location, ConstraintSymbolType>, use_ordered_node_table, JobPool>;
 	using Base::ta_;
 	using Base::ata_;
 	using Base::controller_actions_;
@@ -670,6 +1077,9 @@ class ZoneTreeSearch : public TreeSearch<Location, ActionType, ConstraintSymbolT
 
 	using Base::add_node_to_queue;
 	using Base::insert_children;
+	using Base::compute_successors;
+	using Base::dbm_pool_;
+	using typename Base::ChildClasses;
 
 	public:
 	using Node = SearchTreeNode<CanonicalABZoneWord<Location, ConstraintSymbolType>, Location, ActionType, ConstraintSymbolType>;
@@ -693,7 +1103,14 @@ class ZoneTreeSearch : public TreeSearch<Location, ActionType, ConstraintSymbolT
 	 * @param incremental_labeling True, if incremental labeling should be used (default=false)
 	 * @param terminate_early If true, cancel the children of a node that has already been labeled
 	 * @param search_heuristic The heuristic to use during tree expansion
-	 * @param use_zones Whether to use zones, otherwise regions are used
+	 * @param use_subsumption If true, a child whose words are subsumed by an existing node (same locations, included
+	 * zones) is linked to that node instead of being expanded again. This is coarser than exact matching: it may label
+	 * the child more pessimistically, but never marks a bad configuration as good.
+	 * @param compress_expanded_nodes If true, the DBMs of expanded nodes only keep their minimal constraints, which
+	 * saves memory at the cost of decompressing them for domination checks and controller extraction.
+	 * @param merge_words If true, the zone words of each child that share their locations are merged into as few
+	 * words as possible, see merge_zone_words(). This results in fewer words per node, but reducing the federations
+	 * costs more than it saves if few words can be merged.
 	 */
 	ZoneTreeSearch(
 		const Plant                           *ta,
@@ -705,12 +1122,37 @@ class ZoneTreeSearch : public TreeSearch<Location, ActionType, ConstraintSymbolT
 		bool                                   incremental_labeling = false,
 		bool                                   terminate_early      = false,
 		std::unique_ptr<Heuristic<long, Node>> search_heuristic =
-			std::make_unique<BfsHeuristic<long, Node>>())
-	: Base(ta, ata, controller_actions, environment_actions, K, incremental_labeling, terminate_early, std::move(search_heuristic))
+			std::make_unique<BfsHeuristic<long, Node>>(),
+		bool                                   use_subsumption = false,
+		bool                                   compress_expanded_nodes = false,
+		bool                                   merge_words = false)
+	: Base(ta, ata, controller_actions, environment_actions, K, incremental_labeling, terminate_early, std::move(search_heuristic),
+	       true, use_subsumption, compress_expanded_nodes),
+	  merge_words_(merge_words),
+	  clock_registry_(std::make_shared<ClockRegistry<ConstraintSymbolType>>())
 	{
 		if constexpr (use_location_constraints && use_set_semantics) {
 			//TODO: Add zone support for location constraints and set semantics
 		} else {
+			//Intern the TA clocks in the same order as the DBMs would sort them by name
+			for(const auto &clock : ta->get_clocks()) {
+				ta_clock_ids_.push_back(clock_registry_->get_clock_id(clock));
+			}
+			for(const auto &[location, active_clocks] : ta->get_active_clocks()) {
+				auto &inactive_clocks = inactive_ta_clocks_[location];
+				for(const auto &clock : ta->get_clocks()) {
+					if(active_clocks.count(clock) == 0) {
+						inactive_clocks.push_back(clock_registry_->get_clock_id(clock));
+					}
+				}
+			}
+			active_ata_locations_ = ata->get_active_locations();
+			//Intern the ATA locations before the search starts. Otherwise, the worker threads would intern them in
+			//whichever order they reach them, and the ordering of the DBMs in each node would depend on the schedule.
+			for(const auto &location : ata->get_locations()) {
+				clock_registry_->get_clock_id(location);
+			}
+
 			std::multimap<std::string, automata::ClockConstraint> clock_constraints;
 
 			for(auto clock = ta->get_clocks().begin(); clock != ta->get_clocks().end(); clock++) {
@@ -718,17 +1160,30 @@ class ZoneTreeSearch : public TreeSearch<Location, ActionType, ConstraintSymbolT
 			}
 			clock_constraints.insert({"l0", automata::AtomicClockConstraintT<std::equal_to<Time>>(0)});
 
+			CanonicalABZoneWord root_word(ta->get_initial_configuration(),
+			                              ata->get_initial_configuration(),
+			                              K,
+			                              clock_registry_->get_clock_names());
+			//All successors copy the bounds from the root
+			root_word.dbm.set_clock_bounds(compute_clock_bounds());
+			free_inactive_clocks(root_word);
+			dbm_pool_.intern(root_word.dbm);
+
 			tree_root_ = std::make_shared<Node>(
-			  std::set<CanonicalABZoneWord<typename Plant::Location, ConstraintSymbolType>>{
-			    CanonicalABZoneWord(ta->get_initial_configuration(),
-			                        ata->get_initial_configuration(),
-			                        K)});
+			  std::set<CanonicalABZoneWord<typename Plant::Location, ConstraintSymbolType>>{root_word});
 		}
-		nodes_                                  = {{{}, tree_root_}};
+		nodes_.reset({}, tree_root_);
 		tree_root_->min_total_region_increments = 0;
 		add_node_to_queue(tree_root_.get());
 	}
 
+	/** Get the registry of the clock names of this search. DBMs of words that are handed to the search must use it. */
+	const std::shared_ptr<zones::ClockRegistry> &
+	get_clock_names() const
+	{
+		return clock_registry_->get_clock_names();
+	}
+
 	//private:
 	//public for testing
 	std::map<std::pair<RegionIndex, ActionType>, std::set<CanonicalABZoneWord<Location, ConstraintSymbolType>>>
@@ -742,6 +1197,7 @@ class ZoneTreeSearch : public TreeSearch<Location, ActionType, ConstraintSymbolT
 		//Make sure the zones are consistent, and also the TA's clocks should be the same as the word's clocks
 		assert(word.is_valid());
 		assert(ta_->get_clocks() == word.ta_clocks);
+		assert(word.dbm.get_registry() == get_clock_names());
 
 		//Take every symbol transition from TA and ATA in order to intersect the current zone with the transition guards.
 
@@ -772,8 +1228,7 @@ class ZoneTreeSearch : public TreeSearch<Location, ActionType, ConstraintSymbolT
 					}
 
 					//1. Intersect the constraints of transition with the zone
-					auto clock_constraints = curr_transition->second.get_guards();
-					ta_dbm.conjunct(clock_constraints);
+					ta_dbm.conjunct(curr_transition->second.get_guards());
 
 					//1.5 if a DBM became inconsistent, ignore this transition
 					if(!ta_dbm.is_consistent()) {
@@ -788,7 +1243,7 @@ class ZoneTreeSearch : public TreeSearch<Location, ActionType, ConstraintSymbolT
 					ta_dbm.normalize();
 
 					//3. Calculate new Location and set the TA successor
-					ta_word = CanonicalABZoneWord{curr_transition->second.target_, word.ta_clocks, {}, ta_dbm.get_subset(ta_->get_clocks())};
+					ta_word = CanonicalABZoneWord{curr_transition->second.target_, word.ta_clocks, {}, ta_dbm.get_subset_of_ids(ta_clock_ids_)};
 				}
 
 				//The TA-Clocks will be empty if there was no valid transition
@@ -802,7 +1257,8 @@ class ZoneTreeSearch : public TreeSearch<Location, ActionType, ConstraintSymbolT
 				std::set<CanonicalABZoneWord> new_words;
 
 				//Starting Configuration
-				std::set<logic::MTLFormula<ConstraintSymbolType>> start_locations = word.ata_locations;
+				const std::set<logic::MTLFormula<ConstraintSymbolType>> &start_locations = word.ata_locations;
+				[[maybe_unused]] const logic::AtomicProposition ata_symbol{symbol};
 				
 				// A vector of a set of target configurations that are reached when following a transition.
 				// One entry for each start state
@@ -824,23 +1280,22 @@ class ZoneTreeSearch : public TreeSearch<Location, ActionType, ConstraintSymbolT
 					//Get a valid transition
 					//TODO implement location constraints
 					if constexpr (!use_location_constraints) {
-						auto t = std::find_if(ata_->get_transitions().cbegin(), ata_->get_transitions().cend(), [&](const auto &t) {
-							return t.source_ == start_location && t.symbol_ == logic::AtomicProposition{symbol};
-						});
-						if (t == ata_->get_transitions().end()) {
+						const auto *t = ata_->get_transition(start_location, ata_symbol);
+						if (t == nullptr) {
 							continue;
 						}
 
 						//1. Intersect Zone for the minimal model
+						const zones::ClockID start_clock = clock_registry_->get_clock_id(start_location);
 						auto clock_constraints = t->get_clock_constraints();
 						for(const auto &constraint : clock_constraints) {
-							new_dbm.conjunct(ata_formula_to_string(start_location), constraint);
+							new_dbm.conjunct(start_clock, constraint);
 						}
 
 						//Minimal Models for this state and transition
-						std::set<ATAConfiguration> new_configurations = t->get_minimal_models(new_dbm.get_zone_slice(ata_formula_to_string(start_location)));
+						std::set<ATAConfiguration> new_configurations = t->get_minimal_models(new_dbm.get_zone_slice(start_clock));
 
-						models.push_back(new_configurations);
+						models.push_back(std::move(new_configurations));
 					}
 				}
 
@@ -849,17 +1304,18 @@ class ZoneTreeSearch : public TreeSearch<Location, ActionType, ConstraintSymbolT
 				if(models.empty() || std::any_of(std::begin(models), std::end(models), [](const auto &model) {
 					return model.empty();
 				})) {
-					//copy ta_word
-					CanonicalABZoneWord ata_word = ta_word;
+					//ta_word isn't needed anymore without models
+					CanonicalABZoneWord ata_word = std::move(ta_word);
 
 					//Check whether we have sink location or not
 					if(ata_->get_sink_location().has_value()) {
 						//Insert sink as ATA location
-						ata_word.add_ata_location(ata_->get_sink_location().value());
-						new_words.insert(ata_word);
+						ata_word.add_ata_location(ata_->get_sink_location().value(),
+						                          clock_registry_->get_clock_id(ata_->get_sink_location().value()));
+						new_words.insert(std::move(ata_word));
 					} else {
 						//ATA part is empty
-						new_words.insert(ata_word);
+						new_words.insert(std::move(ata_word));
 					}
 					model_is_empty = true;
 				}
@@ -872,20 +1328,21 @@ class ZoneTreeSearch : public TreeSearch<Location, ActionType, ConstraintSymbolT
 						[&](const auto &state_model) {
 							CanonicalABZoneWord ata_word = ta_word;
 							for(const auto &raw_state : state_model) {
+								const zones::ClockID clock = clock_registry_->get_clock_id(raw_state.location);
 								//Check whether zone was reset
 								if(raw_state.zone.lower_bound_ == 0 && raw_state.zone.upper_bound_ == 0 &&
 								  !raw_state.zone.lower_isOpen_ && !raw_state.zone.upper_isOpen_)
 								{
-									ata_word.add_ata_location(raw_state.location, true);
+									ata_word.add_ata_location(raw_state.location, clock, true);
 								} else {
-									ata_word.add_ata_location(raw_state.location, false);
+									ata_word.add_ata_location(raw_state.location, clock, false);
 									std::vector<automata::ClockConstraint> new_constraints = zones::get_clock_constraints_from_zone(raw_state.zone, K_);
 									for(const auto &constraint : new_constraints) {
-										ata_word.dbm.conjunct(ata_formula_to_string(raw_state.location), constraint);
+										ata_word.dbm.conjunct(clock, constraint);
 									}
 								}
 							}
-							new_words.insert(ata_word);
+							new_words.insert(std::move(ata_word));
 						});
 
 					// Add models from the other configurations
@@ -895,30 +1352,33 @@ class ZoneTreeSearch : public TreeSearch<Location, ActionType, ConstraintSymbolT
 							ranges::for_each(new_words, [&](const auto &ata_word) {
 								auto expanded_word = ata_word;
 								for(const auto &raw_state : state_model) {
+									const zones::ClockID clock = clock_registry_->get_clock_id(raw_state.location);
 									//Check whether zone was reset
 									if(raw_state.zone.lower_bound_ == 0 && raw_state.zone.upper_bound_ == 0 &&
 									!raw_state.zone.lower_isOpen_ && !raw_state.zone.upper_isOpen_)
 									{
-										expanded_word.add_ata_location(raw_state.location, true);
+										expanded_word.add_ata_location(raw_state.location, clock, true);
 									} else {
-										expanded_word.add_ata_location(raw_state.location, false);
+										expanded_word.add_ata_location(raw_state.location, clock, false);
 										std::vector<automata::ClockConstraint> new_constraints = zones::get_clock_constraints_from_zone(raw_state.zone, K_);
 										for(const auto &constraint : new_constraints) {
-											expanded_word.dbm.conjunct(ata_formula_to_string(raw_state.location), constraint);
+											expanded_word.dbm.conjunct(clock, constraint);
 										}
 									}
 								}
-								expanded_words.insert(expanded_word);
+								expanded_words.insert(std::move(expanded_word));
 							});
 						});
-						new_words = expanded_words;
+						new_words = std::move(expanded_words);
 					});
 					assert(!new_words.empty());
 				}
 
 				//Insert new CanonicalABZoneWords to successors
 				
-				for(const auto &new_word : new_words) {
+				//Take the words out of the set instead of copying them
+				while(!new_words.empty()) {
+					CanonicalABZoneWord new_word = std::move(new_words.extract(new_words.begin()).value());
 					//Calculate increment
 					RegionIndex increment = 0;
 					if(delay) {
@@ -928,7 +1388,11 @@ class ZoneTreeSearch : public TreeSearch<Location, ActionType, ConstraintSymbolT
 							increment = 1;
 						}
 					}
-					successors[std::make_pair(increment, symbol)].insert( new_word );
+
+					free_inactive_clocks(new_word);
+					//Equal DBMs of all successors share one matrix
+					dbm_pool_.intern(new_word.dbm);
+					successors[std::make_pair(increment, symbol)].insert(std::move(new_word));
 				}
 			}
 		}
@@ -943,23 +1407,21 @@ class ZoneTreeSearch : public TreeSearch<Location, ActionType, ConstraintSymbolT
 			return {};
 		}
 		assert(node->get_children().empty());
-		std::map<std::pair<RegionIndex, ActionType>,
-				 std::set<CanonicalABZoneWord<Location, ConstraintSymbolType>>>
-			child_classes;
+		ChildClasses child_classes;
 
-		for(const auto &word : node->words) {
+		compute_successors(node->words, child_classes, [this](const auto &word, auto &classes) {
 			std::map<std::pair<RegionIndex, ActionType>,
 						std::set<CanonicalABZoneWord<Location, ConstraintSymbolType>>>
 				successors = compute_next_canonical_words(word);
 
 			//If this action and increment hasn't been taken yet, just insert it normally
 			//Otherwise insert the new canonical words into the set that is found at this key
-			for(const auto &[key, set] : successors) {
-				if(!child_classes.insert({key, set}).second) {
-					child_classes.at(key).insert(set.begin(), set.end());
+			for(auto &[key, set] : successors) {
+				if(auto [it, inserted] = classes.try_emplace(key, std::move(set)); !inserted) {
+					it->second.merge(set);
 				}
 			}
-		}
+		});
 
 		//If two child classes for the same action (but different time increment) share the same
 		//Plant part, then they can share the same canonical words too, since they just got split up due
@@ -976,8 +1438,68 @@ class ZoneTreeSearch : public TreeSearch<Location, ActionType, ConstraintSymbolT
 			}
 		}
 
+		//Successors of different words often only differ in their zones, so their zones are merged into as few words
+		//as possible
+		if(merge_words_) {
+			for(auto &[key, words] : child_classes) {
+				words = merge_zone_words(words, &dbm_pool_);
+			}
+		}
+
 		return insert_children(child_classes, node);
 	}
+
+	private:
+	/** Free all clocks of the word whose values are never read again, so words that only differ in those clocks
+	 * become equal. The clocks stay in the DBM so the clocks of a word only depend on its locations.
+	 */
+	void
+	free_inactive_clocks(CanonicalABZoneWord<Location, ConstraintSymbolType> &word) const
+	{
+		if(const auto inactive_clocks = inactive_ta_clocks_.find(word.ta_location);
+		   inactive_clocks != inactive_ta_clocks_.end()) {
+			for(const auto clock : inactive_clocks->second) {
+				word.dbm.free_clock(clock);
+			}
+		}
+		for(const auto &location : word.ata_locations) {
+			if(active_ata_locations_.count(location) == 0) {
+				word.dbm.free_clock(clock_registry_->get_clock_id(location));
+			}
+		}
+	}
+
+	/** Compute the LU bounds for extrapolation: each TA clock is bounded by the constants of its own guards, and since
+	 * every ATA location may get any ATA clock constraint, all ATA clocks share the bounds of all ATA constraints.
+	 */
+	std::shared_ptr<const zones::ClockBounds>
+	compute_clock_bounds()
+	{
+		auto clock_bounds = std::make_shared<zones::ClockBounds>();
+
+		for(const auto &clock : ta_clock_ids_) {
+			clock_bounds->add_clock(clock);
+		}
+		for(const auto &[clock, constraint] : ta_->get_clock_constraints()) {
+			clock_bounds->add_constraint(clock_registry_->get_clock_id(clock), constraint);
+		}
+		for(const auto &constraint : ata_->get_clock_constraints()) {
+			clock_bounds->add_default_constraint(constraint);
+		}
+
+		return clock_bounds;
+	}
+
+	/** Whether the zone words of each child are merged */
+	const bool merge_words_;
+	/** Clock IDs of all clocks in this search, shared by all DBMs and not by other searches */
+	std::shared_ptr<ClockRegistry<ConstraintSymbolType>> clock_registry_;
+	/** IDs of the TA clocks, sorted by their names */
+	std::vector<zones::ClockID> ta_clock_ids_;
+	/** IDs of the TA clocks that are never read before being reset, for each TA location */
+	std::map<Location, std::vector<zones::ClockID>> inactive_ta_clocks_;
+	/** ATA locations whose clock may be read before being reset, the clocks of all other locations are freed */
+	std::set<logic::MTLFormula<ConstraintSymbolType>> active_ata_locations_;
 };
 
 
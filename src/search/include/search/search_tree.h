@@ -20,6 +20,7 @@
 #include <iostream>
 #include <limits>
 #include <memory>
+#include <shared_mutex>
 #include <stdexcept>
 
 namespace tacos::search {
@@ -98,9 +99,10 @@ public:
 			label = new_label;
 			if (cancel_children) {
 				for (const auto &action_child : children) {
-					auto child = std::get<1>(action_child);
-					if (std::all_of(std::begin(child->parents),
-					                std::end(child->parents),
+					auto       child   = std::get<1>(action_child);
+					const auto parents = child->get_parents();
+					if (std::all_of(std::begin(parents),
+					                std::end(parents),
 					                [&child](const auto &parent) {
 						                return parent == child.get() || parent->label != NodeLabel::UNLABELED;
 					                })) {
@@ -157,7 +159,7 @@ public:
 		if (children.empty()) {
 			assert(label != NodeLabel::UNLABELED);
 			SPDLOG_TRACE("Node is a leaf, propagate labels.", *this);
-			for (const auto &parent : parents) {
+			for (const auto &parent : get_parents()) {
 				if (parent != this) {
 					parent->label_propagate(controller_actions, environment_actions, cancel_children);
 				}
@@ -236,7 +238,7 @@ public:
 			set_label(NodeLabel::BOTTOM, cancel_children);
 		}
 		if (label != NodeLabel::UNLABELED) {
-			for (const auto &parent : parents) {
+			for (const auto &parent : get_parents()) {
 				if (parent != this) {
 					parent->label_propagate(controller_actions, environment_actions, cancel_children);
 				}
@@ -267,6 +269,17 @@ public:
 		return children;
 	}
 
+	/** Get a copy of the parents of the node. Other workers may add parents concurrently, so while the tree is built,
+	 * the parents must only be accessed through this.
+	 * @return The parents
+	 */
+	std::set<SearchTreeNode *>
+	get_parents() const
+	{
+		std::shared_lock lock{parents_mutex};
+		return parents;
+	}
+
 	/** Add a child to the node.
 	 * @param action Taking this action in the current node leads to the new child node
 	 * @param node The new child
@@ -283,19 +296,27 @@ public:
 			                                        action.first,
 			                                        action.second));
 		}
-		node->min_total_region_increments =
-		  std::min(node->min_total_region_increments, min_total_region_increments + action.first);
+		const RegionIndex increments = min_total_region_increments + action.first;
+		RegionIndex       current    = node->min_total_region_increments;
+		while (increments < current
+		       && !node->min_total_region_increments.compare_exchange_weak(current, increments)) {}
+		std::unique_lock lock{node->parents_mutex};
 		node->parents.insert(this);
 	}
 
 	/** The words of the node */
 	std::set<CanonicalWord> words;
+	/** Guards the words of an expanded node while they are replaced by their compressed form. Only needed when
+	 * reading the words of another node during the search. */
+	mutable std::shared_mutex words_mutex;
 	/** The state of the node */
 	std::atomic<NodeState> state = NodeState::UNKNOWN;
 	/** Whether we have a successful strategy in the node */
 	std::atomic<NodeLabel> label = NodeLabel::UNLABELED;
 	/** The parent of the node, this node was directly reached from the parent */
 	std::set<SearchTreeNode *> parents = {};
+	/** Guards the parents, which are added by the workers that expand them */
+	mutable std::shared_mutex parents_mutex;
 	/** Whether the node has been expanded. This is used for multithreading, in particular to check
 	 * whether we can access the children already. */
 	std::atomic_bool is_expanded{false};
@@ -304,7 +325,7 @@ public:
 	/** A more detailed description for the node that explains the current label. */
 	LabelReason label_reason = LabelReason::UNKNOWN;
 	/** The current regionalized minimal total time to reach this node */
-	RegionIndex min_total_region_increments = std::numeric_limits<RegionIndex>::max();
+	std::atomic<RegionIndex> min_total_region_increments = std::numeric_limits<RegionIndex>::max();
 
 private:
 	/** A list of the children of the node, which are reachable by a single transition */
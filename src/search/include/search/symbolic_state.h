@@ -5,6 +5,7 @@
 #include "automata/automata_zones.h"
 #include "automata/ta_regions.h"
 #include "mtl/MTLFormula.h"
+#include "utilities/hash.h"
 #include "utilities/numbers.h"
 #include "utilities/types.h"
 
@@ -367,8 +368,72 @@ operator<<(std::ostream &os, const search::ATAZoneState<ConstraintSymbolType> &s
 	return os;
 }
 
+/** Hash a symbolic state consistently with its comparison, i.e., by location, clock name and symbolic valuation */
+template <typename LocationType, typename SymbolicRepresentationType>
+std::size_t
+hash_symbolic_state(const SymbolicState<LocationType, SymbolicRepresentationType> &state)
+{
+	std::size_t seed = 0;
+	utilities::hash_combine(seed, state.location);
+	utilities::hash_combine(seed, state.clock);
+	utilities::hash_combine(seed, state.symbolic_valuation);
+	return seed;
+}
+
 } //namespace tacos::search
 
+namespace std {
+
+/** Hash a PlantRegionState */
+template <typename LocationT>
+struct hash<tacos::search::PlantRegionState<LocationT>>
+{
+	/** Get the hash of the state */
+	std::size_t
+	operator()(const tacos::search::PlantRegionState<LocationT> &state) const
+	{
+		return tacos::search::hash_symbolic_state(state);
+	}
+};
+
+/** Hash an ATARegionState */
+template <typename ConstraintSymbolType>
+struct hash<tacos::search::ATARegionState<ConstraintSymbolType>>
+{
+	/** Get the hash of the state */
+	std::size_t
+	operator()(const tacos::search::ATARegionState<ConstraintSymbolType> &state) const
+	{
+		return tacos::search::hash_symbolic_state(state);
+	}
+};
+
+/** Hash a PlantZoneState */
+template <typename LocationT>
+struct hash<tacos::search::PlantZoneState<LocationT>>
+{
+	/** Get the hash of the state */
+	std::size_t
+	operator()(const tacos::search::PlantZoneState<LocationT> &state) const
+	{
+		return tacos::search::hash_symbolic_state(state);
+	}
+};
+
+/** Hash an ATAZoneState */
+template <typename ConstraintSymbolType>
+struct hash<tacos::search::ATAZoneState<ConstraintSymbolType>>
+{
+	/** Get the hash of the state */
+	std::size_t
+	operator()(const tacos::search::ATAZoneState<ConstraintSymbolType> &state) const
+	{
+		return tacos::search::hash_symbolic_state(state);
+	}
+};
+
+} //namespace std
+
 namespace fmt {
 
 template <typename LocationT>
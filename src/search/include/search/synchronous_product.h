@@ -21,10 +21,14 @@
 #include <spdlog/spdlog.h>
 
 #include <algorithm>
+#include <cstddef>
 #include <iterator>
+#include <set>
 #include <stdexcept>
 #include <type_traits>
+#include <utility>
 #include <variant>
+#include <vector>
 #include <float.h>
 
 namespace tacos::search {
@@ -331,6 +335,50 @@ get_time_successors(const CanonicalABWord<Location, ConstraintSymbolType> &canon
 	}
 	return time_successors;
 }
+namespace details {
+/** Compute the direct time successors of a set of canonical words into the given buffers.
+ * @param canonical_words The set of canonical words to compute time successors of
+ * @param K The maximal constant
+ * @param successors A buffer for the time successor of each word, its capacity is reused across calls
+ * @param result The set to write the direct time successors into
+ * @return false if every word is already maxed and thus is its own time successor, true otherwise; result is only
+ * written if true is returned
+ */
+template <typename Location, typename ConstraintSymbolType>
+bool
+compute_next_time_successors(
+  const std::set<CanonicalABWord<Location, ConstraintSymbolType>> &canonical_words,
+  RegionIndex                                                      K,
+  std::vector<CanonicalABWord<Location, ConstraintSymbolType>>    &successors,
+  std::set<CanonicalABWord<Location, ConstraintSymbolType>>       &result)
+{
+	successors.clear();
+	bool changed            = false;
+	bool increments_ata_reg = false;
+	for (const auto &word : canonical_words) {
+		successors.push_back(get_time_successor(word, K));
+		changed            = changed || successors.back() != word;
+		increments_ata_reg = increments_ata_reg || reg_a(word) == reg_a(successors.back());
+	}
+	if (!changed) {
+		return false;
+	}
+	result.clear();
+	auto successor = std::begin(successors);
+	for (const auto &word : canonical_words) {
+		// If there is at least one word where the successor has the same reg_a, then there is an ATA configuration
+		// that is incremented. We must only increment those where there is also an ATA configuration to increment.
+		if (!increments_ata_reg || reg_a(word) == reg_a(*successor)) {
+			result.insert(std::move(*successor));
+		} else {
+			result.insert(word);
+		}
+		++successor;
+	}
+	return true;
+}
+} // namespace details
+
 /** Compute the direct time successors which introduce an increment in the ATA configuration for each of the passed words.
  * @param canonical_words The set of canonical words to compute time successors of
  * @param K The maximal constant
@@ -346,35 +394,149 @@ get_next_time_successors(
 	assert(std::all_of(std::begin(canonical_words), std::end(canonical_words), [&](const auto &word) {
 		return reg_a(word) == reg_a(*std::begin(canonical_words));
 	}));
-	std::set<CanonicalABWord<Location, ConstraintSymbolType>> successors;
-	std::map<CanonicalABWord<Location, ConstraintSymbolType>,
-			 CanonicalABWord<Location, ConstraintSymbolType>>
-	  successors_map;
-	for (const auto &word : canonical_words) {
-		successors_map[word] = get_time_successor(word, K);
+	std::vector<CanonicalABWord<Location, ConstraintSymbolType>> successors;
+	std::set<CanonicalABWord<Location, ConstraintSymbolType>>    result;
+	if (!details::compute_next_time_successors(canonical_words, K, successors, result)) {
+		return canonical_words;
 	}
-	if (std::any_of(std::begin(successors_map), std::end(successors_map), [](const auto &map_entry) {
-			return reg_a(map_entry.first) == reg_a(map_entry.second);
-		})) {
-		// There is at least one where the successor has the same reg_a and thus there is an ATA
-		// configuration that is incremented. We must only increments those where there is also an ATA
-		// configuration to increment.
-		for (const auto &[word, successor] : successors_map) {
-			if (reg_a(word) == reg_a(successor)) {
-				successors.insert(successor);
-			} else {
-				successors.insert(word);
-			}
+	return result;
+}
+
+/** A lazy sequence of the time successors of a set of canonical words (i.e., of a node in the search tree).
+ * The n-th element of the sequence is the set of time successors with region increment n, starting with the words
+ * themselves. Successors are computed one increment at a time when the sequence is advanced, so only the current
+ * and the next set of words are kept in memory. The sequence ends as soon as the next increment does not change the
+ * words anymore, in particular once all words have reached the maximal region.
+ * The sequence can only be traversed once.
+ */
+template <typename Location, typename ConstraintSymbolType>
+class TimeSuccessors
+{
+public:
+	/** The set of words of one time increment. */
+	using Words = std::set<CanonicalABWord<Location, ConstraintSymbolType>>;
+
+	/** A single-pass input iterator over the time successors. */
+	class iterator
+	{
+	public:
+		using iterator_category = std::input_iterator_tag;
+		using value_type        = Words;
+		using difference_type   = std::ptrdiff_t;
+		using pointer           = const Words *;
+		using reference         = const Words &;
+
+		/** The words with the current region increment. */
+		reference
+		operator*() const
+		{
+			return successors_->current_;
+		}
+		/** Access the words with the current region increment. */
+		pointer
+		operator->() const
+		{
+			return &successors_->current_;
 		}
-	} else {
-		for (const auto &[_, successor] : successors_map) {
-			successors.insert(successor);
+		/** Advance to the next region increment. */
+		iterator &
+		operator++()
+		{
+			successors_->advance();
+			return *this;
 		}
+		/** Compare two iterators, all exhausted iterators are equal. */
+		bool
+		operator==(const iterator &other) const
+		{
+			return is_end() == other.is_end();
+		}
+		/** Compare two iterators. */
+		bool
+		operator!=(const iterator &other) const
+		{
+			return !(*this == other);
+		}
+
+	private:
+		friend class TimeSuccessors;
+		explicit iterator(TimeSuccessors *successors) : successors_(successors)
+		{
+		}
+		bool
+		is_end() const
+		{
+			return successors_ == nullptr || successors_->done_;
+		}
+		TimeSuccessors *successors_;
+	};
+
+	/** Start the sequence at the given words.
+	 * @param canonical_words The words to compute the time successors of
+	 * @param K The maximal constant
+	 */
+	TimeSuccessors(Words canonical_words, RegionIndex K)
+	: current_(std::move(canonical_words)),
+	  K_(K),
+	  is_region_sequence_(current_.empty() || is_region_canonical_word(*std::begin(current_)))
+	{
+	}
+
+	/** Get an iterator to the current increment. */
+	iterator
+	begin()
+	{
+		return iterator{this};
 	}
-	return successors;
-}
+
+	/** Get the end of the sequence. */
+	iterator
+	end()
+	{
+		return iterator{nullptr};
+	}
+
+	/** Get the region increment of the words the sequence is currently at. */
+	RegionIndex
+	get_increment() const
+	{
+		return increment_;
+	}
+
+private:
+	void
+	advance()
+	{
+		if (done_) {
+			return;
+		}
+		if (!is_region_sequence_) {
+			// Zone words only have a single, unbounded time successor.
+			if (increment_ > 0) {
+				done_ = true;
+				return;
+			}
+			next_ = get_next_time_successors(current_, K_);
+		} else if (!details::compute_next_time_successors(current_, K_, successor_buffer_, next_)
+		           || next_ == current_) {
+			done_ = true;
+			return;
+		}
+		std::swap(current_, next_);
+		++increment_;
+	}
+
+	Words                                                        current_;
+	Words                                                        next_;
+	std::vector<CanonicalABWord<Location, ConstraintSymbolType>> successor_buffer_;
+	RegionIndex                                                  K_;
+	RegionIndex                                                  increment_{0};
+	bool                                                         is_region_sequence_;
+	bool                                                         done_{false};
+};
 
 /** Compute all time successors of a set of canonical words (i.e., of a node in the search tree).
+ * This materializes the whole sequence, use TimeSuccessors to iterate over the successors lazily instead.
  * @param canonical_words A set of canonical words to compute the time successors of
  * @param K The maximal constant
  * @return A map of time successors of each word along with the region increment to reach the
@@ -387,20 +549,8 @@ get_time_successors(
   RegionIndex                                                      K)
 {
 	std::vector<std::set<CanonicalABWord<Location, ConstraintSymbolType>>> successors;
-	successors.push_back(canonical_words);
-
-	if(!is_region_canonical_word(*canonical_words.begin())) {
-		successors.push_back(get_next_time_successors(canonical_words, K));
-		return successors;
-	}
-
-	while (true) {
-		const auto next = get_next_time_successors(successors.back(), K);
-		if (next != successors.back()) {
-			successors.push_back(next);
-		} else {
-			break;
-		}
+	for (const auto &words : TimeSuccessors<Location, ConstraintSymbolType>{canonical_words, K}) {
+		successors.push_back(words);
 	}
 	return successors;
 }
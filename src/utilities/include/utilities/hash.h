@@ -0,0 +1,100 @@
+/***************************************************************************
+ *  hash.h - Utility functions for hashing
+ *
+ *  SPDX-License-Identifier: LGPL-3.0-or-later
+ ****************************************************************************/
+
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace tacos::utilities {
+
+/** Check whether std::hash is enabled for a type. */
+template <typename T, typename = void>
+struct is_hashable : std::false_type
+{
+};
+
+/** Check whether std::hash is enabled for a type. */
+template <typename T>
+struct is_hashable<T, std::void_t<decltype(std::hash<T>{}(std::declval<const T &>()))>>
+: std::true_type
+{
+};
+
+/** True if std::hash is enabled for T. */
+template <typename T>
+inline constexpr bool is_hashable_v = is_hashable<T>::value;
+
+/** Check whether a type is a pair or tuple. */
+template <typename T, typename = void>
+struct is_tuple_like : std::false_type
+{
+};
+
+/** Check whether a type is a pair or tuple. */
+template <typename T>
+struct is_tuple_like<T, std::void_t<decltype(std::tuple_size<T>::value)>> : std::true_type
+{
+};
+
+template <typename T>
+std::size_t hash_value(const T &value);
+
+/** Mix the hash of a value into an existing hash, as boost::hash_combine does. */
+template <typename T>
+void
+hash_combine(std::size_t &seed, const T &value)
+{
+	seed ^= hash_value(value) + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2);
+}
+
+/** Hash a range of values in order. */
+template <typename Iterator>
+std::size_t
+hash_range(Iterator first, Iterator last)
+{
+	std::size_t seed = 0;
+	for (; first != last; ++first) {
+		hash_combine(seed, *first);
+	}
+	return seed;
+}
+
+/** Hash a value with std::hash if it is enabled, otherwise hash it element-wise if it is a pair or tuple or a range,
+ * e.g., a vector of strings or a set of words. */
+template <typename T>
+std::size_t
+hash_value(const T &value)
+{
+	if constexpr (is_hashable_v<T>) {
+		return std::hash<T>{}(value);
+	} else if constexpr (is_tuple_like<T>::value) {
+		std::size_t seed = 0;
+		std::apply([&seed](const auto &...elements) { (hash_combine(seed, elements), ...); }, value);
+		return seed;
+	} else {
+		return hash_range(std::begin(value), std::end(value));
+	}
+}
+
+/** A hash function object for unordered containers that also accepts ranges, see hash_value. */
+struct Hash
+{
+	/** Hash a value. */
+	template <typename T>
+	std::size_t
+	operator()(const T &value) const
+	{
+		return hash_value(value);
+	}
+};
+
+} // namespace tacos::utilities
@@ -0,0 +1,127 @@
+/***************************************************************************
+ *  multi_queue_pool.h - A thread pool with a relaxed priority queue
+ *
+ *  SPDX-License-Identifier: LGPL-3.0-or-later
+ ****************************************************************************/
+
+#pragma once
+
+#include "priority_thread_pool.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <queue>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace tacos::utilities {
+
+/** @brief A thread pool whose jobs are kept in a MultiQueue, a relaxed concurrent priority queue.
+ *
+ * The MultiQueue consists of several independent heaps with a lock each, a fixed number per worker. A new job is
+ * pushed to a random heap. A worker takes the better of the best jobs of two random heaps. Thus, jobs are processed in
+ * approximate priority order, but the workers only rarely wait for each other.
+ * Jobs that are added before the pool is started are kept in a single queue, which can be processed with
+ * QueueAccess, and are distributed to the heaps when the pool starts. The interface is the same as the one of
+ * ThreadPool.
+ *
+ * @tparam Priority The priority type
+ * @tparam T The job type, must be a Callable
+ */
+template <class Priority = int, class T = std::function<void()>>
+class MultiQueuePool
+{
+	friend class QueueAccess<Priority, T, MultiQueuePool>;
+
+public:
+	/** Flag whether the pool shall be started on initialization. */
+	enum class StartOnInit {
+		NO,
+		YES,
+	};
+	/** Construct a thread pool.
+	 * @param start Whether the pool shall be started on initialization
+	 * @param num_threads The number of threads in the pool
+	 * @param heaps_per_thread The number of heaps per thread, more heaps reduce contention but relax the order
+	 */
+	MultiQueuePool(StartOnInit start            = StartOnInit::YES,
+	               std::size_t num_threads      = std::thread::hardware_concurrency(),
+	               std::size_t heaps_per_thread = 2);
+	/** Stop and destruct the pool. This will stop all workers. */
+	virtual ~MultiQueuePool();
+	/** Add a job to the pool.
+	 * @param job A pair (priority, job), where job is a Callable.
+	 */
+	void add_job(std::pair<Priority, T> &&job);
+	/** Add a job to to the pool.
+	 * @param job The job to run, must be a Callable
+	 * @param priority The priority of the job, jobs with higher priority are run first
+	 */
+	void add_job(T &&job, const Priority &priority = Priority{});
+	/** Start the workers in the pool. */
+	void start();
+	/** Stop the workers. They will finish their current job, but not necessarily process all jobs in
+	 * the queue. */
+	void cancel();
+	/** Do not allow new jobs to the queue. */
+	void close_queue();
+	/** Wait until all tasks have completed. */
+	void wait();
+	/** Close the queue and let the workers finish all jobs. */
+	void finish();
+	/** Get the number of workers in the pool. */
+	std::size_t get_num_threads() const;
+	/** Set the number of workers in the pool. The pool must not be started yet.
+	 * @param num_threads The number of threads in the pool
+	 */
+	void set_num_threads(std::size_t num_threads);
+
+private:
+	using Job = std::pair<Priority, T>;
+
+	/** A single heap of the MultiQueue, aligned to cache lines so workers do not slow each other down. */
+	struct alignas(64) Heap
+	{
+		std::mutex               mutex;
+		std::vector<Job>         jobs;
+		std::atomic<std::size_t> size{0};
+	};
+
+	/** Get a random heap index for the calling thread. */
+	std::size_t random_heap() const;
+	/** Push a job to a random heap. */
+	void push_job(Job &&job);
+	/** Take the better of the best jobs of two random heaps. */
+	std::optional<Job> pop_job();
+	/** Take the best job of a heap, the heap must be locked and must not be empty. */
+	Job pop_from(Heap &heap);
+	/** Run the loop of a worker. */
+	void run_worker();
+
+	std::size_t              size;
+	bool                     started{false};
+	std::vector<std::thread> workers;
+	std::vector<Heap>        heaps;
+	/** Jobs added before the pool is started */
+	std::priority_queue<Job, std::vector<Job>, CompareFirstOfPair<Priority, T>> queue;
+	std::atomic_bool                                                            stopping{false};
+	std::atomic_bool                                                            queue_open{true};
+	/** The number of jobs in all heaps, may briefly be larger than the actual number */
+	std::atomic<std::size_t> queued_jobs{0};
+	/** The number of jobs that are queued or running */
+	std::atomic<std::size_t> pending_jobs{0};
+	std::atomic<std::size_t> sleeping_workers{0};
+	std::atomic<std::size_t> running_workers{0};
+	std::mutex               sleep_mutex;
+	std::condition_variable  sleep_cond;
+	std::mutex               idle_mutex;
+	std::condition_variable  idle_cond;
+};
+
+} // namespace tacos::utilities
+
+#include "multi_queue_pool.hpp"
@@ -0,0 +1,239 @@
+/***************************************************************************
+ *  multi_queue_pool.hpp - A thread pool with a relaxed priority queue
+ *
+ *  SPDX-License-Identifier: LGPL-3.0-or-later
+ ****************************************************************************/
+
+#pragma once
+
+#include "multi_queue_pool.h"
+
+#include <algorithm>
+#include <functional>
+#include <mutex>
+#include <random>
+
+namespace tacos::utilities {
+
+template <class Priority, class T>
+MultiQueuePool<Priority, T>::MultiQueuePool(StartOnInit start_on_init,
+                                            std::size_t size,
+                                            std::size_t heaps_per_thread)
+: size(std::max(size, std::size_t{1})), heaps(std::max(this->size * heaps_per_thread, std::size_t{1}))
+{
+	if (start_on_init == StartOnInit::YES) {
+		start();
+	}
+}
+
+template <class Priority, class T>
+MultiQueuePool<Priority, T>::~MultiQueuePool()
+{
+	cancel();
+}
+
+template <class Priority, class T>
+std::size_t
+MultiQueuePool<Priority, T>::random_heap() const
+{
+	thread_local std::minstd_rand random{
+	  static_cast<std::minstd_rand::result_type>(std::hash<std::thread::id>{}(std::this_thread::get_id()))};
+	return random() % heaps.size();
+}
+
+template <class Priority, class T>
+void
+MultiQueuePool<Priority, T>::start()
+{
+	if (started) {
+		throw QueueStartedException("Pool already started");
+	}
+	// The queue may have been processed with QueueAccess, so count the jobs again.
+	queued_jobs  = queue.size();
+	pending_jobs = queue.size();
+	while (!queue.empty()) {
+		push_job(Job{queue.top().first, std::move(const_cast<T &>(queue.top().second))});
+		queue.pop();
+	}
+	// Set the flag before the workers start, so jobs added by the workers go to the heaps.
+	started         = true;
+	running_workers = size;
+	for (std::size_t i = 0; i < size; ++i) {
+		workers.push_back(std::thread{[this]() { run_worker(); }});
+	}
+}
+
+template <class Priority, class T>
+void
+MultiQueuePool<Priority, T>::run_worker()
+{
+	while (!stopping) {
+		if (auto job = pop_job()) {
+			job->second();
+			if (--pending_jobs == 0) {
+				std::lock_guard guard{idle_mutex};
+				idle_cond.notify_all();
+			}
+			continue;
+		}
+		if (!queue_open) {
+			break;
+		}
+		// Wait for the stop signal or a new job.
+		std::unique_lock lock{sleep_mutex};
+		++sleeping_workers;
+		sleep_cond.wait(lock, [this] { return stopping || queued_jobs > 0 || !queue_open; });
+		--sleeping_workers;
+	}
+	std::lock_guard guard{idle_mutex};
+	--running_workers;
+	idle_cond.notify_all();
+}
+
+template <class Priority, class T>
+void
+MultiQueuePool<Priority, T>::push_job(Job &&job)
+{
+	// Skip heaps that are locked by another thread, any heap is as good as another.
+	auto                        *heap = &heaps[random_heap()];
+	std::unique_lock<std::mutex> lock{heap->mutex, std::try_to_lock};
+	while (!lock.owns_lock()) {
+		heap = &heaps[random_heap()];
+		lock = std::unique_lock<std::mutex>{heap->mutex, std::try_to_lock};
+	}
+	heap->jobs.push_back(std::move(job));
+	std::push_heap(heap->jobs.begin(), heap->jobs.end(), CompareFirstOfPair<Priority, T>{});
+	++heap->size;
+}
+
+template <class Priority, class T>
+typename MultiQueuePool<Priority, T>::Job
+MultiQueuePool<Priority, T>::pop_from(Heap &heap)
+{
+	std::pop_heap(heap.jobs.begin(), heap.jobs.end(), CompareFirstOfPair<Priority, T>{});
+	auto job = std::move(heap.jobs.back());
+	heap.jobs.pop_back();
+	--heap.size;
+	--queued_jobs;
+	return job;
+}
+
+template <class Priority, class T>
+std::optional<typename MultiQueuePool<Priority, T>::Job>
+MultiQueuePool<Priority, T>::pop_job()
+{
+	while (queued_jobs > 0 && !stopping) {
+		auto &first  = heaps[random_heap()];
+		auto &second = heaps[random_heap()];
+		if (&first != &second && (first.size > 0 || second.size > 0)) {
+			std::scoped_lock lock{first.mutex, second.mutex};
+			if (first.jobs.empty() && second.jobs.empty()) {
+				continue;
+			}
+			if (second.jobs.empty()
+			    || (!first.jobs.empty() && !(first.jobs.front().first < second.jobs.front().first))) {
+				return pop_from(first);
+			}
+			return pop_from(second);
+		}
+		// With few remaining jobs, random heaps are likely to be empty, so look for any job.
+		for (auto &heap : heaps) {
+			if (heap.size > 0) {
+				std::lock_guard guard{heap.mutex};
+				if (!heap.jobs.empty()) {
+					return pop_from(heap);
+				}
+			}
+		}
+		std::this_thread::yield();
+	}
+	return std::nullopt;
+}
+
+template <class Priority, class T>
+void
+MultiQueuePool<Priority, T>::add_job(std::pair<Priority, T> &&job)
+{
+	if (!queue_open) {
+		throw QueueClosedException("Queue is closed!");
+	}
+	if (!started) {
+		queue.push(std::move(job));
+		return;
+	}
+	++pending_jobs;
+	// Count the job before it is pushed, so the counter never drops below the number of queued jobs.
+	++queued_jobs;
+	push_job(std::move(job));
+	if (sleeping_workers > 0) {
+		std::lock_guard guard{sleep_mutex};
+		sleep_cond.notify_one();
+	}
+}
+
+template <class Priority, class T>
+void
+MultiQueuePool<Priority, T>::add_job(T &&job, const Priority &priority)
+{
+	add_job(std::make_pair(priority, std::move(job)));
+}
+
+template <class Priority, class T>
+void
+MultiQueuePool<Priority, T>::close_queue()
+{
+	queue_open = false;
+}
+
+template <class Priority, class T>
+void
+MultiQueuePool<Priority, T>::wait()
+{
+	std::unique_lock lock{idle_mutex};
+	idle_cond.wait(lock, [this] { return pending_jobs == 0 || running_workers == 0; });
+}
+
+template <class Priority, class T>
+void
+MultiQueuePool<Priority, T>::finish()
+{
+	close_queue();
+	{
+		std::lock_guard guard{sleep_mutex};
+		sleep_cond.notify_all();
+	}
+	for (auto &worker : workers) {
+		if (worker.joinable()) {
+			worker.join();
+		}
+	}
+}
+
+template <class Priority, class T>
+std::size_t
+MultiQueuePool<Priority, T>::get_num_threads() const
+{
+	return size;
+}
+
+template <class Priority, class T>
+void
+MultiQueuePool<Priority, T>::set_num_threads(std::size_t num_threads)
+{
+	if (started) {
+		throw QueueStartedException("Pool already started");
+	}
+	const std::size_t heaps_per_thread = heaps.size() / size;
+	size                               = std::max(num_threads, std::size_t{1});
+	heaps = std::vector<Heap>(std::max(size * heaps_per_thread, std::size_t{1}));
+}
+
+template <class Priority, class T>
+void
+MultiQueuePool<Priority, T>::cancel()
+{
+	stopping = true;
+	finish();
+}
+
+} // namespace tacos::utilities
@@ -43,6 +43,9 @@ struct CompareFirstOfPair
 };
 
 template <class Priority, class T>
+class ThreadPool;
+
+template <class Priority, class T, template <class, class> class Pool = ThreadPool>
 class QueueAccess;
 
 /** @brief A multi-threaded priority queue with a fixed number of workers.
@@ -89,6 +92,12 @@ public:
 	void wait();
 	/** Close the queue and let the workers finish all jobs. */
 	void finish();
+	/** Get the number of workers in the pool. */
+	std::size_t get_num_threads() const;
+	/** Set the number of workers in the pool. The pool must not be started yet.
+	 * @param num_threads The number of threads in the pool
+	 */
+	void set_num_threads(std::size_t num_threads);
 
 private:
 	std::size_t              size;
@@ -114,8 +123,9 @@ private:
  * mainly helpful for testing and for single-threaded, synchronous queue processing.
  * @tparam Priority The priority type
  * @tparam T The job type, must be a Callable
+ * @tparam Pool The type of the pool, e.g., ThreadPool or WorkStealingPool
  */
-template <class Priority, class T>
+template <class Priority, class T, template <class, class> class Pool>
 class QueueAccess
 {
 public:
@@ -123,13 +133,18 @@ public:
 	 * lifetime.
 	 * @param pool The pool to access
 	 */
-	QueueAccess(ThreadPool<Priority, T> *pool);
+	QueueAccess(Pool<Priority, T> *pool);
 	/** Get the first element of the pool.
 	 * @return The first element of the pool's queue.
 	 */
 	const std::pair<Priority, T> &top() const;
 	/** Remove the first element of the pool's queue. */
 	void pop();
+	/** Remove the first element of the pool's queue and return it. Unlike top(), this moves the job out of the
+	 * queue instead of requiring a copy.
+	 * @return The first element of the pool's queue.
+	 */
+	std::pair<Priority, T> take();
 	/** Check if the pool's queue is empty. */
 	bool empty() const;
 
@@ -137,7 +152,7 @@ public:
 	std::size_t get_size() const;
 
 private:
-	ThreadPool<Priority, T> *pool;
+	Pool<Priority, T> *pool;
 };
 
 } // namespace tacos::utilities
@@ -55,7 +55,8 @@ ThreadPool<Priority, T>::start()
 				}
 				std::unique_lock lock{queue_mutex};
 				while (!queue.empty()) {
-					auto job = std::get<1>(queue.top());
+					// Move the job out of the queue, popping only reorders the queue by the priorities.
+					auto job = std::move(const_cast<T &>(queue.top().second));
 					queue.pop();
 					lock.unlock();
 					job();
@@ -94,7 +95,7 @@ ThreadPool<Priority, T>::add_job(std::pair<Priority, T> &&job)
 		throw QueueClosedException("Queue is closed!");
 	}
 	std::lock_guard guard{queue_mutex};
-	queue.push(job);
+	queue.push(std::move(job));
 	queue_cond.notify_one();
 }
 
@@ -102,7 +103,7 @@ template <class Priority, class T>
 void
 ThreadPool<Priority, T>::add_job(T &&job, const Priority &priority)
 {
-	add_job(std::make_pair(priority, job));
+	add_job(std::make_pair(priority, std::move(job)));
 }
 
 template <class Priority, class T>
@@ -143,6 +144,23 @@ ThreadPool<Priority, T>::finish()
 	}
 }
 
+template <class Priority, class T>
+std::size_t
+ThreadPool<Priority, T>::get_num_threads() const
+{
+	return size;
+}
+
+template <class Priority, class T>
+void
+ThreadPool<Priority, T>::set_num_threads(std::size_t num_threads)
+{
+	if (started) {
+		throw QueueStartedException("Pool already started");
+	}
+	size = num_threads;
+}
+
 template <class Priority, class T>
 void
 ThreadPool<Priority, T>::cancel()
@@ -151,14 +169,14 @@ ThreadPool<Priority, T>::cancel()
 	finish();
 }
 
-template <class Priority, class T>
-QueueAccess<Priority, T>::QueueAccess(ThreadPool<Priority, T> *pool) : pool(pool)
+template <class Priority, class T, template <class, class> class Pool>
+QueueAccess<Priority, T, Pool>::QueueAccess(Pool<Priority, T> *pool) : pool(pool)
 {
 }
 
-template <class Priority, class T>
+template <class Priority, class T, template <class, class> class Pool>
 const std::pair<Priority, T> &
-QueueAccess<Priority, T>::top() const
+QueueAccess<Priority, T, Pool>::top() const
 {
 	if (pool->started) {
 		throw QueueStartedException("Pool already started");
@@ -166,9 +184,9 @@ QueueAccess<Priority, T>::top() const
 	return pool->queue.top();
 }
 
-template <class Priority, class T>
+template <class Priority, class T, template <class, class> class Pool>
 void
-QueueAccess<Priority, T>::pop()
+QueueAccess<Priority, T, Pool>::pop()
 {
 	if (pool->started) {
 		throw QueueStartedException("Pool already started");
@@ -176,9 +194,22 @@ QueueAccess<Priority, T>::pop()
 	return pool->queue.pop();
 }
 
-template <class Priority, class T>
+template <class Priority, class T, template <class, class> class Pool>
+std::pair<Priority, T>
+QueueAccess<Priority, T, Pool>::take()
+{
+	if (pool->started) {
+		throw QueueStartedException("Pool already started");
+	}
+	// The queue only gives const access to its top, but the element is removed right after moving from it.
+	std::pair<Priority, T> job{pool->queue.top().first, std::move(const_cast<T &>(pool->queue.top().second))};
+	pool->queue.pop();
+	return job;
+}
+
+template <class Priority, class T, template <class, class> class Pool>
 bool
-QueueAccess<Priority, T>::empty() const
+QueueAccess<Priority, T, Pool>::empty() const
 {
 	if (pool->started) {
 		throw QueueStartedException("Pool already started");
@@ -186,9 +217,9 @@ QueueAccess<Priority, T>::empty() const
 	return pool->queue.empty();
 }
 
-template <class Priority, class T>
+template <class Priority, class T, template <class, class> class Pool>
 std::size_t
-QueueAccess<Priority, T>::get_size() const
+QueueAccess<Priority, T, Pool>::get_size() const
 {
 	if (pool->started) {
 		throw QueueStartedException("Pool already started");
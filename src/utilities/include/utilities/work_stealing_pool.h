@@ -0,0 +1,127 @@
+/***************************************************************************
+ *  work_stealing_pool.h - A thread pool with per-worker priority queues
+ *
+ *  SPDX-License-Identifier: LGPL-3.0-or-later
+ ****************************************************************************/
+
+#pragma once
+
+#include "priority_thread_pool.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <queue>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace tacos::utilities {
+
+/** @brief A thread pool where each worker has its own priority queue and steals jobs from other workers.
+ *
+ * Jobs that are added by a worker are pushed to the worker's own queue, so workers that expand many small jobs do
+ * not contend on a single lock. A worker whose queue is empty steals the job with the highest priority from the
+ * other queues. Jobs are therefore only processed in approximate priority order: each worker processes its own jobs
+ * in order, but different workers may process jobs of lower priority concurrently.
+ * Jobs added from other threads are pushed to a shared queue, which is also used by QueueAccess if the pool is not
+ * started. The interface is the same as the one of ThreadPool.
+ *
+ * @tparam Priority The priority type
+ * @tparam T The job type, must be a Callable
+ */
+template <class Priority = int, class T = std::function<void()>>
+class WorkStealingPool
+{
+	friend class QueueAccess<Priority, T, WorkStealingPool>;
+
+public:
+	/** Flag whether the pool shall be started on initialization. */
+	enum class StartOnInit {
+		NO,
+		YES,
+	};
+	/** Construct a thread pool.
+	 * @param start Whether the pool shall be started on initialization
+	 * @param num_threads The number of threads in the pool
+	 */
+	WorkStealingPool(StartOnInit start       = StartOnInit::YES,
+	                 std::size_t num_threads = std::thread::hardware_concurrency());
+	/** Stop and destruct the pool. This will stop all workers. */
+	virtual ~WorkStealingPool();
+	/** Add a job to the pool.
+	 * @param job A pair (priority, job), where job is a Callable.
+	 */
+	void add_job(std::pair<Priority, T> &&job);
+	/** Add a job to to the pool.
+	 * @param job The job to run, must be a Callable
+	 * @param priority The priority of the job, jobs with higher priority are run first
+	 */
+	void add_job(T &&job, const Priority &priority = Priority{});
+	/** Start the workers in the pool. */
+	void start();
+	/** Stop the workers. They will finish their current job, but not necessarily process all jobs in
+	 * the queue. */
+	void cancel();
+	/** Do not allow new jobs to the queue. */
+	void close_queue();
+	/** Wait until all tasks have completed. */
+	void wait();
+	/** Close the queue and let the workers finish all jobs. */
+	void finish();
+	/** Get the number of workers in the pool. */
+	std::size_t get_num_threads() const;
+	/** Set the number of workers in the pool. The pool must not be started yet.
+	 * @param num_threads The number of threads in the pool
+	 */
+	void set_num_threads(std::size_t num_threads);
+
+private:
+	using Job = std::pair<Priority, T>;
+
+	/** The queue of a single worker, aligned to cache lines so workers do not slow each other down. */
+	struct alignas(64) WorkerQueue
+	{
+		std::mutex               mutex;
+		std::vector<Job>         heap;
+		std::atomic<std::size_t> size{0};
+	};
+
+	/** Get the worker of the calling thread as pair (pool, worker index). */
+	static std::pair<const WorkStealingPool *, std::size_t> &local_worker();
+	/** Run the loop of a worker. */
+	void run_worker(std::size_t index);
+	/** Get the next job of a worker, either from its own queue or stolen from another queue. */
+	std::optional<Job> get_job(std::size_t index);
+	/** Steal the job with the highest priority from the queues of the other workers and the shared queue. */
+	std::optional<Job> steal_job(std::size_t index);
+	/** Mark a job as done and wake up the threads that wait for all jobs to complete. */
+	void complete_job();
+
+	std::size_t              size;
+	bool                     started{false};
+	std::vector<std::thread> workers;
+	std::vector<WorkerQueue> worker_queues;
+	/** Jobs added by threads that are not workers of this pool */
+	std::priority_queue<Job, std::vector<Job>, CompareFirstOfPair<Priority, T>> queue;
+	std::mutex                                                                  queue_mutex;
+	std::atomic<std::size_t>                                                    queue_size{0};
+	std::atomic_bool                                                            stopping{false};
+	std::atomic_bool                                                            queue_open{true};
+	/** The number of jobs in all queues, may briefly be larger than the actual number */
+	std::atomic<std::size_t> queued_jobs{0};
+	/** The number of jobs that are queued or running */
+	std::atomic<std::size_t> pending_jobs{0};
+	std::atomic<std::size_t> sleeping_workers{0};
+	std::atomic<std::size_t> running_workers{0};
+	std::mutex               sleep_mutex;
+	std::condition_variable  sleep_cond;
+	std::mutex               idle_mutex;
+	std::condition_variable  idle_cond;
+};
+
+} // namespace tacos::utilities
+
+#include "work_stealing_pool.hpp"
@@ -0,0 +1,260 @@
+/***************************************************************************
+ *  work_stealing_pool.hpp - A thread pool with per-worker priority queues
+ *
+ *  SPDX-License-Identifier: LGPL-3.0-or-later
+ ****************************************************************************/
+
+#pragma once
+
+#include "work_stealing_pool.h"
+
+#include <algorithm>
+#include <mutex>
+
+namespace tacos::utilities {
+
+template <class Priority, class T>
+WorkStealingPool<Priority, T>::WorkStealingPool(StartOnInit start_on_init, std::size_t size)
+: size(std::max(size, std::size_t{1})), worker_queues(this->size)
+{
+	if (start_on_init == StartOnInit::YES) {
+		start();
+	}
+}
+
+template <class Priority, class T>
+WorkStealingPool<Priority, T>::~WorkStealingPool()
+{
+	cancel();
+}
+
+template <class Priority, class T>
+std::pair<const WorkStealingPool<Priority, T> *, std::size_t> &
+WorkStealingPool<Priority, T>::local_worker()
+{
+	thread_local std::pair<const WorkStealingPool *, std::size_t> worker{nullptr, 0};
+	return worker;
+}
+
+template <class Priority, class T>
+void
+WorkStealingPool<Priority, T>::start()
+{
+	if (started) {
+		throw QueueStartedException("Pool already started");
+	}
+	// The shared queue may have been processed with QueueAccess, so count the jobs again.
+	{
+		std::lock_guard guard{queue_mutex};
+		queue_size   = queue.size();
+		queued_jobs  = queue.size();
+		pending_jobs = queue.size();
+	}
+	running_workers = size;
+	for (std::size_t i = 0; i < size; ++i) {
+		workers.push_back(std::thread{[this, i]() { run_worker(i); }});
+	}
+	started = true;
+}
+
+template <class Priority, class T>
+void
+WorkStealingPool<Priority, T>::run_worker(std::size_t index)
+{
+	local_worker() = {this, index};
+	while (!stopping) {
+		if (auto job = get_job(index)) {
+			job->second();
+			complete_job();
+			continue;
+		}
+		if (!queue_open) {
+			break;
+		}
+		// Wait for the stop signal or a new job.
+		std::unique_lock lock{sleep_mutex};
+		++sleeping_workers;
+		sleep_cond.wait(lock, [this] { return stopping || queued_jobs > 0 || !queue_open; });
+		--sleeping_workers;
+	}
+	local_worker() = {nullptr, 0};
+	std::lock_guard guard{idle_mutex};
+	--running_workers;
+	idle_cond.notify_all();
+}
+
+template <class Priority, class T>
+std::optional<typename WorkStealingPool<Priority, T>::Job>
+WorkStealingPool<Priority, T>::get_job(std::size_t index)
+{
+	auto &own = worker_queues[index];
+	if (own.size > 0) {
+		std::lock_guard guard{own.mutex};
+		if (!own.heap.empty()) {
+			std::pop_heap(own.heap.begin(), own.heap.end(), CompareFirstOfPair<Priority, T>{});
+			auto job = std::move(own.heap.back());
+			own.heap.pop_back();
+			--own.size;
+			--queued_jobs;
+			return job;
+		}
+	}
+	return steal_job(index);
+}
+
+template <class Priority, class T>
+std::optional<typename WorkStealingPool<Priority, T>::Job>
+WorkStealingPool<Priority, T>::steal_job(std::size_t index)
+{
+	const CompareFirstOfPair<Priority, T> compare;
+	while (queued_jobs > 0 && !stopping) {
+		// Find the victim whose best job has the highest priority. The shared queue is the victim with index size.
+		std::optional<Priority> best_priority;
+		std::size_t             best_victim = size;
+		for (std::size_t victim = 0; victim < size; ++victim) {
+			auto &victim_queue = worker_queues[victim];
+			if (victim == index || victim_queue.size == 0) {
+				continue;
+			}
+			std::lock_guard guard{victim_queue.mutex};
+			if (!victim_queue.heap.empty()
+			    && (!best_priority || *best_priority < victim_queue.heap.front().first)) {
+				best_priority = victim_queue.heap.front().first;
+				best_victim   = victim;
+			}
+		}
+		if (queue_size > 0) {
+			std::lock_guard guard{queue_mutex};
+			if (!queue.empty() && (!best_priority || *best_priority < queue.top().first)) {
+				Job job{queue.top().first, std::move(const_cast<T &>(queue.top().second))};
+				queue.pop();
+				--queue_size;
+				--queued_jobs;
+				return job;
+			}
+		}
+		if (best_priority) {
+			auto           &victim_queue = worker_queues[best_victim];
+			std::lock_guard guard{victim_queue.mutex};
+			// The job may have been taken in the meantime, in which case we take the next best one or try again.
+			if (!victim_queue.heap.empty()) {
+				std::pop_heap(victim_queue.heap.begin(), victim_queue.heap.end(), compare);
+				auto job = std::move(victim_queue.heap.back());
+				victim_queue.heap.pop_back();
+				--victim_queue.size;
+				--queued_jobs;
+				return job;
+			}
+		} else {
+			// The remaining jobs are still being pushed, or they are in our own queue.
+			if (worker_queues[index].size > 0) {
+				return get_job(index);
+			}
+			std::this_thread::yield();
+		}
+	}
+	return std::nullopt;
+}
+
+template <class Priority, class T>
+void
+WorkStealingPool<Priority, T>::complete_job()
+{
+	if (--pending_jobs == 0) {
+		std::lock_guard guard{idle_mutex};
+		idle_cond.notify_all();
+	}
+}
+
+template <class Priority, class T>
+void
+WorkStealingPool<Priority, T>::add_job(std::pair<Priority, T> &&job)
+{
+	if (!queue_open) {
+		throw QueueClosedException("Queue is closed!");
+	}
+	++pending_jobs;
+	// Count the job before it is pushed, so the counter never drops below the number of queued jobs.
+	++queued_jobs;
+	if (const auto [pool, index] = local_worker(); pool == this) {
+		auto           &own = worker_queues[index];
+		std::lock_guard guard{own.mutex};
+		own.heap.push_back(std::move(job));
+		std::push_heap(own.heap.begin(), own.heap.end(), CompareFirstOfPair<Priority, T>{});
+		++own.size;
+	} else {
+		std::lock_guard guard{queue_mutex};
+		queue.push(std::move(job));
+		++queue_size;
+	}
+	if (sleeping_workers > 0) {
+		std::lock_guard guard{sleep_mutex};
+		sleep_cond.notify_one();
+	}
+}
+
+template <class Priority, class T>
+void
+WorkStealingPool<Priority, T>::add_job(T &&job, const Priority &priority)
+{
+	add_job(std::make_pair(priority, std::move(job)));
+}
+
+template <class Priority, class T>
+void
+WorkStealingPool<Priority, T>::close_queue()
+{
+	queue_open = false;
+}
+
+template <class Priority, class T>
+void
+WorkStealingPool<Priority, T>::wait()
+{
+	std::unique_lock lock{idle_mutex};
+	idle_cond.wait(lock, [this] { return pending_jobs == 0 || running_workers == 0; });
+}
+
+template <class Priority, class T>
+void
+WorkStealingPool<Priority, T>::finish()
+{
+	close_queue();
+	{
+		std::lock_guard guard{sleep_mutex};
+		sleep_cond.notify_all();
+	}
+	for (auto &worker : workers) {
+		if (worker.joinable()) {
+			worker.join();
+		}
+	}
+}
+
+template <class Priority, class T>
+std::size_t
+WorkStealingPool<Priority, T>::get_num_threads() const
+{
+	return size;
+}
+
+template <class Priority, class T>
+void
+WorkStealingPool<Priority, T>::set_num_threads(std::size_t num_threads)
+{
+	if (started) {
+		throw QueueStartedException("Pool already started");
+	}
+	size          = std::max(num_threads, std::size_t{1});
+	worker_queues = std::vector<WorkerQueue>(size);
+}
+
+template <class Priority, class T>
+void
+WorkStealingPool<Priority, T>::cancel()
+{
+	stopping = true;
+	finish();
+}
+
+} // namespace tacos::utilities
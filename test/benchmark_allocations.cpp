@@ -0,0 +1,100 @@
+/***************************************************************************
+ *  benchmark_allocations.cpp - Count heap allocations of the zone search
+ *
+ *  SPDX-License-Identifier: LGPL-3.0-or-later
+ ****************************************************************************/
+
+#include "automata/ta.h"
+#include "automata/ta_product.h"
+#include "mtl/MTLFormula.h"
+#include "mtl_ata_translation/translator.h"
+#include "railroad.h"
+#include "search/heuristics.h"
+#include "search/search.h"
+
+#include <benchmark/benchmark.h>
+#include <spdlog/spdlog.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+std::atomic<std::size_t> allocations{0};
+} // namespace
+
+// Count every allocation of the benchmark binary.
+void *
+operator new(std::size_t size)
+{
+	allocations.fetch_add(1, std::memory_order_relaxed);
+	if (void *p = std::malloc(size == 0 ? 1 : size)) {
+		return p;
+	}
+	throw std::bad_alloc{};
+}
+
+void
+operator delete(void *p) noexcept
+{
+	std::free(p);
+}
+
+void
+operator delete(void *p, std::size_t) noexcept
+{
+	std::free(p);
+}
+
+using namespace tacos;
+
+using AP         = logic::AtomicProposition<std::string>;
+using TreeSearch = search::ZoneTreeSearch<automata::ta::Location<std::vector<std::string>>, std::string>;
+
+/** Build the railroad search tree single-threaded and report the allocations per expanded node, which is
+ * deterministic unlike the running time. */
+static void
+BM_Railroad_zone_allocations(benchmark::State &state)
+{
+	spdlog::set_level(spdlog::level::err);
+	const auto   problem             = create_crossing_problem({2});
+	auto         plant               = std::get<0>(problem);
+	auto         spec                = std::get<1>(problem);
+	auto         controller_actions  = std::get<2>(problem);
+	auto         environment_actions = std::get<3>(problem);
+	std::set<AP> actions;
+	std::set_union(begin(controller_actions),
+	               end(controller_actions),
+	               begin(environment_actions),
+	               end(environment_actions),
+	               inserter(actions, end(actions)));
+	auto               ata = mtl_ata_translation::translate(spec, actions);
+	const unsigned int K   = std::max(plant.get_largest_constant(), spec.get_largest_constant());
+
+	std::size_t tree_size        = 0;
+	std::size_t allocation_count = 0;
+
+	for (auto _ : state) {
+		TreeSearch search{&plant,
+		                  &ata,
+		                  controller_actions,
+		                  environment_actions,
+		                  K,
+		                  true,
+		                  true,
+		                  std::make_unique<search::BfsHeuristic<long, TreeSearch::Node>>()};
+
+		const std::size_t before = allocations.load(std::memory_order_relaxed);
+		search.build_tree(false);
+		allocation_count += allocations.load(std::memory_order_relaxed) - before;
+		tree_size += search.get_size();
+	}
+	state.counters["tree_size"] =
+	  benchmark::Counter(static_cast<double>(tree_size), benchmark::Counter::kAvgIterations);
+	state.counters["allocations"] =
+	  benchmark::Counter(static_cast<double>(allocation_count), benchmark::Counter::kAvgIterations);
+	state.counters["allocations_per_node"] =
+	  benchmark::Counter(static_cast<double>(allocation_count) / static_cast<double>(tree_size));
+}
+
+BENCHMARK(BM_Railroad_zone_allocations)->Unit(benchmark::kMillisecond);
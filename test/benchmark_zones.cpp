@@ -221,7 +221,7 @@ BENCHMARK_CAPTURE(BM_Robot_zone, weighted, true)
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~RAILROAD~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 
 static void
-BM_Railroad_zone(benchmark::State &state, Mode mode, bool multi_threaded = true)
+BM_Railroad_zone(benchmark::State &state, Mode mode, bool multi_threaded = true, bool merge_words = false)
 {
 	spdlog::set_level(spdlog::level::err);
 	spdlog::set_pattern("%t %v");
@@ -255,6 +255,7 @@ BM_Railroad_zone(benchmark::State &state, Mode mode, bool multi_threaded = true)
 	std::size_t pruned_tree_size = 0;
 	std::size_t controller_size  = 0;
 	std::size_t plant_size       = 0;
+	std::size_t word_count       = 0;
 
 	std::unique_ptr<search::Heuristic<long, TreeSearch::Node>> heuristic;
 
@@ -289,8 +290,17 @@ BM_Railroad_zone(benchmark::State &state, Mode mode, bool multi_threaded = true)
 			}
 			break;
 		}
-		TreeSearch search{
-		  &plant, &ata, controller_actions, environment_actions, K, true, true, std::move(heuristic)};
+		TreeSearch search{&plant,
+		                  &ata,
+		                  controller_actions,
+		                  environment_actions,
+		                  K,
+		                  true,
+		                  true,
+		                  std::move(heuristic),
+		                  false,
+		                  false,
+		                  merge_words};
 
 		search.build_tree(multi_threaded);
 		search.label();
@@ -298,7 +308,8 @@ BM_Railroad_zone(benchmark::State &state, Mode mode, bool multi_threaded = true)
 		tree_size += search.get_size();
 		std::for_each(std::begin(search.get_nodes()),
 		              std::end(search.get_nodes()),
-		              [&pruned_tree_size](const auto &node) {
+		              [&pruned_tree_size, &word_count](const auto &node) {
+			              word_count += node.second->words.size();
 			              if (node.second->label != search::NodeLabel::CANCELED
 			                  && node.second->label != search::NodeLabel::UNLABELED) {
 				              pruned_tree_size += 1;
@@ -316,6 +327,8 @@ BM_Railroad_zone(benchmark::State &state, Mode mode, bool multi_threaded = true)
 	  benchmark::Counter(static_cast<double>(controller_size), benchmark::Counter::kAvgIterations);
 	state.counters["plant_size"] =
 	  benchmark::Counter(static_cast<double>(plant_size), benchmark::Counter::kAvgIterations);
+	state.counters["words"] =
+	  benchmark::Counter(static_cast<double>(word_count), benchmark::Counter::kAvgIterations);
 }
 
 // Range all over all heuristics individually.
@@ -336,6 +349,12 @@ BENCHMARK_CAPTURE(BM_Railroad_zone, weighted_single_thread, Mode::WEIGHTED, fals
   ->MeasureProcessCPUTime()
   ->Unit(benchmark::kSecond)
   ->UseRealTime();
+// Merging the zone words of each child, compare with single_heuristic_single_thread.
+BENCHMARK_CAPTURE(BM_Railroad_zone, merge_words_single_thread, Mode::SIMPLE, false, true)
+  ->DenseRange(0, 5, 1)
+  ->MeasureProcessCPUTime()
+  ->Unit(benchmark::kSecond)
+  ->UseRealTime();
 // Weighted heuristics.
 BENCHMARK_CAPTURE(BM_Railroad_zone, weighted, Mode::WEIGHTED)
   ->ArgsProduct({benchmark::CreateRange(1, 16, 2),
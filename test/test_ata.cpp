@@ -317,6 +317,66 @@ TEST_CASE("Time-bounded response two-state ATA (example by Ouaknine & Worrell, 2
 	}
 }
 
+TEST_CASE("Active locations of an ATA", "[automata][ata]")
+{
+	std::set<Transition<std::string, std::string>> transitions;
+	transitions.insert(Transition<std::string, std::string>(
+	  "s0",
+	  "a",
+	  std::make_unique<ConjunctionFormula<std::string>>(
+	    std::make_unique<LocationFormula<std::string>>("s0"),
+	    std::make_unique<ResetClockFormula<std::string>>(
+	      std::make_unique<LocationFormula<std::string>>("s1")))));
+	transitions.insert(Transition<std::string, std::string>(
+	  "s1",
+	  "b",
+	  std::make_unique<DisjunctionFormula<std::string>>(
+	    std::make_unique<ClockConstraintFormula<std::string>>(
+	      AtomicClockConstraintT<std::equal_to<Time>>(1.)),
+	    std::make_unique<LocationFormula<std::string>>("s2"))));
+	transitions.insert(Transition<std::string, std::string>(
+	  "s2", "a", std::make_unique<LocationFormula<std::string>>("s1")));
+	transitions.insert(Transition<std::string, std::string>(
+	  "s2",
+	  "b",
+	  std::make_unique<ResetClockFormula<std::string>>(
+	    std::make_unique<LocationFormula<std::string>>("s3"))));
+	AlternatingTimedAutomaton<std::string, std::string> ata({"a", "b"},
+	                                                        "s0",
+	                                                        {"s0"},
+	                                                        std::move(transitions));
+	// s0 only reaches s1 with a reset, s2 keeps its clock when moving to s1.
+	CHECK(ata.get_active_locations() == std::set<std::string>{"s1", "s2"});
+	// s3 has no transitions and is only reached with a reset.
+	CHECK(ata.get_locations() == std::set<std::string>{"s0", "s1", "s2", "s3"});
+}
+
+TEST_CASE("Look up ATA transitions", "[automata][ata]")
+{
+	std::set<Transition<std::string, std::string>> transitions;
+	transitions.insert(Transition<std::string, std::string>(
+	  "s0", "a", std::make_unique<LocationFormula<std::string>>("s1")));
+	transitions.insert(Transition<std::string, std::string>(
+	  "s0", "b", std::make_unique<LocationFormula<std::string>>("s0")));
+	transitions.insert(Transition<std::string, std::string>(
+	  "s1", "a", std::make_unique<LocationFormula<std::string>>("s0")));
+	AlternatingTimedAutomaton<std::string, std::string> ata({"a", "b"},
+	                                                        "s0",
+	                                                        {"s0"},
+	                                                        std::move(transitions));
+	for (const auto &transition : ata.get_transitions()) {
+		CHECK(ata.get_transition(transition.source_, transition.symbol_) == &transition);
+	}
+	CHECK(ata.get_transition("s1", "b") == nullptr);
+	CHECK(ata.get_transition("s2", "a") == nullptr);
+	// A moved ATA looks up its own transitions.
+	auto moved = std::make_unique<AlternatingTimedAutomaton<std::string, std::string>>(std::move(ata));
+	for (const auto &transition : moved->get_transitions()) {
+		CHECK(moved->get_transition(transition.source_, transition.symbol_) == &transition);
+	}
+	CHECK(moved->get_transition("s1", "b") == nullptr);
+}
+
 TEST_CASE("Create an ATA with a non-string location type", "[ta]")
 {
 	std::set<Transition<unsigned int, std::string>> transitions;
@@ -0,0 +1,212 @@
+#include "automata/automata_zones.h"
+#include "automata/dbm_kernels.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace {
+
+using namespace tacos;
+using zones::DBM_Bound;
+using zones::DBM_BOUND_INFINITY;
+using zones::InstructionSet;
+
+std::vector<DBM_Bound>
+random_bounds(std::mt19937 &rng, std::size_t n)
+{
+	std::uniform_int_distribution<int>  value(-20, 20);
+	std::uniform_int_distribution<int>  strict(0, 1);
+	std::uniform_int_distribution<int>  unbounded(0, 3);
+	std::vector<DBM_Bound>              bounds(n);
+	for (auto &bound : bounds) {
+		bound = unbounded(rng) == 0 ? DBM_BOUND_INFINITY : zones::make_bound(value(rng), strict(rng) == 1);
+	}
+	return bounds;
+}
+
+TEST_CASE("DBM kernels agree with the scalar reference", "[zones][dbm_kernels]")
+{
+	const auto instruction_set =
+	  GENERATE(InstructionSet::SCALAR, InstructionSet::SSE2, InstructionSet::AVX2);
+	if (!zones::is_supported(instruction_set)) {
+		//Nothing to compare on this CPU
+		return;
+	}
+
+	const auto &reference = zones::get_dbm_kernels(InstructionSet::SCALAR);
+	const auto &kernels   = zones::get_dbm_kernels(instruction_set);
+
+	std::mt19937 rng{42};
+	//Cover the vector widths as well as the scalar tails
+	const std::size_t n = GENERATE(0, 1, 3, 4, 7, 8, 9, 16, 17, 31);
+
+	SECTION("Row relaxation")
+	{
+		for (int run = 0; run < 20; run++) {
+			const auto row_k       = random_bounds(rng, n);
+			auto       row_i       = random_bounds(rng, n);
+			auto       expected    = row_i;
+			const auto distance_ik = zones::make_bound(run - 10, run % 2 == 0);
+
+			reference.relax_row(expected.data(), row_k.data(), distance_ik, n);
+			kernels.relax_row(row_i.data(), row_k.data(), distance_ik, n);
+			CHECK(row_i == expected);
+		}
+	}
+
+	SECTION("Relaxing a row is the same as adding the bounds")
+	{
+		const auto row_k = random_bounds(rng, n);
+		auto       row_i = std::vector<DBM_Bound>(n, DBM_BOUND_INFINITY);
+		kernels.relax_row(row_i.data(), row_k.data(), zones::make_bound(2, false), n);
+		for (std::size_t j = 0; j < n; j++) {
+			CHECK(row_i[j] == zones::add_bounds(zones::make_bound(2, false), row_k[j]));
+		}
+	}
+
+	SECTION("Inclusion")
+	{
+		for (int run = 0; run < 20; run++) {
+			const auto lhs = random_bounds(rng, n);
+			auto       rhs = lhs;
+			CHECK(kernels.is_less_equal(lhs.data(), rhs.data(), n));
+			if (n == 0) {
+				continue;
+			}
+			//A single larger bound anywhere breaks the inclusion, in particular in the tail
+			const std::size_t position = rng() % n;
+			if (rhs[position] == DBM_BOUND_INFINITY) {
+				continue;
+			}
+			rhs[position] -= 1;
+			CHECK(!kernels.is_less_equal(lhs.data(), rhs.data(), n));
+			CHECK(kernels.is_less_equal(rhs.data(), lhs.data(), n));
+
+			const auto other = random_bounds(rng, n);
+			CHECK(kernels.is_less_equal(lhs.data(), other.data(), n)
+			      == reference.is_less_equal(lhs.data(), other.data(), n));
+		}
+	}
+
+	SECTION("Normalization")
+	{
+		for (int run = 0; run < 20; run++) {
+			auto       bounds   = random_bounds(rng, n);
+			auto       expected = bounds;
+			const auto upper    = zones::make_bound(run % 10, true);
+			const auto lower    = zones::make_bound(-(run % 10), false);
+
+			reference.normalize(expected.data(), n, upper, lower);
+			kernels.normalize(bounds.data(), n, upper, lower);
+			CHECK(bounds == expected);
+			for (const auto bound : bounds) {
+				CHECK((bound == DBM_BOUND_INFINITY || (bound <= upper && bound >= lower)));
+			}
+		}
+	}
+}
+
+TEST_CASE("Closing a DBM with the best kernels", "[zones][dbm_kernels]")
+{
+	CHECK(zones::is_supported(zones::get_best_instruction_set()));
+
+	const automata::ClockConstraint c_le3 = automata::AtomicClockConstraintT<std::less_equal<Time>>(3);
+	const automata::ClockConstraint c_gt5 = automata::AtomicClockConstraintT<std::greater<Time>>(5);
+	const automata::ClockConstraint c_lt5 = automata::AtomicClockConstraintT<std::less<Time>>(5);
+
+	zones::Zone_DBM dbm{std::set<std::string>{"x", "y", "z"}, 10};
+	dbm.conjunct("x", c_le3);
+	dbm.conjunct("y", c_gt5);
+	CHECK(dbm.is_consistent());
+	CHECK(dbm.at("x", "y") == zones::DBM_Entry{-2, false});
+
+	dbm.conjunct("y", c_lt5);
+	CHECK(!dbm.is_consistent());
+}
+
+TEST_CASE("Closing DBMs of fixed and dynamic dimension", "[zones][dbm_kernels]")
+{
+	std::mt19937 rng{7};
+	//Up to DBM_INLINE_DIMENSION the closure is specialized, above it falls back to the kernels
+	const std::size_t clocks = GENERATE(0, 1, 2, 5, 8, 9, 12);
+
+	std::vector<zones::ClockID> clock_ids;
+	for (std::size_t i = 0; i < clocks; i++) {
+		clock_ids.push_back(static_cast<zones::ClockID>(i + 1));
+	}
+	zones::Graph graph{clock_ids};
+	const std::size_t n = graph.size();
+	CHECK(n == clocks + 1);
+
+	//Positive weights only, so that there are no negative cycles
+	std::uniform_int_distribution<int> value(1, 20);
+	std::uniform_int_distribution<int> strict(0, 1);
+	std::uniform_int_distribution<int> unbounded(0, 2);
+	for (std::size_t i = 0; i < n; i++) {
+		for (std::size_t j = 0; j < n; j++) {
+			graph.get(i, j) = i == j                ? zones::DBM_BOUND_LE_ZERO
+			                  : unbounded(rng) == 0 ? DBM_BOUND_INFINITY
+			                                        : zones::make_bound(value(rng), strict(rng) == 1);
+		}
+	}
+
+	std::vector<DBM_Bound> expected(graph.data(), graph.data() + n * n);
+	for (std::size_t k = 0; k < n; k++) {
+		for (std::size_t i = 0; i < n; i++) {
+			for (std::size_t j = 0; j < n; j++) {
+				expected[i * n + j] =
+				  std::min(expected[i * n + j], zones::add_bounds(expected[i * n + k], expected[k * n + j]));
+			}
+		}
+	}
+
+	SECTION("Floyd-Warshall")
+	{
+		graph.floyd_warshall();
+	}
+	SECTION("Closing over all vertices")
+	{
+		std::vector<std::size_t> vertices(n);
+		std::iota(vertices.begin(), vertices.end(), 0);
+		CHECK(graph.close_over(vertices));
+	}
+	CHECK(std::vector<DBM_Bound>(graph.data(), graph.data() + n * n) == expected);
+}
+
+TEST_CASE("Inline arrays", "[zones][dbm_kernels]")
+{
+	using Array = zones::Inline_Array<int, 3>;
+
+	Array array(2, 5);
+	CHECK(array.is_inline());
+	array.push_back(6);
+	CHECK(array.is_inline());
+	array.push_back(7);
+	CHECK(!array.is_inline());
+	CHECK(std::vector<int>(array.begin(), array.end()) == std::vector<int>{5, 5, 6, 7});
+
+	Array copy = array;
+	CHECK(copy == array);
+	copy.erase(1);
+	CHECK(copy.is_inline());
+	CHECK(std::vector<int>(copy.begin(), copy.end()) == std::vector<int>{5, 6, 7});
+	CHECK(array < copy);
+
+	Array moved = std::move(array);
+	CHECK(moved.size() == 4);
+	CHECK(array.size() == 0);
+	CHECK(moved[3] == 7);
+
+	moved = copy;
+	CHECK(moved == copy);
+	moved.erase(0);
+	CHECK(std::vector<int>(moved.begin(), moved.end()) == std::vector<int>{6, 7});
+}
+
+} // namespace
@@ -12,6 +12,8 @@
 
 #include <catch2/catch_test_macros.hpp>
 #include <iostream>
+#include <type_traits>
+#include <unordered_set>
 #include <vector>
 
 namespace {
@@ -217,6 +219,54 @@ TEST_CASE("MTL Formula comparison operators", "[libmtl]")
 	      != phi1.dual_until(phi2, utilities::arithmetic::Interval<Endpoint>{1, 2}));
 }
 
+TEST_CASE("Hashing MTL formulas", "[libmtl]")
+{
+	logic::AtomicProposition a{std::string("a")};
+	logic::AtomicProposition b{std::string("b")};
+
+	logic::MTLFormula phi1{a};
+	logic::MTLFormula phi2{b};
+
+	std::hash<logic::MTLFormula<std::string>> hash;
+	CHECK(hash(phi1 && phi2) == hash(logic::MTLFormula{a} && logic::MTLFormula{b}));
+	CHECK(hash(phi1.until(phi2, {1, 4})) == hash(phi1.until(phi2, {1, 4})));
+	CHECK(hash(phi1 && phi2) != hash(phi1 || phi2));
+	CHECK(hash(phi1.until(phi2)) != hash(phi1.until(phi2, {1, 4})));
+	CHECK(std::unordered_set{phi1, phi2, phi1 && phi2, logic::MTLFormula{a}}.size() == 3);
+}
+
+TEST_CASE("Hash-consing MTL formulas", "[libmtl]")
+{
+	logic::AtomicProposition a{std::string("a")};
+	logic::AtomicProposition b{std::string("b")};
+
+	logic::MTLFormula phi1{a};
+	logic::MTLFormula phi2{b};
+
+	// Equal formulas share their node and thus their ID, no matter how they were constructed.
+	CHECK((phi1 && phi2).get_id() == (logic::MTLFormula{a} && logic::MTLFormula{b}).get_id());
+	CHECK(phi1.until(phi2, {1, 4}).get_id() == phi1.until(phi2, {1, 4}).get_id());
+	CHECK(phi1.until(phi2).get_id() != phi1.until(phi2, {1, 4}).get_id());
+	CHECK((phi1 && phi2).get_id() != (phi2 && phi1).get_id());
+	CHECK((phi1 && phi2).get_operands().front().get_id() == phi1.get_id());
+	CHECK((!(!phi1)).to_positive_normal_form().get_id() == phi1.get_id());
+	CHECK((!phi1.until(phi2, {1, 4})).to_positive_normal_form()
+	      == (!phi1).dual_until(!phi2, {1, 4}));
+
+	// A formula is only a pointer to its node, so copying it doesn't touch a shared reference count.
+	static_assert(std::is_trivially_copyable_v<logic::MTLFormula<std::string>>);
+
+	// A moved-from formula is still valid.
+	logic::MTLFormula phi3 = phi1 || phi2;
+	logic::MTLFormula phi4 = std::move(phi3);
+	CHECK(phi3 == phi4);
+
+	// The order does not depend on the IDs.
+	CHECK(phi1 < phi2);
+	CHECK(!(phi2 < phi1));
+	CHECK(!(phi1 < phi1));
+}
+
 TEST_CASE("Get subformulas of type", "[libmtl]")
 {
 	logic::AtomicProposition<std::string> a{"a"};
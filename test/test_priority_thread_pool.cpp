@@ -7,20 +7,26 @@
  ****************************************************************************/
 
 
+#include "utilities/multi_queue_pool.h"
 #include "utilities/priority_thread_pool.h"
 #include "utilities/priority_thread_pool.hpp"
+#include "utilities/work_stealing_pool.h"
 
 #include <catch2/catch_test_macros.hpp>
+#include <atomic>
 #include <chrono>
 #include <condition_variable>
+#include <functional>
 #include <mutex>
 #include <set>
 #include <thread>
 
 using namespace tacos;
 
+using utilities::MultiQueuePool;
 using utilities::QueueAccess;
 using utilities::ThreadPool;
+using utilities::WorkStealingPool;
 
 TEST_CASE("Create and run a priority thread pool", "[threading]")
 {
@@ -140,11 +146,234 @@ TEST_CASE("Direct access to a thread pool", "[threading]")
 		CHECK(queue_access.empty());
 		CHECK(res == std::set{0, 1, 2, 3, 4, 5, 6, 7, 8, 9});
 	}
+	SECTION("Take the jobs out of the queue")
+	{
+		for (int i = 9; i >= 0; --i) {
+			REQUIRE(!queue_access.empty());
+			auto [priority, f] = queue_access.take();
+			CHECK(priority == i);
+			f();
+		}
+		CHECK(queue_access.empty());
+		CHECK(res == std::set{0, 1, 2, 3, 4, 5, 6, 7, 8, 9});
+	}
 	SECTION("Cannot access the queue if the pool is running")
 	{
 		pool.start();
 		CHECK_THROWS_AS(queue_access.empty(), utilities::QueueStartedException);
 		CHECK_THROWS_AS(queue_access.top(), utilities::QueueStartedException);
 		CHECK_THROWS_AS(queue_access.pop(), utilities::QueueStartedException);
+		CHECK_THROWS_AS(queue_access.take(), utilities::QueueStartedException);
+		CHECK_THROWS_AS(pool.set_num_threads(1), utilities::QueueStartedException);
+	}
+}
+
+TEST_CASE("Run a work-stealing thread pool", "[threading]")
+{
+	std::set<int> res;
+	std::mutex    res_mutex;
+	SECTION("Starting some simple jobs")
+	{
+		WorkStealingPool pool{};
+		for (int i = 0; i < 10; ++i) {
+			pool.add_job(std::make_pair(i, [&res_mutex, &res, i]() {
+				std::lock_guard<std::mutex> guard{res_mutex};
+				res.insert(i);
+			}));
+		}
+		pool.finish();
+		CHECK(res == std::set{0, 1, 2, 3, 4, 5, 6, 7, 8, 9});
+	}
+	SECTION("Exception occurs when pushing to a closed queue")
+	{
+		WorkStealingPool pool{};
+		pool.close_queue();
+		CHECK_THROWS_AS(pool.add_job(std::make_pair(0, [] {})), utilities::QueueClosedException);
+		CHECK_THROWS_AS(pool.start(), utilities::QueueStartedException);
+	}
+	SECTION("Process the queue synchronously")
+	{
+		WorkStealingPool pool{WorkStealingPool<>::StartOnInit::NO};
+		for (int i = 0; i < 10; ++i) {
+			pool.add_job(std::make_pair(i, [&res_mutex, &res, i]() {
+				std::lock_guard<std::mutex> guard{res_mutex};
+				res.insert(i);
+			}));
+		}
+		QueueAccess queue_access{&pool};
+		CHECK(queue_access.get_size() == 10);
+		for (int i = 9; i >= 0; --i) {
+			REQUIRE(!queue_access.empty());
+			auto &[priority, f] = queue_access.top();
+			CHECK(priority == i);
+			f();
+			queue_access.pop();
+		}
+		CHECK(queue_access.empty());
+		CHECK(res == std::set{0, 1, 2, 3, 4, 5, 6, 7, 8, 9});
+		pool.start();
+		CHECK_THROWS_AS(queue_access.empty(), utilities::QueueStartedException);
+	}
+	SECTION("Set the number of workers before starting")
+	{
+		WorkStealingPool pool{WorkStealingPool<>::StartOnInit::NO, 1};
+		pool.set_num_threads(3);
+		CHECK(pool.get_num_threads() == 3);
+		for (int i = 0; i < 10; ++i) {
+			pool.add_job(std::make_pair(i, [&res_mutex, &res, i]() {
+				std::lock_guard<std::mutex> guard{res_mutex};
+				res.insert(i);
+			}));
+		}
+		pool.start();
+		CHECK_THROWS_AS(pool.set_num_threads(1), utilities::QueueStartedException);
+		pool.finish();
+		CHECK(res == std::set{0, 1, 2, 3, 4, 5, 6, 7, 8, 9});
+	}
+}
+
+TEST_CASE("Run a thread pool with a MultiQueue", "[threading]")
+{
+	SECTION("A single worker with a single heap processes jobs in priority order")
+	{
+		MultiQueuePool<int> pool{MultiQueuePool<>::StartOnInit::NO, 1, 1};
+		std::vector<int>    res;
+		for (int i = 0; i < 10; ++i) {
+			pool.add_job([&res, i] { res.push_back(i); }, i);
+		}
+		pool.start();
+		pool.finish();
+		CHECK(res == std::vector{9, 8, 7, 6, 5, 4, 3, 2, 1, 0});
+	}
+	SECTION("Setting the number of workers keeps the heaps per worker")
+	{
+		MultiQueuePool<int> pool{MultiQueuePool<>::StartOnInit::NO, 4, 1};
+		pool.set_num_threads(1);
+		CHECK(pool.get_num_threads() == 1);
+		std::vector<int> res;
+		for (int i = 0; i < 10; ++i) {
+			pool.add_job([&res, i] { res.push_back(i); }, i);
+		}
+		pool.start();
+		CHECK_THROWS_AS(pool.set_num_threads(4), utilities::QueueStartedException);
+		pool.finish();
+		CHECK(res == std::vector{9, 8, 7, 6, 5, 4, 3, 2, 1, 0});
+	}
+	SECTION("Process the queue synchronously")
+	{
+		MultiQueuePool<int> pool{MultiQueuePool<>::StartOnInit::NO};
+		for (int i = 0; i < 10; ++i) {
+			pool.add_job([] {}, i);
+		}
+		QueueAccess queue_access{&pool};
+		CHECK(queue_access.get_size() == 10);
+		CHECK(queue_access.top().first == 9);
+		queue_access.pop();
+		CHECK(queue_access.get_size() == 9);
+		pool.start();
+		CHECK_THROWS_AS(queue_access.top(), utilities::QueueStartedException);
+		pool.finish();
+	}
+}
+
+namespace {
+/** Let each job add two new jobs to the pool until a binary tree of jobs with the given depth has been run.
+ * @param pool The pool to run the jobs with, it must not be started yet
+ * @param depth The depth of the tree of jobs
+ * @return The number of jobs that have been run
+ */
+template <typename Pool>
+int
+spawn_jobs(Pool &pool, int depth)
+{
+	std::atomic<int>         count{0};
+	std::function<void(int)> spawn = [&](int remaining) {
+		++count;
+		if (remaining > 0) {
+			for (int i = 0; i < 2; ++i) {
+				pool.add_job([&spawn, remaining] { spawn(remaining - 1); }, remaining);
+			}
+		}
+	};
+	pool.add_job([&spawn, depth] { spawn(depth); });
+	pool.start();
+	pool.wait();
+	return count;
+}
+
+/** A job that is not type-erased, similar to the jobs that expand search nodes */
+struct CountJob
+{
+	std::atomic<int> *count;
+	void
+	operator()() const
+	{
+		++*count;
+	}
+};
+} // namespace
+
+TEST_CASE("Jobs add new jobs to the queue", "[threading]")
+{
+	// A binary tree of depth 10 has 2^11 - 1 nodes.
+	SECTION("ThreadPool")
+	{
+		ThreadPool<int> pool{ThreadPool<>::StartOnInit::NO, 4};
+		CHECK(spawn_jobs(pool, 10) == 2047);
+		pool.finish();
+		CHECK_THROWS_AS(pool.add_job([] {}), utilities::QueueClosedException);
+	}
+	SECTION("WorkStealingPool")
+	{
+		WorkStealingPool<int> pool{WorkStealingPool<>::StartOnInit::NO, 4};
+		CHECK(spawn_jobs(pool, 10) == 2047);
+		pool.finish();
+		CHECK_THROWS_AS(pool.add_job([] {}), utilities::QueueClosedException);
+	}
+	SECTION("MultiQueuePool")
+	{
+		MultiQueuePool<int> pool{MultiQueuePool<>::StartOnInit::NO, 4};
+		CHECK(spawn_jobs(pool, 10) == 2047);
+		pool.finish();
+		CHECK_THROWS_AS(pool.add_job([] {}), utilities::QueueClosedException);
+	}
+}
+
+TEST_CASE("Run jobs of a plain callable type", "[threading]")
+{
+	std::atomic<int> count{0};
+	SECTION("ThreadPool")
+	{
+		ThreadPool<long, CountJob> pool{ThreadPool<long, CountJob>::StartOnInit::NO, 2};
+		CHECK(pool.get_num_threads() == 2);
+		for (long i = 0; i < 100; ++i) {
+			pool.add_job(CountJob{&count}, i);
+		}
+		QueueAccess queue_access{&pool};
+		queue_access.top().second();
+		queue_access.pop();
+		pool.start();
+		pool.finish();
+	}
+	SECTION("WorkStealingPool")
+	{
+		WorkStealingPool<long, CountJob> pool{WorkStealingPool<long, CountJob>::StartOnInit::NO, 2};
+		CHECK(pool.get_num_threads() == 2);
+		for (long i = 0; i < 100; ++i) {
+			pool.add_job(CountJob{&count}, i);
+		}
+		pool.start();
+		pool.finish();
+	}
+	SECTION("MultiQueuePool")
+	{
+		MultiQueuePool<long, CountJob> pool{MultiQueuePool<long, CountJob>::StartOnInit::NO, 2};
+		CHECK(pool.get_num_threads() == 2);
+		for (long i = 0; i < 100; ++i) {
+			pool.add_job(CountJob{&count}, i);
+		}
+		pool.start();
+		pool.finish();
 	}
+	CHECK(count == 100);
 }
@@ -39,6 +39,8 @@
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/generators/catch_generators.hpp>
 #include <iterator>
+#include <map>
+#include <set>
 
 #undef TRUE
 
@@ -55,6 +57,18 @@ using search::NodeLabel;
 using TreeSearch =
   search::RegionTreeSearch<automata::ta::Location<std::vector<std::string>>, std::string>;
 
+/** Get the label of each node by its words, which unlike the node keys do not depend on the order of expansion. */
+template <typename Search>
+auto
+get_labels(Search &search)
+{
+	std::map<decltype(search.get_root()->words), NodeLabel> labels;
+	for (const auto &[key, node] : search.get_nodes()) {
+		labels.emplace(node->words, node->label);
+	}
+	return labels;
+}
+
 TEST_CASE("Railroad", "[railroad]")
 {
 	const auto &[plant, spec, controller_actions, environment_actions] = create_crossing_problem({2});
@@ -95,6 +109,88 @@ TEST_CASE("Railroad", "[railroad]")
 #endif
 }
 
+TEST_CASE("Railroad with alternative search configurations", "[railroad][search]")
+{
+	using RailroadLocation = automata::ta::Location<std::vector<std::string>>;
+	using Plant            = automata::ta::TimedAutomaton<std::vector<std::string>, std::string>;
+	const auto &[plant, spec, controller_actions, environment_actions] = create_crossing_problem({2});
+	std::set<AP> actions;
+	std::set_union(begin(controller_actions),
+	               end(controller_actions),
+	               begin(environment_actions),
+	               end(environment_actions),
+	               inserter(actions, end(actions)));
+	auto               ata = mtl_ata_translation::translate(spec, actions);
+	const unsigned int K   = std::max(plant.get_largest_constant(), spec.get_largest_constant());
+	// Without incremental labeling, no node is canceled, so on this instance all configurations build the same graph.
+	TreeSearch search{&plant, &ata, controller_actions, environment_actions, K};
+	search.build_tree(false);
+	search.label();
+	REQUIRE(search.get_root()->label == NodeLabel::TOP);
+	const auto labels = get_labels(search);
+	REQUIRE(labels.size() == search.get_size());
+
+	SECTION("Work-stealing pool")
+	{
+		search::RegionTreeSearch<RailroadLocation, std::string, std::string, false, Plant, false, false, utilities::WorkStealingPool>
+		  parallel_search{&plant, &ata, controller_actions, environment_actions, K};
+		parallel_search.set_num_threads(4);
+		parallel_search.build_tree(true);
+		parallel_search.label();
+		CHECK(get_labels(parallel_search) == labels);
+	}
+	SECTION("MultiQueue pool")
+	{
+		search::RegionTreeSearch<RailroadLocation, std::string, std::string, false, Plant, false, false, utilities::MultiQueuePool>
+		  relaxed_search{&plant, &ata, controller_actions, environment_actions, K};
+		relaxed_search.set_num_threads(4);
+		relaxed_search.build_tree(true);
+		relaxed_search.label();
+		CHECK(get_labels(relaxed_search) == labels);
+	}
+	SECTION("Ordered node table")
+	{
+		search::RegionTreeSearch<RailroadLocation, std::string, std::string, false, Plant, false, true>
+		  ordered_search{&plant, &ata, controller_actions, environment_actions, K};
+		ordered_search.set_num_threads(4);
+		ordered_search.build_tree(true);
+		ordered_search.label();
+		CHECK(get_labels(ordered_search) == labels);
+	}
+	SECTION("Parallel successor computation")
+	{
+		TreeSearch fanout_search{&plant, &ata, controller_actions, environment_actions, K};
+		fanout_search.set_num_threads(4);
+		fanout_search.set_parallel_successor_threshold(1);
+		fanout_search.build_tree(true);
+		fanout_search.label();
+		CHECK(get_labels(fanout_search) == labels);
+	}
+	SECTION("Zone search")
+	{
+		using ZoneSearch = search::ZoneTreeSearch<RailroadLocation, std::string>;
+		ZoneSearch zone_search{&plant, &ata, controller_actions, environment_actions, K};
+		zone_search.build_tree(false);
+		zone_search.label();
+		CHECK(zone_search.get_root()->label == NodeLabel::TOP);
+		ZoneSearch parallel_zone_search{&plant, &ata, controller_actions, environment_actions, K};
+		parallel_zone_search.set_num_threads(4);
+		parallel_zone_search.set_parallel_successor_threshold(1);
+		parallel_zone_search.build_tree(true);
+		parallel_zone_search.label();
+		CHECK(parallel_zone_search.get_root()->label == NodeLabel::TOP);
+		// The ancestors of a node depend on the expansion order, so the searches may stop at different nodes
+		// because of monotonic domination. The nodes in both graphs must have the same labels.
+		const auto zone_labels          = get_labels(zone_search);
+		const auto parallel_zone_labels = get_labels(parallel_zone_search);
+		for (const auto &[words, label] : parallel_zone_labels) {
+			if (const auto it = zone_labels.find(words); it != std::end(zone_labels)) {
+				CHECK(it->second == label);
+			}
+		}
+	}
+}
+
 TEST_CASE("Railroad crossing benchmark", "[.benchmark][railroad]")
 {
 	spdlog::set_level(spdlog::level::debug);
@@ -10,6 +10,7 @@
 #include "mtl/MTLFormula.h"
 #include "mtl_ata_translation/translator.h"
 #include "search/create_controller.h"
+#include "search/node_table.h"
 #include "search/search.h"
 #include "search/search_tree.h"
 #include "search/synchronous_product.h"
@@ -21,10 +22,14 @@
 #include <spdlog/spdlog.h>
 
 #include <catch2/catch_test_macros.hpp>
+#include <atomic>
 #include <memory>
 #include <ostream>
 #include <string>
+#include <thread>
+#include <type_traits>
 #include <utility>
+#include <vector>
 
 using tacos::RegionIndex;
 
@@ -359,7 +364,9 @@ TEST_CASE("Search in an ABConfiguration tree", "[search]")
 	}
 }
 
-TEST_CASE("An illustrative example", "[search]")
+/** Create the TA of the illustrative example. */
+TA
+create_example_ta()
 {
 	TA ta{{"e", "a"}, Location{"l0"}, {Location{"l0"}, Location{"l1"}}};
 	ta.add_clock("c");
@@ -373,12 +380,23 @@ TEST_CASE("An illustrative example", "[search]")
 	                               Location{"l0"},
 	                               {{"c", AtomicClockConstraintT<std::greater<Time>>(0)}},
 	                               {"c"}));
-	logic::MTLFormula<std::string> a{AP("a")};
-	logic::MTLFormula<std::string> e{AP("e")};
+	return ta;
+}
 
-	logic::MTLFormula spec =
+/** Create the ATA of the specification of the illustrative example. */
+auto
+create_example_ata()
+{
+	logic::MTLFormula<std::string> e{AP("e")};
+	logic::MTLFormula              spec =
 	  e || finally(e, logic::TimeInterval{0, BoundType::WEAK, 1, BoundType::STRICT});
-	auto       ata = mtl_ata_translation::translate(spec, {AP{"a"}, AP{"e"}});
+	return mtl_ata_translation::translate(spec, {AP{"a"}, AP{"e"}});
+}
+
+TEST_CASE("An illustrative example", "[search]")
+{
+	const TA   ta  = create_example_ta();
+	auto       ata = create_example_ata();
 	TreeSearch search(&ta, &ata, {"a"}, {"e"}, 1, true);
 	search.build_tree(false);
 	search.label();
@@ -391,6 +409,85 @@ TEST_CASE("An illustrative example", "[search]")
 	  .render_to_file("example_controller.dot");
 }
 
+TEST_CASE("Search with alternative job pools", "[search]")
+{
+	// Nodes are expanded by plain jobs that the pool can store without allocating.
+	static_assert(std::is_trivially_copyable_v<TreeSearch::ExpansionJob>);
+	const TA   ta  = create_example_ta();
+	auto       ata = create_example_ata();
+	TreeSearch search(&ta, &ata, {"a"}, {"e"}, 1, true);
+	search.build_tree(false);
+	search.label();
+	// Expanding the nodes with a work-stealing pool or a MultiQueue results in the same search graph.
+	search::RegionTreeSearch<Location, std::string, std::string, false, TA, false, false, utilities::WorkStealingPool>
+	  parallel_search(&ta, &ata, {"a"}, {"e"}, 1, true);
+	parallel_search.build_tree(true);
+	parallel_search.label();
+	CHECK(parallel_search.get_root()->label == NodeLabel::TOP);
+	CHECK(parallel_search.get_size() == search.get_size());
+	search::RegionTreeSearch<Location, std::string, std::string, false, TA, false, false, utilities::MultiQueuePool>
+	  relaxed_search(&ta, &ata, {"a"}, {"e"}, 1, true);
+	relaxed_search.build_tree(true);
+	relaxed_search.label();
+	CHECK(relaxed_search.get_root()->label == NodeLabel::TOP);
+	CHECK(relaxed_search.get_size() == search.get_size());
+}
+
+TEST_CASE("Packed node keys", "[search]")
+{
+	const TA   ta  = create_example_ta();
+	auto       ata = create_example_ata();
+	TreeSearch search(&ta, &ata, {"a"}, {"e"}, 1, true);
+	search.build_tree(false);
+	search.label();
+	// The node table is keyed by packed words, which unpack to the words of the node.
+	for (const auto &[key, node] : search.get_nodes()) {
+		if (!key.empty()) {
+			CHECK(search.get_words(key) == node->words);
+		}
+	}
+	// An ordered node table is keyed by the words themselves, so its order doesn't depend on the interned IDs.
+	using OrderedSearch =
+	  search::RegionTreeSearch<Location, std::string, std::string, false, TA, false, true>;
+	static_assert(!OrderedSearch::use_packed_node_keys);
+	OrderedSearch ordered_search(&ta, &ata, {"a"}, {"e"}, 1, true);
+	ordered_search.build_tree(true);
+	ordered_search.label();
+	CHECK(ordered_search.get_root()->label == NodeLabel::TOP);
+	CHECK(ordered_search.get_size() == search.get_size());
+	for (const auto &[key, node] : ordered_search.get_nodes()) {
+		if (!key.empty()) {
+			CHECK(key == node->words);
+		}
+	}
+}
+
+TEST_CASE("Parallel successor computation", "[search]")
+{
+	const TA   ta  = create_example_ta();
+	auto       ata = create_example_ata();
+	TreeSearch search(&ta, &ata, {"a"}, {"e"}, 1, true);
+	search.build_tree(false);
+	search.label();
+	// Computing the successors of the words of each node in parallel results in the same search graph.
+	// The successors are only computed in parallel if there are at least two workers.
+	TreeSearch fanout_search(&ta, &ata, {"a"}, {"e"}, 1, true);
+	fanout_search.set_num_threads(4);
+	fanout_search.set_parallel_successor_threshold(1);
+	fanout_search.build_tree(true);
+	fanout_search.label();
+	CHECK(fanout_search.get_root()->label == NodeLabel::TOP);
+	CHECK(fanout_search.get_size() == search.get_size());
+	search::RegionTreeSearch<Location, std::string, std::string, false, TA, false, false, utilities::WorkStealingPool>
+	  stealing_fanout_search(&ta, &ata, {"a"}, {"e"}, 1, true);
+	stealing_fanout_search.set_num_threads(4);
+	stealing_fanout_search.set_parallel_successor_threshold(1);
+	stealing_fanout_search.build_tree(true);
+	stealing_fanout_search.label();
+	CHECK(stealing_fanout_search.get_root()->label == NodeLabel::TOP);
+	CHECK(stealing_fanout_search.get_size() == search.get_size());
+}
+
 TEST_CASE("Search in an ABConfiguration tree without solution", "[search]")
 {
 	spdlog::set_level(spdlog::level::trace);
@@ -817,4 +914,38 @@ TEST_CASE("Search graph with loops", "[search]")
 	CHECK(root->label == NodeLabel::TOP);
 }
 
+TEST_CASE("Insert nodes into a sharded node table concurrently", "[search]")
+{
+	search::ShardedNodeTable<int, std::shared_ptr<int>, true> table;
+	std::atomic<int>                                          created{0};
+	std::vector<std::thread>                                  threads;
+	for (int t = 0; t < 4; ++t) {
+		threads.emplace_back([&table, &created]() {
+			for (int key = 0; key < 1000; ++key) {
+				table.insert_if_absent(key, [&created, key]() {
+					++created;
+					return std::make_shared<int>(key);
+				});
+			}
+		});
+	}
+	for (auto &thread : threads) {
+		thread.join();
+	}
+	// Each node is only created once, even if several threads try to insert it.
+	CHECK(created == 1000);
+	CHECK(table.size() == 1000);
+	CHECK(*table.find(42) == 42);
+	CHECK(table.find(1000) == nullptr);
+	CHECK(std::distance(table.begin(), table.end()) == 1000);
+	const auto [node, inserted] = table.insert_if_absent(42, []() { return std::make_shared<int>(0); });
+	CHECK(!inserted);
+	CHECK(*node == 42);
+	table.replace_key(42, 42, [](const auto &) { return true; });
+	CHECK(*table.find(42) == 42);
+	table.reset(-1, std::make_shared<int>(-1));
+	CHECK(table.size() == 1);
+	CHECK(*table.begin()->second == -1);
+}
+
 } // namespace
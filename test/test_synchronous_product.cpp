@@ -14,6 +14,7 @@
 #include "mtl_ata_translation/translator.h"
 #include "search/canonical_word.h"
 #include "search/operators.h"
+#include "search/packed_word.h"
 #include "search/reg_a.h"
 #include "search/search_tree.h"
 #include "search/synchronous_product.h"
@@ -441,6 +442,51 @@ TEST_CASE("Compute the time successors of a set of nodes", "[canonical_word]")
 		        CanonicalABWord{{TARegionState{Location{"s0"}, "c0", 3}, ATARegionState{a, 3}}},
 		      });
 	}
+	SECTION("lazy sequence")
+	{
+		const auto                                      words = std::set{{w4, w5}};
+		search::TimeSuccessors<Location, std::string> time_successors{words, 1};
+		const auto                                      expected = get_time_successors(words, 1);
+		std::size_t                                     count    = 0;
+		for (auto it = time_successors.begin(); it != time_successors.end(); ++it) {
+			REQUIRE(count < expected.size());
+			CHECK(time_successors.get_increment() == count);
+			CHECK(*it == expected[count]);
+			++count;
+		}
+		CHECK(count == expected.size());
+		// The sequence stops right away if all words are maxed.
+		const auto maxed = std::set{{CanonicalABWord{{TARegionState{Location{"s0"}, "c0", 3}}}}};
+		CHECK(get_time_successors(maxed, 1) == std::vector{maxed});
+	}
+}
+
+TEST_CASE("Pack canonical words", "[canonical_word]")
+{
+	const logic::AtomicProposition<std::string> a{"a"};
+	const logic::AtomicProposition<std::string> b{"b"};
+	search::WordPacker<Location, std::string>   packer;
+
+	const CanonicalABWord w1{{TARegionState{Location{"s0"}, "c0", 1}}};
+	const CanonicalABWord w2{{ATARegionState{a, 0}}, {TARegionState{Location{"s0"}, "c0", 1}}};
+	const CanonicalABWord w3{{ATARegionState{b, 1}, TARegionState{Location{"s1"}, "c1", 3}},
+	                         {ATARegionState{a, 5}}};
+	const CanonicalABWord w4{
+	  {search::PlantZoneState<Location>{Location{"s0"}, "c0", zones::Zone_slice{1, 3, true, false, 5}}},
+	  {search::ATAZoneState<std::string>{a, zones::Zone_slice{0, 5, false, false, 5}}}};
+	for (const auto &word : {w1, w2, w3, w4}) {
+		CAPTURE(word);
+		const auto packed = packer.pack(word);
+		CHECK(packer.unpack(packed) == word);
+		CHECK(packed == packer.pack(word));
+		CHECK(packed.hash() == packer.pack(word).hash());
+	}
+	CHECK(packer.pack(w1) != packer.pack(w2));
+	CHECK(packer.pack(w2) != packer.pack(w3));
+	// Region states only take three units for plant states and two units for ATA states.
+	CHECK(packer.pack(w2).get_data().size() == 5);
+	const std::set<CanonicalABWord> words{w1, w2, w3};
+	CHECK(packer.unpack(packer.pack(words)) == words);
 }
 
 TEST_CASE("Get a concrete candidate for a canonical word", "[canonical_word]")
@@ -840,6 +886,25 @@ TEST_CASE("Monotonic domination on nodes", "[canonical_word]")
 		CHECK(!search::dominates_ancestor(n4.get()));
 		CHECK(!search::dominates_ancestor(n5.get()));
 	}
+	SECTION("Domination index")
+	{
+		search::DominationIndex<CanonicalABWord, automata::ta::Location<std::string>, std::string, std::string>
+		  index;
+		CHECK(!index.dominates_some_node(n3->words));
+		index.insert(n1.get());
+		index.insert(n2.get());
+		CHECK(index.dominates_some_node(n3->words));
+		CHECK(index.size() == 2);
+		// n3 dominates n1, so it is not added to the antichain of s0.
+		index.insert(n3.get());
+		CHECK(index.size() == 2);
+		n1->add_child({0, "a"}, n2);
+		n2->add_child({0, "a"}, n3);
+		CHECK(search::dominates_ancestor(n3.get(), index));
+		// n1 dominates itself, but that is not an ancestor.
+		CHECK(index.dominates_some_node(n1->words));
+		CHECK(!search::dominates_ancestor(n1.get(), index));
+	}
 }
 
 TEST_CASE("Validate the region indices in a canonical word", "[canonical_word]")
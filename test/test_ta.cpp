@@ -254,6 +254,27 @@ TEST_CASE("TA with clock reset", "[ta]")
 	}
 }
 
+TEST_CASE("Active clocks of a TA", "[ta]")
+{
+	TimedAutomaton ta{{Location{"s0"}, Location{"s1"}, Location{"s2"}},
+	                  {"a", "b"},
+	                  Location{"s0"},
+	                  {Location{"s2"}},
+	                  {"x", "y"},
+	                  {Transition{Location{"s0"}, "a", Location{"s1"}, {}, {"y"}},
+	                   Transition{Location{"s1"},
+	                              "b",
+	                              Location{"s2"},
+	                              {{"x", AtomicClockConstraintT<std::less<Time>>(2)},
+	                               {"y", AtomicClockConstraintT<std::greater<Time>>(1)}},
+	                              {"x"}}}};
+	const auto active = ta.get_active_clocks();
+	// y is reset before it is read, x is read after the next transition.
+	CHECK(active.at(Location{"s0"}) == std::set<std::string>{"x"});
+	CHECK(active.at(Location{"s1"}) == std::set<std::string>{"x", "y"});
+	CHECK(active.at(Location{"s2"}).empty());
+}
+
 TEST_CASE("Simple non-deterministic TA", "[ta]")
 {
 	TimedAutomaton ta{{"a", "b"}, Location{"s0"}, {Location{"s2"}}};
@@ -60,6 +60,27 @@ using namespace tacos;
 //using CanonicalABWord = search::CanonicalABWord<automata::ta::Location<std::string>, std::string>;
 //using ATAConfiguration = automata::ata::Configuration<logic::MTLFormula<std::string>>;
 
+/** Check that operator< is a strict weak ordering on these DBMs, in which two DBMs are equivalent iff they are equal */
+void
+check_strict_weak_ordering(const std::vector<zones::Zone_DBM> &dbms)
+{
+	for(std::size_t i = 0; i < dbms.size(); i++) {
+		for(std::size_t j = 0; j < dbms.size(); j++) {
+			const auto &a = dbms[i];
+			const auto &b = dbms[j];
+			INFO("DBM " << i << ": " << a);
+			INFO("DBM " << j << ": " << b);
+			CHECK((!(a < b) && !(b < a)) == (a == b));
+			CHECK(!(a < b && b < a));
+			for(const auto &c : dbms) {
+				if(a < b && b < c) {
+					CHECK(a < c);
+				}
+			}
+		}
+	}
+}
+
 TEST_CASE("Getting fulfilled Clock Constraints of a ta", "[zones]")
 {
 	using TimedAutomaton = automata::ta::TimedAutomaton<std::string, std::string>;
@@ -257,6 +278,30 @@ TEST_CASE("Canonical Word using zones", "[zones]")
 	CHECK(initial_word.ta_location == ta_location);
 	CHECK(initial_word.ta_clocks == ta_clocks);
 	CHECK(initial_word.ata_locations == ata_locations);
+
+	//Equal words have equal hashes, no matter whether their DBMs share a matrix
+	CanonicalABZoneWord same_word{ta.get_initial_configuration(), ata.get_initial_configuration(), 2};
+	CHECK(!same_word.dbm.shares_matrix_with(initial_word.dbm));
+	CHECK(std::hash<CanonicalABZoneWord>{}(same_word) == std::hash<CanonicalABZoneWord>{}(initial_word));
+	CHECK(utilities::hash_value(search::CanonicalABWord<Location, std::string>(same_word))
+	      == utilities::hash_value(search::CanonicalABWord<Location, std::string>(initial_word)));
+	same_word.dbm.delay();
+	CHECK(same_word.hash() != initial_word.hash());
+
+	//Conversions are cached until the word changes
+	const auto &ab_word = initial_word.get_ab_word();
+	CHECK(&initial_word.get_ab_word() == &ab_word);
+	CHECK(&search::reg_a(initial_word) == &search::reg_a(initial_word));
+	CHECK(search::reg_a(initial_word).ata_locations.empty());
+	CHECK(search::reg_a(initial_word).dbm == initial_word.dbm.get_subset(ta_clocks));
+	CHECK(same_word.get_ab_word() != ab_word);
+	CanonicalABZoneWord delayed_word = initial_word;
+	delayed_word.dbm.delay();
+	CHECK(delayed_word.get_ab_word() == same_word.get_ab_word());
+	CHECK(initial_word.get_ab_word() == ab_word);
+	CHECK(delayed_word.add_ata_location(b));
+	CHECK(delayed_word.get_ab_word() != same_word.get_ab_word());
+	CHECK(search::CanonicalABWord<Location, std::string>(delayed_word) == delayed_word.get_ab_word());
 }
 
 TEST_CASE("monotone_domination_order for zones", "[zones]")
@@ -300,6 +345,20 @@ TEST_CASE("monotone_domination_order for zones", "[zones]")
 	CHECK(search::is_monotonically_dominated(
 	  CanonicalABZoneWord({"s0"}, {"c0"}, {}, zone0),
 	  CanonicalABZoneWord({"s0"}, {"c0", "c1"}, {ATALocation{AP{"a0"}}}, zone4)));
+
+	//Zones are compared by inclusion on the clocks of the dominated word
+	zones::Zone_DBM zone5 = zones::Zone_DBM{ {{"c0", c_gt2}}, 3};
+	CHECK(search::is_monotonically_dominated(
+	  CanonicalABZoneWord({"s0"}, {"c0"}, {}, zone1),
+	  CanonicalABZoneWord({"s0"}, {"c0"}, {}, zone5)));
+	CHECK(!search::is_monotonically_dominated(
+	  CanonicalABZoneWord({"s0"}, {"c0"}, {}, zone5),
+	  CanonicalABZoneWord({"s0"}, {"c0"}, {}, zone1)));
+	CHECK(!search::is_monotonically_dominated(
+	  CanonicalABZoneWord({"s0"}, {"c0"}, {}, zone0),
+	  CanonicalABZoneWord({"s1"}, {"c0"}, {}, zone0)));
+	CHECK(zone4.is_projection_included_in(zone2));
+	CHECK(!zone2.is_projection_included_in(zone4));
 }
 
 TEST_CASE("Difference Bound Matrix tests", "[zones]")
@@ -311,7 +370,27 @@ TEST_CASE("Difference Bound Matrix tests", "[zones]")
 		CHECK(!	(DBM_Entry{0, true} < DBM_Entry{-1*((int) 0), false}));
 	}
 
+	SECTION("Packed bounds") {
+		using zones::DBM_Bound;
+
+		for(const DBM_Entry &entry : {DBM_Entry{0, true}, DBM_Entry{0, false}, DBM_Entry{-3, true}, DBM_Entry{-3, false},
+		                              DBM_Entry{7, true}, DBM_Entry{7, false}, DBM_Entry{true, 0, false}}) {
+			CHECK(DBM_Entry::from_bound(entry.to_bound()) == entry);
+		}
+
+		//Packed bounds are ordered like DBM_Entries
+		CHECK(zones::make_bound(-3, true) < zones::make_bound(-2, false));
+		CHECK(zones::make_bound(2, false) < zones::make_bound(2, true));
+		CHECK(zones::make_bound(ZONE_INFTY, true) < zones::DBM_BOUND_INFINITY);
+
+		CHECK(DBM_Entry::from_bound(zones::add_bounds(zones::make_bound(3, true), zones::make_bound(-5, true))) == DBM_Entry{-2, true});
+		CHECK(DBM_Entry::from_bound(zones::add_bounds(zones::make_bound(3, false), zones::make_bound(-5, true))) == DBM_Entry{-2, false});
+		CHECK(DBM_Entry::from_bound(zones::add_bounds(zones::make_bound(-3, false), zones::make_bound(-5, false))) == DBM_Entry{-8, false});
+		CHECK(zones::add_bounds(zones::make_bound(3, true), zones::DBM_BOUND_INFINITY) == zones::DBM_BOUND_INFINITY);
+	}
+
 	[[maybe_unused]] automata::ClockConstraint c_eq0 = automata::AtomicClockConstraintT<std::equal_to<Time>>(0);
+	[[maybe_unused]] automata::ClockConstraint c_ge0 = automata::AtomicClockConstraintT<std::greater_equal<Time>>(0);
 	[[maybe_unused]] automata::ClockConstraint c_lt1 = automata::AtomicClockConstraintT<std::less<Time>>(1);
 	[[maybe_unused]] automata::ClockConstraint c_eq3 = automata::AtomicClockConstraintT<std::equal_to<Time>>(3);
 	[[maybe_unused]] automata::ClockConstraint c_ge3 = automata::AtomicClockConstraintT<std::greater_equal<Time>>(3);
@@ -347,6 +426,325 @@ TEST_CASE("Difference Bound Matrix tests", "[zones]")
 	dbm.conjunct("y", c_eq3);
 	dbm.conjunct("z", c_eq3);
 
+	SECTION("Clock IDs") {
+		const zones::ClockID x = dbm.get_clock_id("x");
+		const zones::ClockID z = dbm.get_clock_id("z");
+
+		CHECK(x != z);
+		CHECK(dbm.get_registry()->get_name(x) == "x");
+		CHECK(dbm.get_registry()->find_id("x") == x);
+		CHECK(dbm.has_clock(x));
+		CHECK(!dbm.has_clock(dbm.get_clock_id("clock_that_is_not_in_the_dbm")));
+		CHECK(dbm.get_clock_ids() == std::vector<zones::ClockID>{x, dbm.get_clock_id("y"), z});
+		CHECK(dbm.get_zone_slice(x) == dbm.get_zone_slice("x"));
+
+		Zone_DBM by_name = dbm;
+		Zone_DBM by_id = dbm;
+		by_name.reset("z");
+		by_id.reset(z);
+		CHECK(by_name == by_id);
+
+		by_name.conjunct("x", c_lt5);
+		by_id.conjunct(x, c_lt5);
+		CHECK(by_name == by_id);
+
+		CHECK(dbm.get_subset({"x", "z"}) == dbm.get_subset_of_ids({x, z}));
+
+		search::ClockRegistry<std::string> registry{dbm.get_registry()};
+		logic::MTLFormula<std::string> location{logic::AtomicProposition<std::string>{"a"}};
+		CHECK(registry.get_clock_id("x") == x);
+		CHECK(registry.get_clock_id(location) == dbm.get_clock_id(search::ata_formula_to_string(location)));
+		CHECK(registry.get_clock_id(location) == registry.get_clock_id(location));
+	}
+
+	SECTION("Clocks of different registries") {
+		//The registries give the same IDs to different clocks and different IDs to the same clocks
+		auto reversed = std::make_shared<zones::ClockRegistry>();
+		auto renamed = std::make_shared<zones::ClockRegistry>();
+		for(const std::string clock : {"z", "y", "x"}) {
+			reversed->get_id(clock);
+		}
+		for(const std::string clock : {"w", "v", "u"}) {
+			renamed->get_id(clock);
+		}
+
+		Zone_DBM same{clock_constraints, 9, reversed};
+		CHECK(same.get_clock_id("x") == zones::ClockID{2});
+		CHECK(same == dbm);
+		CHECK(dbm == same);
+		CHECK(same.hash() == dbm.hash());
+		CHECK(!(same < dbm));
+		CHECK(!(dbm < same));
+
+		Zone_DBM other_clocks{{{"u", c_ge3}, {"u", c_le9}, {"v", c_eq3}, {"w", c_eq3}}, 9, renamed};
+		CHECK(other_clocks.get_clock_ids() == same.get_clock_ids());
+		CHECK(other_clocks != same);
+		CHECK(other_clocks != dbm);
+		check_strict_weak_ordering({dbm, same, other_clocks});
+	}
+
+	SECTION("Batched conjunction") {
+		Zone_DBM batched{clocks, 9};
+		batched.conjunct(clock_constraints);
+		CHECK(batched == dbm);
+		CHECK(Zone_DBM{clock_constraints, 9} == dbm);
+
+		//Difference constraints are derived from the batch as well
+		Zone_DBM delayed = dbm;
+		delayed.reset("x");
+		delayed.delay();
+		std::multimap<std::string, automata::ClockConstraint> guard{{"x", c_ge5}, {"z", c_le9}};
+		Zone_DBM one_by_one = delayed;
+		one_by_one.conjunct("x", c_ge5);
+		one_by_one.conjunct("z", c_le9);
+		delayed.conjunct(guard);
+		INFO(delayed);
+		CHECK(delayed == one_by_one);
+		CHECK(delayed.at("z", "x") == DBM_Entry{3, true});
+
+		//Contradicting constraints within one batch
+		Zone_DBM inconsistent{clocks, 9};
+		inconsistent.conjunct({{"x", c_lt1}, {"y", c_eq3}, {"x", c_gt5}});
+		CHECK(!inconsistent.is_consistent());
+	}
+
+	SECTION("LU extrapolation") {
+		Zone_DBM exact{clocks, 20, true};
+		exact.delay();
+		exact.conjunct("y", c_eq3);
+
+		//x is only compared against 1, y only in lower bounds up to 15, z never
+		auto bounds = std::make_shared<zones::ClockBounds>();
+		bounds->add_constraint(exact.get_clock_id("x"), c_lt1);
+		bounds->add_constraint(exact.get_clock_id("y"), c_ge15);
+
+		Zone_DBM extrapolated = exact;
+		extrapolated.set_clock_bounds(bounds);
+		extrapolated.normalize();
+
+		INFO(extrapolated);
+		CHECK(extrapolated.is_consistent());
+		CHECK(extrapolated.at("x", 0).infinity_);
+		CHECK(extrapolated.at(0, "x") == DBM_Entry{-1, false});
+		CHECK(extrapolated.at("y", 0) == DBM_Entry{3, true});
+		CHECK(extrapolated.at(0, "y") == DBM_Entry{0, false});
+		CHECK(extrapolated.at("z", 0).infinity_);
+		CHECK(extrapolated.at(0, "z") == DBM_Entry{0, false});
+
+		//Extrapolating an extrapolated DBM again doesn't change it, so the matrix isn't copied
+		Zone_DBM copy = extrapolated;
+		copy.set_clock_bounds(bounds);
+		copy.normalize();
+		CHECK(copy.shares_matrix_with(extrapolated));
+
+		//The max-constant normalization keeps all clocks exact
+		exact.normalize();
+		CHECK(exact.at(0, "x") == DBM_Entry{-3, true});
+		CHECK(exact.at("x", 0) == DBM_Entry{3, true});
+	}
+
+	SECTION("Inclusion") {
+		Zone_DBM larger{clocks, 9, true};
+		larger.delay();
+		Zone_DBM smaller = larger;
+		smaller.conjunct("x", c_ge3);
+
+		CHECK(smaller.is_included_in(larger));
+		CHECK(!larger.is_included_in(smaller));
+		CHECK(larger.is_included_in(larger));
+
+		//Same clocks, but stored at different indices
+		Zone_DBM reordered{std::set<std::string>{}, 9};
+		for(const std::string clock : {"z", "y", "x"}) {
+			reordered.add_clock(clock);
+			reordered.reset(clock);
+		}
+		reordered.delay();
+		CHECK(smaller.is_included_in(reordered));
+		CHECK(!reordered.is_included_in(smaller));
+		CHECK(reordered.is_included_in(larger));
+
+		//Different clocks are never included
+		CHECK(!smaller.is_included_in(Zone_DBM{std::set<std::string>{"x", "y", "w"}, 9}));
+
+		Zone_DBM empty = smaller;
+		empty.conjunct("x", c_lt1);
+		CHECK(empty.is_included_in(smaller));
+		CHECK(!smaller.is_included_in(empty));
+	}
+
+	SECTION("Copy on write") {
+		Zone_DBM original{clocks, 9, true};
+		original.delay();
+		Zone_DBM copy = original;
+		CHECK(copy.shares_matrix_with(original));
+
+		//Reading and constraints that are already implied don't copy the matrix
+		CHECK(copy.get_zone_slice("x") == original.get_zone_slice("x"));
+		copy.delay();
+		copy.conjunct("x", c_ge0);
+		copy.conjunct(std::multimap<std::string, automata::ClockConstraint>{{"y", c_ge0}});
+		CHECK(copy.shares_matrix_with(original));
+
+		copy.conjunct("x", c_ge3);
+		CHECK(!copy.shares_matrix_with(original));
+		CHECK(copy.at(0, "x") == DBM_Entry{-3, true});
+		CHECK(original.at(0, "x") == DBM_Entry{0, true});
+
+		//A DBM that isn't shared anymore is changed in place
+		Zone_DBM assigned = copy;
+		assigned          = original;
+		CHECK(!copy.shares_matrix_with(assigned));
+		copy.reset("x");
+		CHECK(copy.at(0, "x") == DBM_Entry{0, true});
+		CHECK(assigned == original);
+	}
+
+	SECTION("Freeing clocks") {
+		Zone_DBM dbm{clocks, 9, true};
+		dbm.delay();
+		dbm.conjunct("x", c_ge3);
+		dbm.free_clock("x");
+		CHECK(dbm.at(0, "x") == DBM_Entry{0, true});
+		CHECK(dbm.at("x", 0).infinity_);
+		CHECK(dbm.at("x", "y").infinity_);
+		CHECK(dbm.at("y", "x") == dbm.at("y", 0));
+		CHECK(dbm.is_consistent());
+
+		//Freeing a free clock doesn't copy a shared matrix
+		Zone_DBM copy = dbm;
+		copy.free_clock("x");
+		CHECK(copy.shares_matrix_with(dbm));
+	}
+
+	SECTION("DBM pool") {
+		zones::DBM_Pool pool;
+		Zone_DBM first{clocks, 9, true};
+		Zone_DBM second{clocks, 9, true};
+		CHECK(first.hash() == second.hash());
+
+		pool.intern(first);
+		pool.intern(second);
+		CHECK(first.is_interned());
+		CHECK(second.is_interned());
+		CHECK(pool.size() == 1);
+		CHECK(first == second);
+
+		//Changing a copy of an interned DBM leaves the shared matrix alone
+		Zone_DBM delayed = second;
+		delayed.delay();
+		CHECK(!delayed.is_interned());
+		CHECK(delayed != first);
+		CHECK(first == second);
+		CHECK(second.at("x", 0) == DBM_Entry{0, true});
+
+		pool.intern(delayed);
+		CHECK(pool.size() == 2);
+		CHECK(delayed != first);
+
+		//Equal bounds over different clocks are different matrices, and they are ordered by their clocks
+		const zones::Graph graph_x{{first.get_clock_id("x")}};
+		const zones::Graph graph_y{{first.get_clock_id("y")}};
+		CHECK(!(graph_x == graph_y));
+		CHECK(graph_x.has_same_bounds(graph_y));
+		CHECK((graph_x < graph_y) != (graph_y < graph_x));
+		Zone_DBM only_x{std::set<std::string>{"x"}, 9, true};
+		Zone_DBM only_y{std::set<std::string>{"y"}, 9, true};
+		pool.intern(only_x);
+		pool.intern(only_y);
+		CHECK(pool.size() == 4);
+		CHECK(!only_x.shares_matrix_with(only_y));
+		CHECK(only_x != only_y);
+
+		Zone_DBM compressed_y = only_y;
+		compressed_y.compress();
+		check_strict_weak_ordering({first, second, delayed, only_x, only_y, compressed_y, Zone_DBM{clocks, 9}});
+
+		//DBMs sharing an interned matrix also share its compressed form
+		Zone_DBM compressed_first   = first;
+		Zone_DBM compressed_second  = second;
+		Zone_DBM compressed_delayed = delayed;
+		pool.compress(compressed_first);
+		pool.compress(compressed_second);
+		pool.compress(compressed_delayed);
+		CHECK(compressed_first.is_compressed());
+		CHECK(compressed_first.shares_matrix_with(compressed_second));
+		CHECK(!compressed_first.shares_matrix_with(compressed_delayed));
+		CHECK(pool.compressed_size() == 2);
+		CHECK(compressed_first == first);
+		CHECK(compressed_first == compressed_second);
+		CHECK(compressed_first != compressed_delayed);
+		CHECK(compressed_delayed == delayed);
+		CHECK(compressed_first.hash() == first.hash());
+		check_strict_weak_ordering({first, delayed, compressed_first, compressed_second, compressed_delayed});
+
+		//Compressing again keeps the shared minimal constraints
+		pool.compress(compressed_first);
+		CHECK(compressed_first.shares_matrix_with(compressed_second));
+		compressed_first  = first;
+		compressed_second = first;
+		CHECK(pool.compressed_size() == 1);
+	}
+
+	SECTION("Minimal constraints") {
+		Zone_DBM reset{clocks, 9, true};
+		Zone_DBM delayed = reset;
+		delayed.delay();
+		Zone_DBM constrained = delayed;
+		constrained.conjunct("x", c_ge3);
+		constrained.reset("y");
+		constrained.delay();
+		//A zero cycle between two clocks other than the zero clock
+		Zone_DBM copied = constrained;
+		copied.copy_clock("w", "z");
+		Zone_DBM unbounded{clocks, 9};
+		Zone_DBM from_constraints{clock_constraints, 9};
+
+		for(const auto &dbm : {reset, delayed, constrained, copied, unbounded, from_constraints}) {
+			INFO(dbm);
+			const zones::Reduced_DBM minimal = dbm.get_minimal_constraints();
+			CHECK(minimal.get_constraints().size() <= (dbm.size() + 1) * dbm.size());
+			CHECK(Zone_DBM{minimal, dbm.max_constant_, dbm.get_registry()} == dbm);
+
+			Zone_DBM compressed = dbm;
+			compressed.compress();
+			CHECK(compressed.is_compressed());
+			CHECK(compressed == dbm);
+			CHECK(dbm == compressed);
+			CHECK(!(compressed < dbm));
+			CHECK(!(dbm < compressed));
+			CHECK(compressed.hash() == dbm.hash());
+			CHECK(compressed.size() == dbm.size());
+			CHECK(compressed.get_clocks() == dbm.get_clocks());
+			for(std::size_t i = 0; i <= dbm.size(); i++) {
+				for(std::size_t j = 0; j <= dbm.size(); j++) {
+					CHECK(compressed.at(i, j) == dbm.at(i, j));
+				}
+			}
+			CHECK(compressed.is_included_in(dbm));
+
+			//Copies share the compressed form, changing one decompresses it
+			Zone_DBM copy = compressed;
+			copy.delay();
+			CHECK(!copy.is_compressed());
+			CHECK(compressed.is_compressed());
+			compressed.decompress();
+			CHECK(!compressed.is_compressed());
+			CHECK(compressed == dbm);
+		}
+
+		//The clocks of a reset zone are all equal, so a single cycle is enough
+		CHECK(reset.get_minimal_constraints().get_constraints().size() == reset.size() + 1);
+		//Nothing is bounded at all
+		CHECK(unbounded.get_minimal_constraints().get_constraints().empty());
+
+		Zone_DBM empty = constrained;
+		empty.conjunct("x", c_lt1);
+		empty.compress();
+		CHECK(!empty.is_compressed());
+		CHECK(!empty.get_minimal_constraints().is_consistent());
+	}
+
 	SECTION("Correct initialization") {
 
 		INFO(dbm);
@@ -456,6 +854,29 @@ TEST_CASE("Difference Bound Matrix tests", "[zones]")
 
 	}
 
+	SECTION("Inconsistency after normalization") {
+		[[maybe_unused]] automata::ClockConstraint c_eq5 = automata::AtomicClockConstraintT<std::equal_to<Time>>(5);
+		[[maybe_unused]] automata::ClockConstraint c_ge8 = automata::AtomicClockConstraintT<std::greater_equal<Time>>(8);
+		[[maybe_unused]] automata::ClockConstraint c_lt12 = automata::AtomicClockConstraintT<std::less<Time>>(12);
+
+		Zone_DBM new_dbm{std::set<std::string>{"x", "z"}, 10, true};
+
+		new_dbm.delay();
+		new_dbm.conjunct("x", c_eq5);
+		new_dbm.reset("z");
+		new_dbm.delay();
+		//Implies x >= 13, which exceeds the max constant
+		new_dbm.conjunct("z", c_ge8);
+
+		CHECK(new_dbm.is_consistent());
+
+		new_dbm.conjunct("x", c_lt12);
+
+		INFO(new_dbm);
+
+		CHECK(!new_dbm.is_consistent());
+	}
+
 	SECTION("Checking resulting Zone_slices") {
 		CHECK(dbm.get_zone_slice("x") == zones::Zone_slice{5, 9, true, false, 9});
 		CHECK(dbm.get_zone_slice("y") == zones::Zone_slice{5, 9, true, false, 9});
@@ -712,8 +1133,35 @@ TEST_CASE("Difference Bound Matrix tests", "[zones]")
 
 		CHECK(new_dbm.at(0, "x") == DBM_Entry{-4, false});
 		CHECK(new_dbm.at("y", 0).infinity_);
-		CHECK(new_dbm.at(0, "z") == DBM_Entry{-4, false});
+		//The normalized DBM is closed again, z = x + 3 and x > 4 imply z > 7
+		CHECK(new_dbm.at(0, "z") == DBM_Entry{-7, false});
 		CHECK(new_dbm.at("z", 0).infinity_);
+		CHECK(new_dbm.get_zone_slice("z") == zones::Zone_slice{4, 4, true, false, 4});
+
+		//Normalizing again doesn't clamp the derived bound of z again, so the matrix isn't copied
+		Zone_DBM copy = new_dbm;
+		copy.normalize();
+		CHECK(copy.shares_matrix_with(new_dbm));
+		CHECK(copy.at(0, "z") == DBM_Entry{-7, false});
+
+		//Constraints within the max constant keep the DBM normalized
+		Zone_DBM derived{clocks, 5, true};
+		derived.delay();
+		derived.conjunct("x", c_ge3);
+		derived.reset("x");
+		derived.delay();
+		derived.conjunct("x", c_ge3);
+		derived.normalize();
+		CHECK(derived.at(0, "y") == DBM_Entry{-6, true});
+
+		derived.conjunct("x", c_le5);
+		Zone_DBM renormalized = derived;
+		//Forces a full normalization
+		renormalized.set_clock_bounds(nullptr);
+		renormalized.normalize();
+		CHECK(renormalized == derived);
+		CHECK(derived.at("x", 0) == DBM_Entry{5, true});
+		CHECK(derived.at(0, "y") == DBM_Entry{-6, true});
 	}
 
 	SECTION("More edge cases") {
@@ -797,9 +1245,10 @@ TEST_CASE("Difference Bound Matrix tests", "[zones]")
 
 		CHECK(mini_dbm < tiny_dbm);
 		CHECK(tiny_dbm < small_dbm);
-		CHECK(small_dbm < perfectly_adequate_dbm);
 		CHECK(perfectly_adequate_dbm < new_dbm);
-		CHECK(new_dbm < new_big_dbm);
+		//DBMs of the same size and max constant are ordered by their hashes
+		check_strict_weak_ordering(
+		  {mini_dbm, tiny_dbm, small_dbm, should_be_dbm, perfectly_adequate_dbm, new_dbm, new_big_dbm});
 		
 		CHECK(mini_dbm < new_dbm);
 
@@ -811,6 +1260,119 @@ TEST_CASE("Difference Bound Matrix tests", "[zones]")
 	}
 }
 
+TEST_CASE("Federations of zones", "[zones]")
+{
+	using zones::Federation;
+	using zones::Zone_DBM;
+	using Constraints = std::multimap<std::string, automata::ClockConstraint>;
+
+	auto box = [](Time x_min, Time x_max, Time y_min, Time y_max) {
+		return Zone_DBM{Constraints{{"x", automata::AtomicClockConstraintT<std::greater_equal<Time>>(x_min)},
+		                            {"x", automata::AtomicClockConstraintT<std::less_equal<Time>>(x_max)},
+		                            {"y", automata::AtomicClockConstraintT<std::greater_equal<Time>>(y_min)},
+		                            {"y", automata::AtomicClockConstraintT<std::less_equal<Time>>(y_max)}},
+		                9};
+	};
+	auto equal = [](const Federation &f1, const Federation &f2) {
+		return f1.is_included_in(f2) && f2.is_included_in(f1);
+	};
+
+	const Zone_DBM left   = box(0, 2, 0, 2);
+	const Zone_DBM right  = box(1, 3, 0, 2);
+	const Zone_DBM inner  = box(0, 1, 0, 1);
+	const Zone_DBM corner = box(2, 4, 2, 4);
+	const Zone_DBM empty  = box(3, 2, 0, 2);
+	CHECK(!empty.is_consistent());
+
+	SECTION("Construction") {
+		CHECK(Federation{}.is_empty());
+		CHECK(Federation{empty}.is_empty());
+		CHECK(Federation{left}.size() == 1);
+		CHECK(Federation{left}.unite(Federation{right}).size() == 2);
+	}
+
+	SECTION("Intersection") {
+		const Federation intersection = Federation{left}.intersect(Federation{right});
+		CHECK(intersection.size() == 1);
+		CHECK(equal(intersection, Federation{box(1, 2, 0, 2)}));
+		CHECK(Federation{inner}.intersect(Federation{box(2, 3, 2, 3)}).is_empty());
+	}
+
+	SECTION("Subtraction") {
+		const Federation difference = Federation{left}.subtract(Federation{inner});
+		CHECK(!difference.is_empty());
+		CHECK(difference.intersect(Federation{inner}).is_empty());
+		CHECK(equal(difference.unite(Federation{inner}), Federation{left}));
+		//The pieces are disjoint
+		for(std::size_t i = 0; i < difference.size(); i++) {
+			for(std::size_t j = i + 1; j < difference.size(); j++) {
+				CHECK(!Federation::intersect(difference.get_zones()[i], difference.get_zones()[j]).is_consistent());
+			}
+		}
+
+		//The border of the subtracted zone isn't part of the difference
+		const Federation right_part = Federation{left}.subtract(Federation{box(0, 1, 0, 2)});
+		CHECK(right_part.intersect(Federation{box(1, 1, 0, 2)}).is_empty());
+		CHECK(!right_part.intersect(Federation{box(2, 2, 0, 2)}).is_empty());
+
+		CHECK(Federation{inner}.subtract(Federation{left}).is_empty());
+		CHECK(equal(Federation{inner}.subtract(Federation{corner}), Federation{inner}));
+	}
+
+	SECTION("Inclusion") {
+		Federation halves{box(0, 1, 0, 2)};
+		halves.add(box(1, 2, 0, 2));
+		CHECK(Federation{left}.is_included_in(halves));
+		CHECK(halves.is_included_in(Federation{left}));
+		CHECK(!Federation{left}.is_included_in(Federation{box(0, 1, 0, 2)}));
+		CHECK(Federation{}.is_included_in(Federation{inner}));
+		CHECK(!Federation{inner}.is_included_in(Federation{}));
+	}
+
+	SECTION("Reduction") {
+		Federation federation{left};
+		federation.add(inner);
+		federation.add(left);
+		federation.reduce();
+		CHECK(federation.size() == 1);
+		CHECK(federation.get_zones()[0] == left);
+
+		//The union of overlapping boxes of the same height is convex
+		federation.add(right);
+		federation.reduce();
+		CHECK(federation.size() == 1);
+		CHECK(equal(federation, Federation{box(0, 3, 0, 2)}));
+
+		//Boxes that only touch in a corner are not
+		federation.add(corner);
+		federation.reduce();
+		CHECK(federation.size() == 2);
+	}
+
+	SECTION("Merging zone words") {
+		using Location = automata::ta::Location<std::string>;
+		using Word     = search::CanonicalABZoneWord<Location, std::string>;
+		const std::set<logic::MTLFormula<std::string>> no_ata_locations;
+
+		const std::set<Word> words{Word{Location{"l0"}, {"x", "y"}, no_ata_locations, left},
+		                           Word{Location{"l0"}, {"x", "y"}, no_ata_locations, right},
+		                           Word{Location{"l0"}, {"x", "y"}, no_ata_locations, inner},
+		                           Word{Location{"l1"}, {"x", "y"}, no_ata_locations, inner}};
+		zones::DBM_Pool pool;
+		const auto merged = search::merge_zone_words(words, &pool);
+		CHECK(merged.size() == 2);
+		for(const auto &word : merged) {
+			CHECK(word.is_valid());
+			if(word.ta_location == Location{"l0"}) {
+				CHECK(word.dbm.is_interned());
+				CHECK(equal(Federation{word.dbm}, Federation{box(0, 3, 0, 2)}));
+			} else {
+				CHECK(word.dbm == inner);
+			}
+		}
+	}
+}
+
 TEST_CASE("Manually Debugging Railway example", "[zones]") {
 	using CanonicalABZoneWord = search::CanonicalABZoneWord<std::string, std::string>;
 	using zones::Zone_DBM;
@@ -961,12 +1523,21 @@ TEST_CASE("Simple example using zones 1", "[zones]")
 					  true,
 					  true};
 
+	//Each search interns its clocks in its own registry, starting with the TA clocks
+	CHECK(search.get_clock_names() != zones::ClockRegistry::get_default());
+	CHECK(search.get_clock_names()->find_id("x") == zones::ClockID{0});
+
 	CanonicalABZoneWord initial_word = CanonicalABZoneWord(ta.get_initial_configuration(),
 			                        ata.get_initial_configuration(),
-			                        2);
+			                        2,
+			                        search.get_clock_names());
 
 	CHECK(!initial_word.ta_clocks.empty());
 
+	//No guard reads y and no ATA transition has a clock constraint, so the root only keeps x
+	CHECK(*search.get_root()->words.begin() != initial_word);
+	initial_word.dbm.free_clock("y");
+	initial_word.dbm.free_clock("l0");
 	CHECK(*search.get_root()->words.begin() == initial_word);
 
 	std::map<std::pair<tacos::RegionIndex, std::string>, std::set<CanonicalABZoneWord>> successors = 
@@ -990,6 +1561,80 @@ TEST_CASE("Simple example using zones 1", "[zones]")
 	auto controller = controller_synthesis::create_controller(
 						search.get_root(), controller_actions, environment_actions, 2
 						);
+
+	//Linking subsumed children to existing nodes must not change the result, but may only shrink the search graph
+	TreeSearch subsuming_search{&ta,
+					  &ata,
+					  controller_actions,
+					  environment_actions,
+					  2,
+					  true,
+					  true,
+					  std::make_unique<search::BfsHeuristic<long, TreeSearch::Node>>(),
+					  true};
+	subsuming_search.build_tree(true);
+	CHECK(subsuming_search.get_root()->label == search::NodeLabel::TOP);
+	CHECK(subsuming_search.get_size() <= search.get_size());
+
+	//Compressing the DBMs of expanded nodes must not change the search graph
+	TreeSearch compressing_search{&ta,
+					  &ata,
+					  controller_actions,
+					  environment_actions,
+					  2,
+					  true,
+					  true,
+					  std::make_unique<search::BfsHeuristic<long, TreeSearch::Node>>(),
+					  false,
+					  true};
+	compressing_search.build_tree(true);
+	CHECK(compressing_search.get_root()->label == search::NodeLabel::TOP);
+	CHECK(compressing_search.get_size() == search.get_size());
+	CHECK(std::all_of(compressing_search.get_root()->words.begin(),
+	                  compressing_search.get_root()->words.end(),
+	                  [](const auto &word) { return word.dbm.is_compressed(); }));
+	auto compressed_controller = controller_synthesis::create_controller(
+						compressing_search.get_root(), controller_actions, environment_actions, 2
+						);
+	CHECK(compressed_controller.get_locations().size() == controller.get_locations().size());
+
+	//Merging the zone words of each child must not change the result
+	TreeSearch merging_search{&ta,
+					  &ata,
+					  controller_actions,
+					  environment_actions,
+					  2,
+					  true,
+					  true,
+					  std::make_unique<search::BfsHeuristic<long, TreeSearch::Node>>(),
+					  false,
+					  false,
+					  true};
+	merging_search.build_tree(true);
+	CHECK(merging_search.get_root()->label == search::NodeLabel::TOP);
+	CHECK(merging_search.get_size() <= search.get_size());
+
+	//The ordered node table only changes the order in which the nodes are visited
+	search::ZoneTreeSearch<Location, std::string, std::string, false, TimedAutomaton, false, true> ordered_search{
+					  &ta,
+					  &ata,
+					  controller_actions,
+					  environment_actions,
+					  2,
+					  true,
+					  true};
+	ordered_search.build_tree(true);
+	CHECK(!decltype(ordered_search)::use_node_hash_table);
+	CHECK(TreeSearch::use_node_hash_table);
+	CHECK(ordered_search.get_root()->label == search::NodeLabel::TOP);
+	CHECK(ordered_search.get_size() == search.get_size());
+
+	//Computing the successors of the words of each node in parallel must not change the search graph
+	TreeSearch fanout_search{&ta, &ata, controller_actions, environment_actions, 2, true, true};
+	fanout_search.set_parallel_successor_threshold(1);
+	fanout_search.build_tree(true);
+	CHECK(fanout_search.get_root()->label == search::NodeLabel::TOP);
+	CHECK(fanout_search.get_size() == search.get_size());
 	//CHECK(search::verify_ta_controller(ta, controller, phi1, 2));
 	
 	#if USE_INTERACTIVE_VISUALIZATION
@@ -1098,7 +1743,7 @@ TEST_CASE("Simple example using zones 2", "[zones]")
 
 		auto sink_state = ata.get_sink_location().value();
 
-		Zone_DBM ta_dbm{std::set<std::string>{"t", "c"}, 2};
+		Zone_DBM ta_dbm{std::set<std::string>{"t", "c"}, 2, false, search.get_clock_names()};
 
 		ta_dbm.conjunct("c", c_eq1);
 		ta_dbm.conjunct("t", c_eq0);